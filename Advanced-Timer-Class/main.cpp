@@ -3,6 +3,7 @@
 #include "SDL2/SDL_ttf.h"
 
 #include "LTexture.h"
+#include "LGlyphAtlas.h"
 #include "LTimer.h"
 
 #include <stdio.h>
@@ -32,7 +33,8 @@ TTF_Font* font = nullptr;
 /* Text texture */
 LTexture startPromptTexture;
 LTexture pausePromptTexture;
-LTexture timeTexture;
+/* Glyphs time text is drawn from */
+LGlyphAtlas timeAtlas;
 
 int main(int argc, char* args[])
 {
@@ -88,11 +90,7 @@ int main(int argc, char* args[])
 
 		/* Set text to be rendered */
 		timeText.str("");
-		timeText << "Seconds since start time " << (timer.getTicks() / 1000.0f);
-
-		/* Load timer's text */
-		if (!timeTexture.loadFromRenderedText(timeText.str(), textColor))
-			printf("Unable to render time texture!\n");
+		timeText << "Seconds since start time " << timer.getSeconds();
 
 		/* Clear screen */
 		SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
@@ -101,8 +99,8 @@ int main(int argc, char* args[])
 		/* Render textures */
 		startPromptTexture.render((SCREEN_WIDTH - startPromptTexture.width()) / 2, 0);
 		pausePromptTexture.render((SCREEN_WIDTH - pausePromptTexture.width()) / 2, startPromptTexture.height());
-		timeTexture.render((SCREEN_WIDTH - timeTexture.width()) / 2, 
-			(SCREEN_HEIGHT - timeTexture.height()) / 2);
+		timeAtlas.render((SCREEN_WIDTH - timeAtlas.textWidth(timeText.str())) / 2,
+			(SCREEN_HEIGHT - timeAtlas.lineHeight()) / 2, timeText.str(), textColor);
 
 		/* Update screen */
 		SDL_RenderPresent(renderer);
@@ -185,6 +183,12 @@ bool loadMedia()
 			printf("Couldn't load pause prompt texture!\n");
 			success = false;
 		}
+
+		/* Create atlas for timer's text */
+		if (!timeAtlas.create(font)) {
+			printf("Couldn't create glyph atlas!\n");
+			success = false;
+		}
 	}
 
 	return success;
@@ -193,7 +197,7 @@ bool loadMedia()
 void close()
 {
 	/* Free textures */
-	timeTexture.free();
+	timeAtlas.free();
 	startPromptTexture.free();
 	pausePromptTexture.free();
 
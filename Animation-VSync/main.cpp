@@ -2,9 +2,11 @@
 #include "SDL2/SDL_image.h"
 
 #include "LTexture.h"
+#include "LProfiler.h"
 
 #include <stdio.h>
 #include <string>
+#include <vector>
 
 
 /* Initialize the program */
@@ -14,6 +16,11 @@ bool loadMedia();
 /* Clean up */
 void close();
 
+/* Measure zone cost and profile frames alongside busy threads, false if the exported trace misses anything */
+bool runBenchmark();
+/* Record nested zones on a thread of its own */
+int profiledWork(void* data);
+
 
 /* Screen constants */
 const int SCREEN_WIDTH = 640;
@@ -31,6 +38,14 @@ LTexture spriteSheetTexture;
 
 int main(int argc, char* args[])
 {
+	/* Run headless benchmark instead of the demo */
+	bool benchmark = (argc > 1) && (std::string(args[1]) == "--bench");
+	if (benchmark) {
+		SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+		SDL_SetHint(SDL_HINT_RENDER_DRIVER, "software");
+		SDL_SetHint(SDL_HINT_RENDER_VSYNC, "0");
+	}
+
 	/* Initialize */
 	if (!init()) {
 		printf("Failed to initialize!\n");
@@ -45,36 +60,73 @@ int main(int argc, char* args[])
 		return -1;
 	}
 
+	if (benchmark) {
+		bool passed = runBenchmark();
+		close();
+		return passed ? 0 : -1;
+	}
+
 	bool quit = false;
 	SDL_Event e;
 
 	/* Current animation frame */
 	int frame = 0;
 
+	/* Frame time graph, F1 shows it and F2 writes Chrome trace of recent frames */
+	bool showProfile = false;
+	const SDL_Rect profileArea = { 10, 10, 2 * LProfiler::FRAME_HISTORY, 80 };
+	PROFILE_THREAD("Main");
+
 	while (!quit) {
-		while (SDL_PollEvent(&e)) {
-			if (e.type == SDL_QUIT)
-				quit = true;
+		{
+			PROFILE_ZONE("Events");
+			while (SDL_PollEvent(&e)) {
+				if (e.type == SDL_QUIT)
+					quit = true;
+				else if (e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_F1)
+					showProfile = !showProfile;
+				else if (e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_F2) {
+					if (LProfiler::exportChromeTrace("profile.json"))
+						printf("Wrote profile.json\n");
+				}
+			}
+		}
+
+		{
+			PROFILE_ZONE("Render");
+
+			/* Clear screen */
+			SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
+			SDL_RenderClear(renderer);
+
+			/* Render current frame */
+			SDL_Rect* currentClip = &spriteClips[frame / 4];
+			spriteSheetTexture.render((SCREEN_WIDTH - currentClip->w) / 2, (SCREEN_HEIGHT - currentClip->h) / 2,
+				currentClip);
+
+			if (showProfile)
+				LProfiler::renderOverlay(profileArea);
 		}
 
-		/* Clear screen */
-		SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
-		SDL_RenderClear(renderer);
+		{
+			PROFILE_ZONE("Present");
 
-		/* Render current frame */
-		SDL_Rect* currentClip = &spriteClips[frame / 4];
-		spriteSheetTexture.render((SCREEN_WIDTH - currentClip->w) / 2, (SCREEN_HEIGHT - currentClip->h) / 2,
-			currentClip);
+			/* Update screen */
+			SDL_RenderPresent(renderer);
+		}
 
-		/* Update screen */
-		SDL_RenderPresent(renderer);
+		{
+			PROFILE_ZONE("Update");
 
-		/* Go to the next frame */
-		++frame;
+			/* Go to the next frame */
+			++frame;
 
-		/* Cycle animation */
-		if ((frame / 4) >= WALKING_ANIMATION_FRAMES)
-			frame = 0;
+			/* Cycle animation */
+			if ((frame / 4) >= WALKING_ANIMATION_FRAMES)
+				frame = 0;
+		}
+
+		PROFILE_FRAME();
 	}
 	
 	/* Clean up */
@@ -168,4 +220,127 @@ void close()
 	/* Quit the SDL library */
 	IMG_Quit();
 	SDL_Quit();
+}
+
+int profiledWork(void* data)
+{
+	int zones = *static_cast<int*>(data);
+	PROFILE_THREAD("Worker");
+
+	/* Outer and inner zone around some busy work */
+	volatile Uint32 sum = 0;
+	for (int i = 0; i < zones; ++i) {
+		PROFILE_ZONE("Job");
+		for (int j = 0; j < 200; ++j)
+			sum = sum + j;
+		{
+			PROFILE_ZONE("Step");
+			for (int j = 0; j < 200; ++j)
+				sum = sum + j;
+		}
+	}
+
+	return 0;
+}
+
+bool runBenchmark()
+{
+#if defined(LPROFILER_DISABLED)
+	printf("Profiler is compiled out, nothing to measure\n");
+	printf("Profiler benchmark passed\n");
+	return true;
+#else
+	const int ZONES = 1000000;
+	const int FRAMES = 240;
+	const int WORKERS = 3;
+	/* More zones than a ring keeps, so workers wrap around while being exported */
+	int workerZones = LProfiler::RING_SIZE;
+	const double frequency = static_cast<double>(SDL_GetPerformanceFrequency());
+
+	/* Cost of a zone over an empty loop */
+	PROFILE_THREAD("Main");
+	volatile int counter = 0;
+	Uint64 start = SDL_GetPerformanceCounter();
+	for (int i = 0; i < ZONES; ++i)
+		counter = counter + 1;
+	Uint64 empty = SDL_GetPerformanceCounter() - start;
+
+	start = SDL_GetPerformanceCounter();
+	for (int i = 0; i < ZONES; ++i) {
+		PROFILE_ZONE("Overhead");
+		counter = counter + 1;
+	}
+	Uint64 zoned = SDL_GetPerformanceCounter() - start;
+	double nanosecondsPerZone = (static_cast<double>(zoned) - static_cast<double>(empty)) * 1000000000.0 / frequency / ZONES;
+	printf("%d zones: %.1f ns per zone\n", ZONES, nanosecondsPerZone);
+
+	/* Frames while workers record on their own threads */
+	LProfiler::reset();
+	Uint64 eventsBefore = LProfiler::eventCount();
+	std::vector<SDL_Thread*> workers;
+	for (int i = 0; i < WORKERS; ++i)
+		workers.push_back(SDL_CreateThread(profiledWork, "ProfiledWork", &workerZones));
+
+	const SDL_Rect profileArea = { 10, 10, 2 * LProfiler::FRAME_HISTORY, 80 };
+	bool exported = true;
+	for (int frame = 0; frame < FRAMES; ++frame) {
+		{
+			PROFILE_ZONE("Events");
+			SDL_PumpEvents();
+		}
+		{
+			PROFILE_ZONE("Render");
+			SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
+			SDL_RenderClear(renderer);
+			SDL_Rect* currentClip = &spriteClips[frame / 4 % WALKING_ANIMATION_FRAMES];
+			spriteSheetTexture.render((SCREEN_WIDTH - currentClip->w) / 2, (SCREEN_HEIGHT - currentClip->h) / 2,
+				currentClip);
+			LProfiler::renderOverlay(profileArea);
+		}
+		{
+			PROFILE_ZONE("Present");
+			SDL_RenderPresent(renderer);
+		}
+
+		/* Export while workers are still writing */
+		if (frame == FRAMES / 2)
+			exported = LProfiler::exportChromeTrace("bench_profile.json") && exported;
+
+		PROFILE_FRAME();
+	}
+
+	for (SDL_Thread* worker : workers)
+		SDL_WaitThread(worker, NULL);
+	exported = LProfiler::exportChromeTrace("bench_profile.json") && exported;
+
+	/* Check trace has every thread and as many events as the rings keep */
+	size_t size = 0;
+	char* trace = static_cast<char*>(SDL_LoadFile("bench_profile.json", &size));
+	int completeEvents = 0, threadNames = 0;
+	bool wellFormed = false;
+	if (trace) {
+		std::string json(trace, size);
+		SDL_free(trace);
+		wellFormed = json.rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 0) == 0 &&
+			json.compare(json.size() - 2, 2, "]}") == 0;
+		for (size_t at = json.find("\"ph\":\"X\""); at != std::string::npos; at = json.find("\"ph\":\"X\"", at + 1))
+			++completeEvents;
+		for (size_t at = json.find("\"thread_name\""); at != std::string::npos; at = json.find("\"thread_name\"", at + 1))
+			++threadNames;
+	}
+	remove("bench_profile.json");
+
+	Uint64 recorded = LProfiler::eventCount() - eventsBefore;
+	int expectedEvents = (FRAMES * 3) + WORKERS * LProfiler::RING_SIZE;
+	printf("%llu events recorded, %d exported from %d threads\n", static_cast<unsigned long long>(recorded),
+		completeEvents, threadNames);
+	printf("Average frame: %.4f ms events, %.4f ms render, %.4f ms present\n",
+		LProfiler::getAverageMilliseconds("Events"), LProfiler::getAverageMilliseconds("Render"),
+		LProfiler::getAverageMilliseconds("Present"));
+
+	bool passed = exported && wellFormed && threadNames == WORKERS + 1 && completeEvents == expectedEvents &&
+		LProfiler::getAverageMilliseconds("Render") >= 0.0 && nanosecondsPerZone < 1000.0;
+	printf("Profiler benchmark %s\n", passed ? "passed" : "FAILED");
+	return passed;
+#endif
 }
\ No newline at end of file
@@ -1,10 +1,15 @@
 #include "LBitmapFont.h"
 
-LBitmapFont::LBitmapFont() : m_newLine(0), m_space(0)
+LBitmapFont::LBitmapFont() : m_newLine(0), m_space(0), m_textUses(0), m_textLayouts(0)
 {
 }
 
-bool LBitmapFont::buildFont(const std::string& path)
+/* Sidecar metrics file constants */
+static const char METRICS_MAGIC[4] = { 'B', 'F', 'N', 'T' };
+static const Uint32 METRICS_VERSION = 1;
+static const Sint64 METRICS_SIZE = 4 + 4 + 8 + 4 + 4 + 256 * 4 * 4;
+
+bool LBitmapFont::buildFont(const std::string& path, bool useCache)
 {
 	/* Free preexisting texture */
 	free();
@@ -16,135 +21,21 @@ bool LBitmapFont::buildFont(const std::string& path)
 		success = false;
 	}
 	else {
-		/* Get the background color */
-		Uint32 bgColor = m_fontTexture.getPixel32(0, 0);
-
-		/* Set the cell dimensions */
-		int cellW = m_fontTexture.width() / 16;
-		int cellH = m_fontTexture.height() / 16;
-
-		/* New line variables */
-		int top = cellH;
-		int baseA = cellH;
-
-		/* The current character set */
-		int currentChar = 0;
-
-		/* Go through the cell rows */
-		for (int rows = 0; rows < 16; ++rows) {
-			/* Go through cell columns */
-			for (int cols = 0; cols < 16; ++cols) {
-				/* Set character offset */
-				m_chars[currentChar].x = cellW * cols;
-				m_chars[currentChar].y = cellH * rows;
-
-				/* Set the dimensions of the character */
-				m_chars[currentChar].w = cellW;
-				m_chars[currentChar].h = cellH;
-
-				/* Find left side */
-				/* Go through pixel columns */
-				for (int pCol = 0; pCol < cellW; ++pCol) {
-					/* Go through pixel rows */
-					for (int pRow = 0; pRow < cellH; ++pRow) {
-						/* Get pixel offsets */
-						int pX = (cellW * cols) + pCol;
-						int pY = (cellH * rows) + pRow;
-
-						/* If non-color key pixel is found */
-						if (m_fontTexture.getPixel32(pX, pY) != bgColor) {
-							/* Set the x offset */
-							m_chars[currentChar].x = pX;
-
-							/* Break the loop */
-							pCol = cellW;
-							pRow = cellH;
-						}
-					}
-
-					/* Find right side */
-					/* Go through pixel columns */
-					for (int pColW = cellW - 1; pColW >= 0; --pColW) {
-						/* Go through pixel rows */
-						for (int pRowW = 0; pRowW < cellH; ++pRowW) {
-							/* Get pixel offsets */
-							int pX = (cellW * cols) + pColW;
-							int pY = (cellH * rows) + pRowW;
-
-							/* If non-color key pixel is found */
-							if (m_fontTexture.getPixel32(pX, pY) != bgColor) {
-								/* Set the width */
-								m_chars[currentChar].w = (pX - m_chars[currentChar].x) + 1;
-
-								/* Break the loop */
-								pColW = -1;
-								pRowW = cellH;
-							}
-						}
-					}
-
-					/* Find top */
-					/* Go through pixel rows */
-					for (int pRow = 0; pRow < cellH; ++pRow) {
-						/* Go through pixel columns */
-						for (int pCol = 0; pCol < cellW; ++pCol) {
-							/* Get pixel offsets */
-							int pX = (cellW * cols) + pCol;
-							int pY = (cellH * rows) + pRow;
-
-							/* If non-color key pixel is found */
-							if (m_fontTexture.getPixel32(pX, pY) != bgColor) {
-								/* If new top is found */
-								if (pRow < top)
-									top = pRow;
-
-								/* Break the loop */
-								pRow = cellH;
-								pCol = cellW;
-							}
-						}
-					}
-
-					/* Find bottom of 'A' */
-					if (currentChar == 'A') {
-						/* Go through pixel rows */
-						for (int pRow = cellH - 1; pRow >= 0; --pRow) {
-							/* Go through pixel columns */
-							for (int pCol = 0; pCol < cellW; ++pCol) {
-								/* Get pixel offsets */
-								int pX = (cellW * cols) + pCol;
-								int pY = (cellH * rows) + pRow;
-
-								/* If non-color key pixel is found */
-								if (m_fontTexture.getPixel32(pX, pY) != bgColor) {
-									/* Bottom of 'A' is found */
-									baseA = pRow;
-
-									/* Break the loop */
-									pCol = cellW;
-									pRow = -1;
-								}
-							}
-						}
-					}
-				}
-
-				/* Go to the next character */
-				++currentChar;
-			}
+		/* Scan the sheet only if the cache doesn't match the image */
+		BitmapFontMetrics metrics;
+		const std::string cachePath = path + ".metrics";
+		Uint64 hash = useCache ? hashFile(path) : 0;
+		if (!useCache || !loadMetrics(cachePath, hash, metrics)) {
+			extractMetrics(m_fontTexture.getPixels32(), m_fontTexture.getPitch32(), m_fontTexture.width(),
+				m_fontTexture.height(), metrics);
+
+			if (useCache && !saveMetrics(cachePath, hash, metrics))
+				printf("Warning: Couldn't cache font metrics to %s!\n", cachePath.c_str());
 		}
 
-		/* Calculate space */
-		m_space = cellW / 2;
-
-		/* Calculate new line */
-		m_newLine = baseA - top;
-
-		/* Lop off excess top pixels */
-		for (int i = 0; i < 256; i++) {
-			m_chars[i].y += top;
-			m_chars[i].h -= top;
-		}
+		SDL_memcpy(m_chars, metrics.chars, sizeof(m_chars));
+		m_newLine = metrics.newLine;
+		m_space = metrics.space;
 
 		/* Create final texture */
 		if (!m_fontTexture.loadFromPixels()) {
@@ -156,10 +47,182 @@ bool LBitmapFont::buildFont(const std::string& path)
 	return success;
 }
 
-void LBitmapFont::renderText(int x, int y, const std::string& text)
+void LBitmapFont::extractMetrics(const Uint32* pixels, int pitch32, int width, int height,
+	BitmapFontMetrics& metrics)
+{
+	/* Get the background color */
+	Uint32 bgColor = pixels[0];
+
+	/* Set the cell dimensions */
+	int cellW = width / 16;
+	int cellH = height / 16;
+
+	/* New line variables */
+	int top = cellH;
+	int baseA = cellH;
+
+	for (int currentChar = 0; currentChar < 256; ++currentChar) {
+		int cellX = cellW * (currentChar % 16);
+		int cellY = cellH * (currentChar / 16);
+
+		/* Glyph bounds inside the cell, empty while nothing is found */
+		int left = cellW, right = -1, firstRow = -1, lastRow = -1;
+
+		for (int pRow = 0; pRow < cellH; ++pRow) {
+			const Uint32* row = &pixels[(cellY + pRow) * pitch32 + cellX];
+
+			/* Leftmost pixel of the row */
+			int pCol = 0;
+			while (pCol < cellW && row[pCol] == bgColor)
+				++pCol;
+			if (pCol == cellW)
+				continue;
+			left = SDL_min(left, pCol);
+
+			/* Rightmost pixel, the scan stops where the left one did */
+			int pColW = cellW - 1;
+			while (pColW > right && pColW > pCol && row[pColW] == bgColor)
+				--pColW;
+			right = SDL_max(right, pColW);
+
+			if (firstRow < 0)
+				firstRow = pRow;
+			lastRow = pRow;
+		}
+
+		/* Empty cells keep the whole cell */
+		SDL_Rect& glyph = metrics.chars[currentChar];
+		glyph = { cellX, cellY, cellW, cellH };
+		if (right >= 0) {
+			glyph.x = cellX + left;
+			glyph.w = right - left + 1;
+
+			top = SDL_min(top, firstRow);
+			if (currentChar == 'A')
+				baseA = lastRow;
+		}
+	}
+
+	/* Calculate space */
+	metrics.space = cellW / 2;
+
+	/* Calculate new line */
+	metrics.newLine = baseA - top;
+
+	/* Lop off excess top pixels */
+	for (int i = 0; i < 256; i++) {
+		metrics.chars[i].y += top;
+		metrics.chars[i].h -= top;
+	}
+}
+
+bool LBitmapFont::saveMetrics(const std::string& path, Uint64 sourceHash, const BitmapFontMetrics& metrics)
+{
+	SDL_RWops* file = SDL_RWFromFile(path.c_str(), "wb");
+	if (file == NULL)
+		return false;
+
+	/* Header, spacing, then every glyph, all little endian */
+	bool success = SDL_RWwrite(file, METRICS_MAGIC, sizeof(METRICS_MAGIC), 1) == 1;
+	success &= SDL_WriteLE32(file, METRICS_VERSION) == 1;
+	success &= SDL_WriteLE64(file, sourceHash) == 1;
+	success &= SDL_WriteLE32(file, static_cast<Uint32>(metrics.newLine)) == 1;
+	success &= SDL_WriteLE32(file, static_cast<Uint32>(metrics.space)) == 1;
+	for (const SDL_Rect& glyph : metrics.chars) {
+		success &= SDL_WriteLE32(file, static_cast<Uint32>(glyph.x)) == 1;
+		success &= SDL_WriteLE32(file, static_cast<Uint32>(glyph.y)) == 1;
+		success &= SDL_WriteLE32(file, static_cast<Uint32>(glyph.w)) == 1;
+		success &= SDL_WriteLE32(file, static_cast<Uint32>(glyph.h)) == 1;
+	}
+
+	SDL_RWclose(file);
+	return success;
+}
+
+bool LBitmapFont::loadMetrics(const std::string& path, Uint64 sourceHash, BitmapFontMetrics& metrics)
+{
+	SDL_RWops* file = SDL_RWFromFile(path.c_str(), "rb");
+	if (file == NULL)
+		return false;
+
+	/* Cache has to be complete and made from this very image */
+	char magic[4];
+	bool valid = SDL_RWsize(file) == METRICS_SIZE && SDL_RWread(file, magic, sizeof(magic), 1) == 1 &&
+		SDL_memcmp(magic, METRICS_MAGIC, sizeof(magic)) == 0 && SDL_ReadLE32(file) == METRICS_VERSION &&
+		sourceHash != 0 && SDL_ReadLE64(file) == sourceHash;
+
+	if (valid) {
+		metrics.newLine = static_cast<Sint32>(SDL_ReadLE32(file));
+		metrics.space = static_cast<Sint32>(SDL_ReadLE32(file));
+		for (SDL_Rect& glyph : metrics.chars) {
+			glyph.x = static_cast<Sint32>(SDL_ReadLE32(file));
+			glyph.y = static_cast<Sint32>(SDL_ReadLE32(file));
+			glyph.w = static_cast<Sint32>(SDL_ReadLE32(file));
+			glyph.h = static_cast<Sint32>(SDL_ReadLE32(file));
+		}
+	}
+
+	SDL_RWclose(file);
+	return valid;
+}
+
+Uint64 LBitmapFont::hashFile(const std::string& path)
+{
+	SDL_RWops* file = SDL_RWFromFile(path.c_str(), "rb");
+	if (file == NULL)
+		return 0;
+
+	/* 64 bit FNV-1a */
+	Uint64 hash = 0xCBF29CE484222325ULL;
+	Uint8 buffer[4096];
+	size_t read;
+	while ((read = SDL_RWread(file, buffer, 1, sizeof(buffer))) > 0) {
+		for (size_t i = 0; i < read; ++i) {
+			hash ^= buffer[i];
+			hash *= 0x100000001B3ULL;
+		}
+	}
+
+	SDL_RWclose(file);
+	return hash;
+}
+
+void LBitmapFont::renderText(int x, int y, const std::string& text, bool cached)
 {
-	/* If the font has been built */
-	if (m_fontTexture.width() > 0) {
+	/* Reuse quads of the string last shown at this position */
+	if (cached && m_fontTexture.width() > 0) {
+		Uint64 key = (static_cast<Uint64>(static_cast<Uint32>(x)) << 32) | static_cast<Uint32>(y);
+		auto found = m_textRuns.find(key);
+		bool fresh = found == m_textRuns.end();
+		if (fresh) {
+			if (static_cast<int>(m_textRuns.size()) >= MAX_TEXT_RUNS)
+				evictTextRun();
+			found = m_textRuns.emplace(key, TextRun()).first;
+		}
+		TextRun& run = found->second;
+		run.lastUsed = ++m_textUses;
+
+		/* Lay out again only if the text or the texture modulation changed */
+		SDL_Color color = { 0xFF, 0xFF, 0xFF, 0xFF };
+		SDL_GetTextureColorMod(m_fontTexture.getTexture(), &color.r, &color.g, &color.b);
+		SDL_GetTextureAlphaMod(m_fontTexture.getTexture(), &color.a);
+		if (fresh || run.text != text || SDL_memcmp(&run.color, &color, sizeof(color)) != 0) {
+			run.text = text;
+			run.color = color;
+			layoutText(run, x, y);
+		}
+
+		/* Whole string at once */
+		if (!run.indices.empty()) {
+			if (SDL_RenderGeometry(renderer, m_fontTexture.getTexture(), run.vertices.data(),
+				static_cast<int>(run.vertices.size()), run.indices.data(), static_cast<int>(run.indices.size())) < 0)
+				printf("Unable to render text! SDL_Error: %s\n", SDL_GetError());
+			LTexture::countDraw(m_fontTexture.getTexture());
+		}
+	}
+
+	/* One copy per character */
+	else if (m_fontTexture.width() > 0) {
 		/* Temp offsets */
 		int curX = x, curY = y;
 
@@ -193,7 +256,80 @@ void LBitmapFont::renderText(int x, int y, const std::string& text)
 	}
 }
 
+void LBitmapFont::layoutText(TextRun& run, int x, int y)
+{
+	++m_textLayouts;
+	run.vertices.clear();
+	run.indices.clear();
+
+	const float textureWidth = static_cast<float>(m_fontTexture.width());
+	const float textureHeight = static_cast<float>(m_fontTexture.height());
+
+	/* Same walk as the per character path */
+	int curX = x, curY = y;
+	for (char character : run.text) {
+		if (character == ' ')
+			curX += m_space;
+		else if (character == '\n') {
+			curY += m_newLine;
+			curX = x;
+		}
+		else {
+			const SDL_Rect& glyph = m_chars[static_cast<unsigned char>(character)];
+
+			float left = static_cast<float>(curX), top = static_cast<float>(curY);
+			float right = static_cast<float>(curX + glyph.w), bottom = static_cast<float>(curY + glyph.h);
+			float u0 = glyph.x / textureWidth, v0 = glyph.y / textureHeight;
+			float u1 = (glyph.x + glyph.w) / textureWidth, v1 = (glyph.y + glyph.h) / textureHeight;
+
+			/* Two triangles per glyph */
+			int first = static_cast<int>(run.vertices.size());
+			run.vertices.push_back({ { left, top }, run.color, { u0, v0 } });
+			run.vertices.push_back({ { right, top }, run.color, { u1, v0 } });
+			run.vertices.push_back({ { right, bottom }, run.color, { u1, v1 } });
+			run.vertices.push_back({ { left, bottom }, run.color, { u0, v1 } });
+
+			const int corners[] = { 0, 1, 2, 0, 2, 3 };
+			for (int corner : corners)
+				run.indices.push_back(first + corner);
+
+			curX += glyph.w + 1;
+		}
+	}
+}
+
+void LBitmapFont::evictTextRun()
+{
+	auto oldest = m_textRuns.begin();
+	for (auto run = m_textRuns.begin(); run != m_textRuns.end(); ++run) {
+		if (run->second.lastUsed < oldest->second.lastUsed)
+			oldest = run;
+	}
+
+	if (oldest != m_textRuns.end())
+		m_textRuns.erase(oldest);
+}
+
+void LBitmapFont::clearTextCache()
+{
+	m_textRuns.clear();
+}
+
+int LBitmapFont::cachedTextRuns() const
+{
+	return static_cast<int>(m_textRuns.size());
+}
+
+int LBitmapFont::textLayouts() const
+{
+	return m_textLayouts;
+}
+
 void LBitmapFont::free()
 {
 	m_fontTexture.free();
+
+	/* Quads point into the old texture */
+	clearTextCache();
+	m_textLayouts = 0;
 }
\ No newline at end of file
@@ -3,21 +3,72 @@
 #include "LTexture.h"
 
 #include <string>
+#include <unordered_map>
+#include <vector>
+
+/* Glyph rectangles and spacing of a bitmap font */
+struct BitmapFontMetrics
+{
+	/* The individual characters in surface */
+	SDL_Rect chars[256];
+
+	/* Spacing variables */
+	int newLine, space;
+};
 
 /* Bitmap Font class */
 class LBitmapFont
 {
+public:
+	/* Laid out strings kept for reuse */
+	static const int MAX_TEXT_RUNS = 256;
+
 public:
 	LBitmapFont();
 
-	/* Generate the font */
-	bool buildFont(const std::string& path);
+	/* Generate the font, reusing metrics from the sidecar cache next to the image when they are current */
+	bool buildFont(const std::string& path, bool useCache = true);
 
 	/* Deallocate text */
 	void free();
 
-	/* Show the text */
-	void renderText(int x, int y, const std::string& text);
+	/* Show the text, cached as one geometry batch per position unless told otherwise */
+	void renderText(int x, int y, const std::string& text, bool cached = true);
+
+	/* Forget laid out strings */
+	void clearTextCache();
+
+	/* Get amount of cached strings and of layouts done since font was built */
+	int cachedTextRuns() const;
+	int textLayouts() const;
+
+	/* Find glyphs of a 16x16 character sheet, reading every pixel at most once */
+	static void extractMetrics(const Uint32* pixels, int pitch32, int width, int height, BitmapFontMetrics& metrics);
+
+	/* Write metrics to sidecar file, tagged with hash of the image they came from */
+	static bool saveMetrics(const std::string& path, Uint64 sourceHash, const BitmapFontMetrics& metrics);
+	/* Read metrics from sidecar file, false if it's missing, broken or made for another image */
+	static bool loadMetrics(const std::string& path, Uint64 sourceHash, BitmapFontMetrics& metrics);
+
+	/* Hash contents of a file, 0 if it can't be read */
+	static Uint64 hashFile(const std::string& path);
+
+private:
+	/* Glyph quads of a string laid out at one position */
+	struct TextRun
+	{
+		std::string text;
+		SDL_Color color;
+		std::vector<SDL_Vertex> vertices;
+		std::vector<int> indices;
+		Uint32 lastUsed;
+	};
+
+	/* Build quads of run's text starting at given point */
+	void layoutText(TextRun& run, int x, int y);
+
+	/* Drop the run used longest ago */
+	void evictTextRun();
 
 private:
 	/* The font texture */
@@ -28,5 +79,10 @@ private:
 
 	/* Spacing variables */
 	int m_newLine, m_space;
+
+	/* Laid out strings by their packed position */
+	std::unordered_map<Uint64, TextRun> m_textRuns;
+	Uint32 m_textUses;
+	int m_textLayouts;
 };
 
@@ -7,6 +7,7 @@
 #include <stdio.h>
 #include <string>
 #include <fstream>
+#include <vector>
 
 
 /* Initialize the program */
@@ -16,6 +17,11 @@ bool loadMedia();
 /* Clean up */
 void close();
 
+/* Check glyph metrics extraction and its cache against the old scan, false if they differ */
+bool runBenchmark();
+/* Compare cached text batches against per character rendering, false if they show different pixels */
+bool runTextBenchmark();
+
 
 /* Screen dimensions */
 const int SCREEN_WIDTH = 640;
@@ -31,6 +37,26 @@ LBitmapFont font;
 
 int main(int argc, char* args[])
 {
+	/* Metrics benchmark needs no window, text one runs headless */
+	bool benchmark = (argc > 1) && (std::string(args[1]) == "--bench");
+	if (benchmark) {
+		if (!runBenchmark())
+			return -1;
+
+		SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+		SDL_SetHint(SDL_HINT_RENDER_DRIVER, "software");
+		SDL_SetHint(SDL_HINT_RENDER_VSYNC, "0");
+		if (!init()) {
+			printf("Failed to initialize!\n");
+			close();
+			return -1;
+		}
+
+		bool passed = runTextBenchmark();
+		close();
+		return passed ? 0 : -1;
+	}
+
 	/* Initialize */
 	if (!init()) {
 		printf("Failed to initialize!\n");
@@ -144,4 +170,255 @@ void close()
 	/* Quit the SDL library */
 	IMG_Quit();
 	SDL_Quit();
+}
+
+/* Glyph scan buildFont used to do, with its right side and top scans repeated for every column */
+static void extractMetricsLegacy(const Uint32* pixels, int pitch32, int width, int height,
+	BitmapFontMetrics& metrics)
+{
+	auto getPixel32 = [pixels, pitch32](int x, int y) { return pixels[y * pitch32 + x]; };
+
+	Uint32 bgColor = getPixel32(0, 0);
+	int cellW = width / 16;
+	int cellH = height / 16;
+	int top = cellH;
+	int baseA = cellH;
+
+	int currentChar = 0;
+	for (int rows = 0; rows < 16; ++rows) {
+		for (int cols = 0; cols < 16; ++cols) {
+			SDL_Rect& glyph = metrics.chars[currentChar];
+			glyph = { cellW * cols, cellH * rows, cellW, cellH };
+
+			for (int pCol = 0; pCol < cellW; ++pCol) {
+				for (int pRow = 0; pRow < cellH; ++pRow) {
+					int pX = (cellW * cols) + pCol, pY = (cellH * rows) + pRow;
+					if (getPixel32(pX, pY) != bgColor) {
+						glyph.x = pX;
+						pCol = cellW;
+						pRow = cellH;
+					}
+				}
+
+				for (int pColW = cellW - 1; pColW >= 0; --pColW) {
+					for (int pRowW = 0; pRowW < cellH; ++pRowW) {
+						int pX = (cellW * cols) + pColW, pY = (cellH * rows) + pRowW;
+						if (getPixel32(pX, pY) != bgColor) {
+							glyph.w = (pX - glyph.x) + 1;
+							pColW = -1;
+							pRowW = cellH;
+						}
+					}
+				}
+
+				for (int pRow = 0; pRow < cellH; ++pRow) {
+					for (int pCol = 0; pCol < cellW; ++pCol) {
+						int pX = (cellW * cols) + pCol, pY = (cellH * rows) + pRow;
+						if (getPixel32(pX, pY) != bgColor) {
+							if (pRow < top)
+								top = pRow;
+							pRow = cellH;
+							pCol = cellW;
+						}
+					}
+				}
+
+				if (currentChar == 'A') {
+					for (int pRow = cellH - 1; pRow >= 0; --pRow) {
+						for (int pCol = 0; pCol < cellW; ++pCol) {
+							int pX = (cellW * cols) + pCol, pY = (cellH * rows) + pRow;
+							if (getPixel32(pX, pY) != bgColor) {
+								baseA = pRow;
+								pCol = cellW;
+								pRow = -1;
+							}
+						}
+					}
+				}
+			}
+
+			++currentChar;
+		}
+	}
+
+	metrics.space = cellW / 2;
+	metrics.newLine = baseA - top;
+	for (int i = 0; i < 256; i++) {
+		metrics.chars[i].y += top;
+		metrics.chars[i].h -= top;
+	}
+}
+
+static bool sameMetrics(const BitmapFontMetrics& a, const BitmapFontMetrics& b)
+{
+	if (a.newLine != b.newLine || a.space != b.space)
+		return false;
+
+	for (int i = 0; i < 256; ++i) {
+		if (a.chars[i].x != b.chars[i].x || a.chars[i].y != b.chars[i].y || a.chars[i].w != b.chars[i].w ||
+			a.chars[i].h != b.chars[i].h)
+			return false;
+	}
+
+	return true;
+}
+
+/* Character sheet of random glyph shapes, some cells left empty */
+static void createSheet(std::vector<Uint32>& pixels, int cellW, int cellH)
+{
+	const Uint32 background = 0xFF00FFFF, ink = 0xFF000000;
+
+	const int width = cellW * 16;
+	pixels.assign(static_cast<size_t>(width) * cellH * 16, background);
+	for (int cell = 0; cell < 256; ++cell) {
+		if (rand() % 8 == 0)
+			continue;
+
+		/* Scattered strokes inside a random box of the cell */
+		int left = rand() % (cellW / 2), top = 2 + rand() % (cellH / 3);
+		int right = left + 1 + rand() % (cellW - left - 1), bottom = top + 1 + rand() % (cellH - top - 1);
+		for (int y = top; y < bottom; ++y) {
+			for (int x = left; x < right; ++x) {
+				if (rand() % 3 == 0)
+					pixels[((cell / 16) * cellH + y) * width + (cell % 16) * cellW + x] = ink;
+			}
+		}
+	}
+}
+
+bool runBenchmark()
+{
+	const int SHEETS = 20;
+	const double frequency = static_cast<double>(SDL_GetPerformanceFrequency());
+
+	bool passed = true;
+	const int cellSizes[][2] = { { 16, 16 }, { 32, 40 }, { 64, 64 } };
+	for (const auto& size : cellSizes) {
+		const int cellW = size[0], cellH = size[1];
+		const int width = cellW * 16, height = cellH * 16;
+
+		srand(cellW * cellH);
+		int mismatches = 0;
+		double ms[2] = { 0.0, 0.0 };
+		std::vector<Uint32> pixels;
+		for (int sheet = 0; sheet < SHEETS; ++sheet) {
+			createSheet(pixels, cellW, cellH);
+
+			BitmapFontMetrics metrics[2];
+			for (int legacy = 0; legacy < 2; ++legacy) {
+				Uint64 start = SDL_GetPerformanceCounter();
+				if (legacy)
+					extractMetricsLegacy(pixels.data(), width, width, height, metrics[legacy]);
+				else
+					LBitmapFont::extractMetrics(pixels.data(), width, width, height, metrics[legacy]);
+				ms[legacy] += (SDL_GetPerformanceCounter() - start) * 1000.0 / frequency;
+			}
+
+			mismatches += !sameMetrics(metrics[0], metrics[1]);
+		}
+
+		printf("%3dx%-3d cells: %8.3f ms single pass, %8.3f ms old scan, %d of %d sheets mismatching\n", cellW,
+			cellH, ms[0] / SHEETS, ms[1] / SHEETS, mismatches, SHEETS);
+		passed &= mismatches == 0;
+	}
+
+	/* Cached metrics come back unchanged and only for the image they were made from */
+	std::vector<Uint32> pixels;
+	createSheet(pixels, 32, 40);
+	BitmapFontMetrics metrics, cached;
+	LBitmapFont::extractMetrics(pixels.data(), 32 * 16, 32 * 16, 40 * 16, metrics);
+
+	const Uint64 hash = 0x123456789ABCDEFULL;
+	bool cacheValid = LBitmapFont::saveMetrics("bench.metrics", hash, metrics);
+
+	Uint64 start = SDL_GetPerformanceCounter();
+	cacheValid &= LBitmapFont::loadMetrics("bench.metrics", hash, cached);
+	double loadMs = (SDL_GetPerformanceCounter() - start) * 1000.0 / frequency;
+
+	cacheValid &= sameMetrics(metrics, cached) && !LBitmapFont::loadMetrics("bench.metrics", hash + 1, cached);
+	remove("bench.metrics");
+
+	printf("metrics cache: %8.3f ms load, %s\n", loadMs, cacheValid ? "valid" : "INVALID");
+	passed &= cacheValid;
+
+	return passed;
+}
+
+/* Read back what the renderer shows */
+static void readFrame(std::vector<Uint32>& pixels)
+{
+	pixels.resize(SCREEN_WIDTH * SCREEN_HEIGHT);
+	SDL_RenderReadPixels(renderer, NULL, SDL_PIXELFORMAT_ARGB8888, pixels.data(), SCREEN_WIDTH * sizeof(Uint32));
+}
+
+bool runTextBenchmark()
+{
+	const int LINES = 60;
+	const int LINE_LENGTH = 100;
+	const int FRAMES = 100;
+	const double frequency = static_cast<double>(SDL_GetPerformanceFrequency());
+
+	/* Random character sheet saved as a font image, sampled without filtering so both paths match */
+	srand(0);
+	std::vector<Uint32> sheet;
+	createSheet(sheet, 8, 10);
+	SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormatFrom(sheet.data(), 8 * 16, 10 * 16, 32, 8 * 16 * 4,
+		SDL_PIXELFORMAT_ARGB8888);
+	bool saved = surface && SDL_SaveBMP(surface, "bench_font.bmp") == 0;
+	SDL_FreeSurface(surface);
+
+	SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "0");
+	if (!saved || !font.buildFont("bench_font.bmp", false)) {
+		printf("Couldn't create benchmark font!\n");
+		remove("bench_font.bmp");
+		return false;
+	}
+	remove("bench_font.bmp");
+
+	/* HUD of random lines */
+	std::vector<std::string> lines(LINES);
+	for (std::string& line : lines) {
+		for (int i = 0; i < LINE_LENGTH; ++i)
+			line += static_cast<char>(rand() % 8 == 0 ? ' ' : '!' + rand() % 94);
+	}
+
+	/* Per character, cached with static text, cached with the first line changing every frame */
+	const char* names[] = { "per character", "cached static", "cached, 1 line changing" };
+	std::vector<Uint32> frames[3];
+	for (int path = 0; path < 3; ++path) {
+		font.clearTextCache();
+		int layouts = font.textLayouts();
+
+		LTexture::drawCalls = 0;
+		Uint64 start = SDL_GetPerformanceCounter();
+		for (int frame = 0; frame < FRAMES; ++frame) {
+			SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
+			SDL_RenderClear(renderer);
+
+			for (int line = 0; line < LINES; ++line) {
+				if (path == 2 && line == 0)
+					font.renderText(0, 0, "Frame " + std::to_string(frame));
+				else
+					font.renderText(0, line * 8, lines[line], path > 0);
+			}
+
+			/* Last frame is kept for comparison */
+			if (frame == FRAMES - 1)
+				readFrame(frames[path]);
+			SDL_RenderPresent(renderer);
+		}
+		double ms = (SDL_GetPerformanceCounter() - start) * 1000.0 / frequency / FRAMES;
+
+		printf("%-24s %8.3f ms/frame, %6d draw calls/frame, %5d layouts\n", names[path], ms,
+			LTexture::drawCalls / FRAMES, font.textLayouts() - layouts);
+	}
+
+	/* Batched text has to look exactly like the per character one */
+	int different = 0;
+	for (size_t i = 0; i < frames[0].size(); ++i)
+		different += frames[0][i] != frames[1][i];
+	printf("cached text: %d pixels differing from per character rendering\n", different);
+
+	font.free();
+	return different == 0;
 }
\ No newline at end of file
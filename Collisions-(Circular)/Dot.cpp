@@ -1,4 +1,5 @@
 #include "Dot.h"
+#include "CollisionWorld.h"
 
 Dot::Dot(int x, int y) : m_posX(x), m_posY(y), m_velX(0), m_velY(0)
 {
@@ -8,16 +9,12 @@ Dot::Dot(int x, int y) : m_posX(x), m_posY(y), m_velX(0), m_velY(0)
 	/* Move collider relative to the circle */
 	shiftColliders();
 
-	/* Load texture */
-	if (!texture.loadFromFile("Images/dot.bmp"))
+	/* Get texture, loaded only by the first dot */
+	texture = textureCache.acquire("Images/dot.bmp");
+	if (texture == nullptr)
 		printf("Couldn't load dot texture!\n");
 }
 
-Dot::~Dot()
-{
-	texture.free();
-}
-
 void Dot::handleEvent(SDL_Event& event)
 {
 	/* If a key was pressed */
@@ -85,10 +82,40 @@ void Dot::move(const SDL_Rect& square, const Circle& circle)
 	}
 }
 
+void Dot::move(CollisionWorld& world, int handle)
+{
+	/* Move the dot left or right */
+	m_posX += m_velX;
+	shiftColliders();
+	world.setCircle(handle, m_collider);
+
+	/* If the dot is too far to the left or right or touches another collider */
+	if ((m_posX < 0) || (m_posX + DOT_WIDTH > SCREEN_WIDTH) || world.touches(handle)) {
+		/* Move back */
+		m_posX -= m_velX;
+		shiftColliders();
+		world.setCircle(handle, m_collider);
+	}
+
+	/* Move the dot up or down */
+	m_posY += m_velY;
+	shiftColliders();
+	world.setCircle(handle, m_collider);
+
+	/* If the dot is too far up or down or touches another collider */
+	if ((m_posY < 0) || (m_posY + DOT_HEIGHT > SCREEN_HEIGHT) || world.touches(handle)) {
+		/* Move back */
+		m_posY -= m_velY;
+		shiftColliders();
+		world.setCircle(handle, m_collider);
+	}
+}
+
 void Dot::render()
 {
 	/* Show the dot */
-	texture.render(m_posX - m_collider.r, m_posY - m_collider.r);
+	if (texture != nullptr)
+		texture->render(m_posX - m_collider.r, m_posY - m_collider.r);
 }
 
 void Dot::shiftColliders()
@@ -100,59 +127,4 @@ void Dot::shiftColliders()
 Circle& Dot::getColliders()
 {
 	return m_collider;
-}
-
-
-bool checkCollision(const Circle& a, const Circle& b)
-{
-	/* Calculate total radius squared */
-	int totalRadiusSquared = a.r + b.r;
-	totalRadiusSquared *= totalRadiusSquared;
-
-	/* If the distance between the centers of circles is less than the sum of their radii */
-	if (distanceSquared(a.x, a.y, b.x, b.y) < totalRadiusSquared) {
-		/* The circles have collided */
-		return true;
-	}
-
-	/* No collisions */
-	return false;
-}
-
-bool checkCollision(const Circle& a, const SDL_Rect& b)
-{
-	/* Closes point on collision box */
-	int cX, cY;
-
-	/* Find closest x offset */
-	if (a.x < b.x)
-		cX = b.x;
-	else if (a.x > b.x + b.w)
-		cX = b.x + b.w;
-	else
-		cX = a.x;
-
-	/* Find closest y offset */
-	if (a.y < b.y)
-		cY = b.y;
-	else if (a.y > b.y + b.h)
-		cY = b.y + b.h;
-	else
-		cY = a.y;
-
-	/* If the closest point is inside the circle */
-	if (distanceSquared(a.x, a.y, cX, cY) < (a.r * a.r)) {
-		/* This circle and box have collided */
-		return true;
-	}
-	
-	/* No collision */
-	return false;
-}
-
-double distanceSquared(int x1, int y1, int x2, int y2)
-{
-	int deltaX = x2 - x1;
-	int deltaY = y2 - y1;
-	return (deltaX * deltaX) + (deltaY * deltaY);
 }
\ No newline at end of file
@@ -1,7 +1,8 @@
 #pragma once
 #include "SDL2/SDL.h"
 
-#include "LTexture.h"
+#include "LTextureCache.h"
+#include "Collision.h"
 
 #include <vector>
 
@@ -10,18 +11,8 @@
 extern const int SCREEN_WIDTH;
 extern const int SCREEN_HEIGHT;
 
-/* Circle struct */
-struct Circle {
-	int x, y;
-	int r;
-};
-
-/* Circle-Circle collision detector */
-bool checkCollision(const Circle& a, const Circle& b);
-/* Circle-Box collision detector */
-bool checkCollision(const Circle& a, const SDL_Rect& b);
-/* Calculate distance squared between two points */
-double distanceSquared(int x1, int y1, int x2, int y2);
+/* World of colliders dots can move through */
+class CollisionWorld;
 
 
 /* Dot that will move around on the screen */
@@ -36,13 +27,14 @@ public:
 
 public:
 	Dot(int x, int y);
-	~Dot();
 
 	/* Adjust velocity based of key presses */
 	void handleEvent(SDL_Event& event);
 
 	/* Move */
 	void move(const SDL_Rect& square, const Circle& circle);
+	/* Move, colliding with everything else registered in the world under given handle */
+	void move(CollisionWorld& world, int handle);
 
 	/* Show the dot on screen */
 	void render();
@@ -59,8 +51,8 @@ private:
 	int m_posX, m_posY;
 	/* Velocity */
 	int m_velX, m_velY;
-	/* Texture */
-	LTexture texture;
+	/* Texture, shared with every other dot */
+	LTextureCache::Handle texture;
 	/* Dot's collision box */
 	Circle m_collider;
 };
\ No newline at end of file
@@ -2,11 +2,15 @@
 #include "SDL2/SDL_image.h"
 
 #include "LTexture.h"
+#include "LTextureCache.h"
 #include "Dot.h"
+#include "CollisionWorld.h"
 
 #include <stdio.h>
 #include <string>
 #include <sstream>
+#include <vector>
+#include <algorithm>
 
 
 /* Initialize the program */
@@ -16,6 +20,11 @@ bool loadMedia();
 /* Clean up */
 void close();
 
+/* Compare the collision world against testing all pairs, false if they disagree */
+bool runBenchmark();
+/* Compare dots sharing cached texture against each loading its own, false if cache misbehaves */
+bool runCacheBenchmark();
+
 
 /* Screen constants */
 const int SCREEN_WIDTH = 640;
@@ -25,9 +34,28 @@ const int SCREEN_HEIGHT = 480;
 SDL_Window* window = nullptr;
 SDL_Renderer* renderer = nullptr;
 
+/* Global texture cache */
+LTextureCache textureCache;
+
 
 int main(int argc, char* args[])
 {
+	if ((argc > 1) && (std::string(args[1]) == "--bench")) {
+		/* Collision benchmark needs no window */
+		bool passed = runBenchmark();
+
+		/* Texture cache needs a renderer, which can be off screen */
+		SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+		SDL_SetHint(SDL_HINT_RENDER_DRIVER, "software");
+		if (init() && loadMedia())
+			passed &= runCacheBenchmark();
+		else
+			passed = false;
+
+		close();
+		return passed ? 0 : -1;
+	}
+
 	/* Initialize */
 	if (!init()) {
 		printf("Failed to initialize!\n");
@@ -53,6 +81,12 @@ int main(int argc, char* args[])
 	/* Set the wall */
 	SDL_Rect wall = { 300, 40, 40, 400 };
 
+	/* Register everything that collides */
+	CollisionWorld world;
+	world.addBox(wall);
+	world.addCircle(otherDot.getColliders());
+	int dotHandle = world.addCircle(dot.getColliders());
+
 	while (!quit) {
 		while (SDL_PollEvent(&e)) {
 			if (e.type == SDL_QUIT)
@@ -63,7 +97,7 @@ int main(int argc, char* args[])
 		}
 
 		/* Move the dot and check collisions */
-		dot.move(wall, otherDot.getColliders());
+		dot.move(world, dotHandle);
 
 		/* Clear screen */
 		SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
@@ -138,6 +172,9 @@ bool loadMedia()
 
 void close()
 {
+	/* Free textures while renderer is still there */
+	textureCache.clear();
+
 	/* Destroy window */
 	SDL_DestroyWindow(window);
 	SDL_DestroyRenderer(renderer);
@@ -147,4 +184,251 @@ void close()
 	/* Quit the SDL library */
 	IMG_Quit();
 	SDL_Quit();
-} 
\ No newline at end of file
+} 
+
+/* Body that bounces around the benchmark area */
+struct Body
+{
+	int handle;
+	bool isBox;
+	SDL_Rect box;
+	Circle circle;
+	int velX, velY;
+};
+
+/* Fill world with random boxes and circles spread over area of given side */
+static void createBodies(CollisionWorld& world, std::vector<Body>& bodies, int count, int side)
+{
+	for (int i = 0; i < count; ++i) {
+		Body body;
+		body.isBox = rand() % 2;
+		if (body.isBox) {
+			body.box = { rand() % side, rand() % side, 4 + rand() % 16, 4 + rand() % 16 };
+			body.handle = world.addBox(body.box);
+		}
+		else {
+			body.circle = { rand() % side, rand() % side, 2 + rand() % 8 };
+			body.handle = world.addCircle(body.circle);
+		}
+		body.velX = rand() % 7 - 3;
+		body.velY = rand() % 7 - 3;
+		bodies.push_back(body);
+	}
+}
+
+/* Move every body, turning around at the area edges */
+static void moveBodies(CollisionWorld& world, std::vector<Body>& bodies, int side)
+{
+	for (Body& body : bodies) {
+		int& x = body.isBox ? body.box.x : body.circle.x;
+		int& y = body.isBox ? body.box.y : body.circle.y;
+
+		x += body.velX;
+		y += body.velY;
+		if (x < 0 || x > side)
+			body.velX = -body.velX;
+		if (y < 0 || y > side)
+			body.velY = -body.velY;
+
+		if (body.isBox)
+			world.setBox(body.handle, body.box);
+		else
+			world.setCircle(body.handle, body.circle);
+	}
+}
+
+bool runBenchmark()
+{
+	const int FRAMES = 10;
+	const double frequency = static_cast<double>(SDL_GetPerformanceFrequency());
+
+	bool passed = true;
+	const int counts[] = { 1000, 10000 };
+	for (int count : counts) {
+		/* Keep density the same, about 40x40 pixels per body */
+		const int side = static_cast<int>(SDL_sqrt(static_cast<double>(count))) * 40;
+
+		srand(count);
+		CollisionWorld world;
+		std::vector<Body> bodies;
+		createBodies(world, bodies, count, side);
+
+		double broadMs = 0.0, allPairsMs = 0.0;
+		int mismatches = 0, pairCount = 0, candidates = 0;
+		std::vector<std::pair<int, int>> pairs, expected;
+		for (int frame = 0; frame < FRAMES; ++frame) {
+			moveBodies(world, bodies, side);
+
+			/* Sweep and prune */
+			Uint64 start = SDL_GetPerformanceCounter();
+			world.findPairs(pairs);
+			broadMs += (SDL_GetPerformanceCounter() - start) * 1000.0 / frequency;
+
+			/* Every pair through checkCollision */
+			expected.clear();
+			start = SDL_GetPerformanceCounter();
+			for (int i = 0; i < count; ++i) {
+				for (int j = i + 1; j < count; ++j) {
+					if (world.collide(i, j))
+						expected.push_back(std::make_pair(i, j));
+				}
+			}
+			allPairsMs += (SDL_GetPerformanceCounter() - start) * 1000.0 / frequency;
+
+			/* Both have to find the same pairs */
+			std::sort(pairs.begin(), pairs.end());
+			if (pairs != expected)
+				++mismatches;
+
+			/* Single collider queries have to agree with the pairs */
+			std::vector<bool> touching(count, false);
+			for (const auto& pair : expected)
+				touching[pair.first] = touching[pair.second] = true;
+			for (int i = 0; i < count; ++i) {
+				if (world.touches(i) != touching[i]) {
+					++mismatches;
+					break;
+				}
+			}
+			pairCount += static_cast<int>(pairs.size());
+			candidates += world.candidatePairs();
+		}
+
+		printf("%5d bodies: %9.3f ms/frame sweep and prune (%d candidates, %d pairs), %9.3f ms/frame all pairs, "
+			"%d mismatching frames\n", count, broadMs / FRAMES, candidates / FRAMES, pairCount / FRAMES,
+			allPairsMs / FRAMES, mismatches);
+		passed &= mismatches == 0;
+	}
+
+	/* Removing a collider twice mustn't hand its handle out twice */
+	CollisionWorld world;
+	SDL_Rect box = { 0, 0, 10, 10 };
+	int removed = world.addBox(box);
+	world.remove(removed);
+	world.remove(removed);
+	int first = world.addBox(box), second = world.addBox(box);
+	if (first == second) {
+		printf("Removed handle was given out twice!\n");
+		passed = false;
+	}
+
+	/* Moving unknown or removed colliders must leave the world alone */
+	SDL_Rect farAway = { 1000, 1000, 10, 10 };
+	Circle farCircle = { 1000, 1000, 5 };
+	world.remove(second);
+	world.setBox(second, farAway);
+	world.setBox(-1, farAway);
+	world.setCircle(world.size() + 5, farCircle);
+	int third = world.addBox(box);
+	if (!world.touches(first) || !world.touches(third)) {
+		printf("Moving a removed collider changed the world!\n");
+		passed = false;
+	}
+
+	return passed;
+}
+
+bool runCacheBenchmark()
+{
+	const int DOTS = 1000;
+	const int IMAGES = 8;
+	const int IMAGE_SIZE = 64;
+	const double frequency = static_cast<double>(SDL_GetPerformanceFrequency());
+	bool passed = true;
+
+	/* Every dot loading its own texture, like before */
+	std::vector<LTexture> separate(DOTS);
+	Uint64 start = SDL_GetPerformanceCounter();
+	for (LTexture& texture : separate)
+		passed &= texture.loadFromFile("Images/dot.bmp");
+	double separateMs = (SDL_GetPerformanceCounter() - start) * 1000.0 / frequency;
+	separate.clear();
+
+	/* Dots sharing one texture */
+	int misses = textureCache.misses();
+	std::vector<Dot> dots;
+	dots.reserve(DOTS);
+	start = SDL_GetPerformanceCounter();
+	for (int i = 0; i < DOTS; ++i)
+		dots.emplace_back(i % SCREEN_WIDTH, i % SCREEN_HEIGHT);
+	double cachedMs = (SDL_GetPerformanceCounter() - start) * 1000.0 / frequency;
+
+	printf("%d dots: %9.3f ms with %d textures loaded separately, %9.3f ms with %d texture from cache\n", DOTS,
+		separateMs, DOTS, cachedMs, textureCache.misses() - misses);
+	if (textureCache.misses() - misses != 1 || textureCache.size() != 1) {
+		printf("Dot image was loaded more than once!\n");
+		passed = false;
+	}
+
+	/* Same content under another path gets the same texture */
+	size_t size = 0;
+	void* data = SDL_LoadFile("Images/dot.bmp", &size);
+	SDL_RWops* copy = SDL_RWFromFile("bench_dot_copy.bmp", "wb");
+	if (data == NULL || copy == NULL || SDL_RWwrite(copy, data, 1, size) != size) {
+		printf("Unable to copy dot image! SDL_Error: %s\n", SDL_GetError());
+		passed = false;
+	}
+	if (copy != NULL)
+		SDL_RWclose(copy);
+	SDL_free(data);
+
+	LTextureCache::Handle original = textureCache.acquire("Images/dot.bmp");
+	if (textureCache.acquire("bench_dot_copy.bmp") != original) {
+		printf("Copy of dot image got its own texture!\n");
+		passed = false;
+	}
+
+	/* Differently colored images, only a few of them fitting into budget */
+	SDL_Surface* image = SDL_CreateRGBSurfaceWithFormat(0, IMAGE_SIZE, IMAGE_SIZE, 32, SDL_PIXELFORMAT_ARGB8888);
+	std::vector<std::string> paths;
+	for (int i = 0; i < IMAGES && image != NULL; ++i) {
+		SDL_FillRect(image, NULL, SDL_MapRGB(image->format, i * 32, 0xFF - i * 32, 0x80));
+		paths.push_back("bench_texture_" + std::to_string(i) + ".bmp");
+		if (SDL_SaveBMP(image, paths.back().c_str()) < 0) {
+			printf("Unable to save benchmark image! SDL_Error: %s\n", SDL_GetError());
+			passed = false;
+		}
+	}
+	SDL_FreeSurface(image);
+
+	if (passed) {
+		/* Room for dot and three unused images besides held one */
+		size_t imageBytes = static_cast<size_t>(IMAGE_SIZE) * IMAGE_SIZE * 4;
+		size_t budget = textureCache.bytes() + 4 * imageBytes;
+		textureCache.setBudget(budget);
+
+		LTextureCache::Handle held = textureCache.acquire(paths[0]);
+		for (int i = 1; i < IMAGES; ++i)
+			textureCache.acquire(paths[i]);
+
+		if (textureCache.bytes() > budget || textureCache.evictions() == 0) {
+			printf("Unused textures weren't evicted!\n");
+			passed = false;
+		}
+
+		/* Held and most recent images stay, least recent one is gone */
+		misses = textureCache.misses();
+		textureCache.acquire(paths[0]);
+		textureCache.acquire(paths[IMAGES - 1]);
+		if (textureCache.misses() != misses) {
+			printf("Held or recently used texture was evicted!\n");
+			passed = false;
+		}
+		textureCache.acquire(paths[1]);
+		if (textureCache.misses() != misses + 1) {
+			printf("Least recently used texture wasn't evicted!\n");
+			passed = false;
+		}
+
+		textureCache.setBudget(LTextureCache::DEFAULT_BUDGET);
+	}
+	textureCache.printStats();
+
+	/* Clean up */
+	remove("bench_dot_copy.bmp");
+	for (const std::string& path : paths)
+		remove(path.c_str());
+
+	printf("Texture cache benchmark %s\n", passed ? "passed" : "FAILED");
+	return passed;
+}
\ No newline at end of file
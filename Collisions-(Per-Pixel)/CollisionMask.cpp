@@ -0,0 +1,99 @@
+#include "CollisionMask.h"
+
+CollisionMask::CollisionMask() : m_width(0), m_height(0), m_words(0)
+{
+}
+
+bool CollisionMask::create(const LTexture& texture)
+{
+	if (texture.getPixels32() == nullptr) {
+		printf("No pixels loaded to build collision mask from!\n");
+		return false;
+	}
+
+	return create(texture.getPixels32(), static_cast<int>(texture.getPitch32()), texture.width(), texture.height(),
+		texture.getPixelFormat());
+}
+
+bool CollisionMask::create(const Uint32* pixels, int pitch32, int width, int height, const SDL_PixelFormat* format)
+{
+	m_width = width;
+	m_height = height;
+	m_words = (width + 63) / 64 + 1;
+	m_rows.assign(static_cast<size_t>(m_words) * height, 0);
+
+	/* Same color key the textures get */
+	Uint32 colorKey = SDL_MapRGB(format, 0, 0xFF, 0xFF);
+
+	for (int y = 0; y < height; ++y) {
+		const Uint32* row = &pixels[y * pitch32];
+		Uint64* words = &m_rows[static_cast<size_t>(y) * m_words];
+
+		for (int x = 0; x < width; ++x) {
+			/* Formats without alpha read as opaque */
+			Uint8 red, green, blue, alpha;
+			SDL_GetRGBA(row[x], format, &red, &green, &blue, &alpha);
+
+			if (alpha > 0 && (row[x] & ~format->Amask) != (colorKey & ~format->Amask))
+				words[x / 64] |= static_cast<Uint64>(1) << (x % 64);
+		}
+	}
+
+	return true;
+}
+
+bool CollisionMask::solid(int x, int y) const
+{
+	if (x < 0 || y < 0 || x >= m_width || y >= m_height)
+		return false;
+	return (m_rows[static_cast<size_t>(y) * m_words + x / 64] >> (x % 64)) & 1;
+}
+
+int CollisionMask::width() const
+{
+	return m_width;
+}
+
+int CollisionMask::height() const
+{
+	return m_height;
+}
+
+Uint64 CollisionMask::bits(int row, int x) const
+{
+	const Uint64* words = &m_rows[static_cast<size_t>(row) * m_words + x / 64];
+
+	/* Join the end of one word with the start of the next */
+	int shift = x % 64;
+	if (shift == 0)
+		return words[0];
+	return (words[0] >> shift) | (words[1] << (64 - shift));
+}
+
+
+bool checkCollision(const CollisionMask& a, int ax, int ay, const CollisionMask& b, int bx, int by)
+{
+	/* Overlap of both bounding boxes */
+	int left = SDL_max(ax, bx), right = SDL_min(ax + a.width(), bx + b.width());
+	int top = SDL_max(ay, by), bottom = SDL_min(ay + a.height(), by + b.height());
+
+	/* Boxes don't even touch */
+	if (left >= right || top >= bottom)
+		return false;
+
+	for (int y = top; y < bottom; ++y) {
+		/* Compare 64 pixels of both rows at once */
+		for (int x = left; x < right; x += 64) {
+			Uint64 common = a.bits(y - ay, x - ax) & b.bits(y - by, x - bx);
+
+			/* Drop bits past the overlap */
+			if (right - x < 64)
+				common &= (static_cast<Uint64>(1) << (right - x)) - 1;
+
+			if (common)
+				return true;
+		}
+	}
+
+	return false;
+}
\ No newline at end of file
@@ -0,0 +1,39 @@
+#pragma once
+#include "SDL2/SDL.h"
+
+#include "LTexture.h"
+
+#include <vector>
+
+/* Solid pixels of an image, each row packed into 64 bit words */
+class CollisionMask
+{
+public:
+	CollisionMask();
+
+	/* Build mask from loaded pixels of texture, transparent and color keyed pixels are empty */
+	bool create(const LTexture& texture);
+
+	/* Build mask from 32 bit pixels of given format */
+	bool create(const Uint32* pixels, int pitch32, int width, int height, const SDL_PixelFormat* format);
+
+	/* Check if pixel is solid */
+	bool solid(int x, int y) const;
+
+	/* Get dimensions */
+	int width() const;
+	int height() const;
+
+	/* Get mask bits of a row starting at given pixel, bit 0 being that pixel */
+	Uint64 bits(int row, int x) const;
+
+private:
+	int m_width, m_height;
+
+	/* Words per row, with a spare empty word so bits can always read the next one */
+	int m_words;
+	std::vector<Uint64> m_rows;
+};
+
+/* Check if two masks placed at given positions have a solid pixel in common */
+bool checkCollision(const CollisionMask& a, int ax, int ay, const CollisionMask& b, int bx, int by);
\ No newline at end of file
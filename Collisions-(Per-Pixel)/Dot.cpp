@@ -2,49 +2,15 @@
 
 Dot::Dot(int x, int y) : m_posX(x), m_posY(y), m_velX(0), m_velY(0)
 {
-	/* Create the necessary SDL_Rects */
-	m_colliders.resize(11);
-
-	/* Initialize the collision boxes' width and height */
-	m_colliders[0].w = 6;
-	m_colliders[0].h = 1;
-
-	m_colliders[1].w = 10;
-	m_colliders[1].h = 1;
-
-	m_colliders[2].w = 14;
-	m_colliders[2].h = 1;
-
-	m_colliders[3].w = 16;
-	m_colliders[3].h = 2;
-
-	m_colliders[4].w = 18;
-	m_colliders[4].h = 2;
-
-	m_colliders[5].w = 20;
-	m_colliders[5].h = 6;
-
-	m_colliders[6].w = 18;
-	m_colliders[6].h = 2;
-
-	m_colliders[7].w = 16;
-	m_colliders[7].h = 2;
-
-	m_colliders[8].w = 14;
-	m_colliders[8].h = 1;
-
-	m_colliders[9].w = 10;
-	m_colliders[9].h = 1;
-
-	m_colliders[10].w = 6;
-	m_colliders[10].h = 1;
-	
-	/* Initialize colliders relative to position */
-	shiftColliders();
-
-	/* Load texture */
-	if (!texture.loadFromFile("Images/dot.bmp"))
-		printf("Couldn't load dot texture!\n");
+	/* Load pixels, build the mask from them and only then make the texture */
+	if (!texture.loadPixelsFromFile("Images/dot.bmp"))
+		printf("Couldn't load dot pixels!\n");
+	else {
+		if (!m_mask.create(texture))
+			printf("Couldn't create dot collision mask!\n");
+		if (!texture.loadFromPixels())
+			printf("Couldn't load dot texture!\n");
+	}
 }
 
 Dot::~Dot()
@@ -92,28 +58,24 @@ void Dot::handleEvent(SDL_Event& event)
 	}
 }
 
-void Dot::move(const std::vector<SDL_Rect>& otherColliders)
+void Dot::move(const Dot& other)
 {
 	/* Move the dot left or right */
 	m_posX += m_velX;
-	shiftColliders();
 
 	/* If the dot is too far to the left or right */
-	if ((m_posX < 0) || (m_posX + DOT_WIDTH > SCREEN_WIDTH) || checkCollision(m_colliders, otherColliders)) {
+	if ((m_posX < 0) || (m_posX + DOT_WIDTH > SCREEN_WIDTH) || collides(other)) {
 		/* Move back */
 		m_posX -= m_velX;
-		shiftColliders();
 	}
 
 	/* Move the dot up or down */
 	m_posY += m_velY;
-	shiftColliders();
 
 	/* If the dot is too far up or down */
-	if ((m_posY < 0) || (m_posY + DOT_HEIGHT > SCREEN_HEIGHT) || checkCollision(m_colliders, otherColliders)) {
+	if ((m_posY < 0) || (m_posY + DOT_HEIGHT > SCREEN_HEIGHT) || collides(other)) {
 		/* Move back */
 		m_posY -= m_velY;
-		shiftColliders();
 	}
 }
 
@@ -123,27 +85,14 @@ void Dot::render()
 	texture.render(m_posX, m_posY);
 }
 
-void Dot::shiftColliders()
+bool Dot::collides(const Dot& other) const
 {
-	/* The row offset */
-	int r = 0;
-
-	/* Go through the dot's collision boxes */
-	for (int set = 0; set < m_colliders.size(); set++) {
-		/* Center the collision box */
-		m_colliders[set].x = m_posX + (DOT_WIDTH - m_colliders[set].w) / 2;
-
-		/* Set the collision box at its row offset */
-		m_colliders[set].y = m_posY + r;
-
-		/* Move the row offset down the height of collision box */
-		r += m_colliders[set].h;
-	}
+	return checkCollision(m_mask, m_posX, m_posY, other.m_mask, other.m_posX, other.m_posY);
 }
 
-std::vector<SDL_Rect>& Dot::getColliders()
+const CollisionMask& Dot::getMask() const
 {
-	return m_colliders;
+	return m_mask;
 }
 
 
@@ -2,6 +2,7 @@
 #include "SDL2/SDL.h"
 
 #include "LTexture.h"
+#include "CollisionMask.h"
 
 #include <vector>
 
@@ -10,7 +11,7 @@
 extern const int SCREEN_WIDTH;
 extern const int SCREEN_HEIGHT;
 
-/* Box collision detector */
+/* Box collision detector, tests every box of one set against every box of the other */
 bool checkCollision(const std::vector<SDL_Rect>& a, const std::vector<SDL_Rect>& b);
 
 
@@ -32,17 +33,16 @@ public:
 	void handleEvent(SDL_Event& event);
 
 	/* Move */
-	void move(const std::vector<SDL_Rect>& otherColliders);
+	void move(const Dot& other);
 
 	/* Show the dot on screen */
 	void render();
 
-	/* Get dot's collision boxes */
-	std::vector<SDL_Rect>& getColliders();
+	/* Check if solid pixels of the dots overlap */
+	bool collides(const Dot& other) const;
 
-private:
-	/* Move the collision boxes relative to the dot's offset */
-	void shiftColliders();
+	/* Get dot's collision mask */
+	const CollisionMask& getMask() const;
 
 private:
 	/* X and Y offsets */
@@ -51,7 +51,7 @@ private:
 	int m_velX, m_velY;
 	/* Texture */
 	LTexture texture;
-	/* Dot's collision box */
-	std::vector<SDL_Rect> m_colliders;
+	/* Dot's solid pixels */
+	CollisionMask m_mask;
 };
 
@@ -7,6 +7,7 @@
 #include <stdio.h>
 #include <string>
 #include <sstream>
+#include <vector>
 
 
 /* Initialize the program */
@@ -16,6 +17,9 @@ bool loadMedia();
 /* Clean up */
 void close();
 
+/* Check masks against single pixels and time them against the rect stack, false if a check fails */
+bool runBenchmark();
+
 
 /* Screen constants */
 const int SCREEN_WIDTH = 640;
@@ -28,6 +32,14 @@ SDL_Renderer* renderer = nullptr;
 
 int main(int argc, char* args[])
 {
+	/* Run headless benchmark instead of the demo */
+	bool benchmark = (argc > 1) && (std::string(args[1]) == "--bench");
+	if (benchmark) {
+		SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+		SDL_SetHint(SDL_HINT_RENDER_DRIVER, "software");
+		SDL_SetHint(SDL_HINT_RENDER_VSYNC, "0");
+	}
+
 	/* Initialize */
 	if (!init()) {
 		printf("Failed to initialize!\n");
@@ -42,6 +54,12 @@ int main(int argc, char* args[])
 		return -1;
 	}
 
+	if (benchmark) {
+		bool passed = runBenchmark();
+		close();
+		return passed ? 0 : -1;
+	}
+
 	bool quit = false;
 	SDL_Event e;
 
@@ -63,7 +81,7 @@ int main(int argc, char* args[])
 		}
 
 		/* Move the dot */
-		dot.move(otherDot.getColliders());
+		dot.move(otherDot);
 
 
 		/* Clear screen */
@@ -144,4 +162,124 @@ void close()
 	/* Quit the SDL library */
 	IMG_Quit();
 	SDL_Quit();
-} 
\ No newline at end of file
+} 
+
+/* Dot approximated with rows of boxes, the way the dot used to collide */
+static void createRectStack(std::vector<SDL_Rect>& boxes, int x, int y)
+{
+	const int widths[] = { 6, 10, 14, 16, 18, 20, 18, 16, 14, 10, 6 };
+	const int heights[] = { 1, 1, 1, 2, 2, 6, 2, 2, 1, 1, 1 };
+
+	boxes.resize(11);
+	int row = 0;
+	for (int i = 0; i < 11; ++i) {
+		boxes[i] = { x + (Dot::DOT_WIDTH - widths[i]) / 2, y + row, widths[i], heights[i] };
+		row += heights[i];
+	}
+}
+
+/* Test every pixel pair of the masks */
+static bool checkPixels(const CollisionMask& a, int ax, int ay, const CollisionMask& b, int bx, int by)
+{
+	for (int y = 0; y < a.height(); ++y) {
+		for (int x = 0; x < a.width(); ++x) {
+			if (a.solid(x, y) && b.solid(x + ax - bx, y + ay - by))
+				return true;
+		}
+	}
+
+	return false;
+}
+
+/* Irregular mask wider than one word */
+static void createBlobMask(CollisionMask& mask, int width, int height)
+{
+	SDL_PixelFormat* format = SDL_AllocFormat(SDL_PIXELFORMAT_ARGB8888);
+	std::vector<Uint32> pixels(static_cast<size_t>(width) * height);
+	for (int y = 0; y < height; ++y) {
+		for (int x = 0; x < width; ++x) {
+			/* Ring with noisy holes, transparent outside */
+			int dx = x - width / 2, dy = y - height / 2;
+			int distance = dx * dx * 4 / width + dy * dy * 4 / height;
+			bool solid = distance < width / 2 && distance > width / 8 && rand() % 5;
+			pixels[y * width + x] = solid ? SDL_MapRGBA(format, 0x80, 0x40, 0x20, 0xFF) : 0;
+		}
+	}
+
+	mask.create(pixels.data(), width, width, height, format);
+	SDL_FreeFormat(format);
+}
+
+bool runBenchmark()
+{
+	const int ROUNDS = 200;
+	const double frequency = static_cast<double>(SDL_GetPerformanceFrequency());
+
+	bool passed = true;
+
+	/* Dot mask at every offset where bounding boxes may touch */
+	Dot dot(0, 0);
+	const CollisionMask& mask = dot.getMask();
+	std::vector<SDL_Rect> stack, otherStack;
+	createRectStack(stack, 0, 0);
+
+	int tests = 0, mismatches = 0, stackMismatches = 0;
+	for (int y = -mask.height(); y <= mask.height(); ++y) {
+		for (int x = -mask.width(); x <= mask.width(); ++x) {
+			bool pixels = checkPixels(mask, 0, 0, mask, x, y);
+			createRectStack(otherStack, x, y);
+
+			mismatches += checkCollision(mask, 0, 0, mask, x, y) != pixels;
+			stackMismatches += checkCollision(stack, otherStack) != pixels;
+			++tests;
+		}
+	}
+	printf("dot %dx%d: %d offsets, %d bitmask mismatches, %d rect stack mismatches against pixels\n",
+		mask.width(), mask.height(), tests, mismatches, stackMismatches);
+	passed &= mismatches == 0;
+
+	/* Cost over the same offsets */
+	double ns[2];
+	int hits = 0;
+	for (int rects = 0; rects < 2; ++rects) {
+		Uint64 start = SDL_GetPerformanceCounter();
+		for (int round = 0; round < ROUNDS; ++round) {
+			for (int y = -mask.height(); y <= mask.height(); ++y) {
+				for (int x = -mask.width(); x <= mask.width(); ++x) {
+					if (rects) {
+						createRectStack(otherStack, x, y);
+						hits += checkCollision(stack, otherStack);
+					}
+					else
+						hits += checkCollision(mask, 0, 0, mask, x, y);
+				}
+			}
+		}
+		ns[rects] = (SDL_GetPerformanceCounter() - start) * 1000000000.0 / frequency / (ROUNDS * tests);
+	}
+	printf("dot test: %8.1f ns bitmask, %8.1f ns rect stack (%d hits)\n", ns[0], ns[1], hits);
+
+	/* Masks spanning several words at random offsets */
+	srand(0);
+	CollisionMask blob, otherBlob;
+	createBlobMask(blob, 200, 150);
+	createBlobMask(otherBlob, 130, 90);
+
+	mismatches = 0;
+	const int BLOB_TESTS = 2000;
+	for (int i = 0; i < BLOB_TESTS; ++i) {
+		int x = rand() % 360 - 140, y = rand() % 260 - 100;
+		mismatches += checkCollision(blob, 0, 0, otherBlob, x, y) != checkPixels(blob, 0, 0, otherBlob, x, y);
+	}
+
+	Uint64 start = SDL_GetPerformanceCounter();
+	for (int i = 0; i < BLOB_TESTS; ++i)
+		hits += checkCollision(blob, 0, 0, otherBlob, i % 360 - 140, i % 260 - 100);
+	double blobNs = (SDL_GetPerformanceCounter() - start) * 1000000000.0 / frequency / BLOB_TESTS;
+
+	printf("200x150 against 130x90: %d offsets, %d bitmask mismatches, %8.1f ns/test\n", BLOB_TESTS, mismatches,
+		blobNs);
+	passed &= mismatches == 0;
+
+	return passed;
+}
\ No newline at end of file
@@ -0,0 +1,66 @@
+#include "Collision.h"
+
+
+bool checkCollision(const SDL_Rect& a, const SDL_Rect& b)
+{
+	/* If any of the sides from A are outside of B */
+	if ((a.y + a.h <= b.y) || (a.y >= b.y + b.h) || (a.x + a.w <= b.x) || (a.x >= b.x + b.w))
+		return false;
+
+	/* If none of the sides from A are outside of B */
+	return true;
+}
+
+bool checkCollision(const Circle& a, const Circle& b)
+{
+	/* Calculate total radius squared */
+	int totalRadiusSquared = a.r + b.r;
+	totalRadiusSquared *= totalRadiusSquared;
+
+	/* If the distance between the centers of circles is less than the sum of their radii */
+	if (distanceSquared(a.x, a.y, b.x, b.y) < totalRadiusSquared) {
+		/* The circles have collided */
+		return true;
+	}
+
+	/* No collisions */
+	return false;
+}
+
+bool checkCollision(const Circle& a, const SDL_Rect& b)
+{
+	/* Closes point on collision box */
+	int cX, cY;
+
+	/* Find closest x offset */
+	if (a.x < b.x)
+		cX = b.x;
+	else if (a.x > b.x + b.w)
+		cX = b.x + b.w;
+	else
+		cX = a.x;
+
+	/* Find closest y offset */
+	if (a.y < b.y)
+		cY = b.y;
+	else if (a.y > b.y + b.h)
+		cY = b.y + b.h;
+	else
+		cY = a.y;
+
+	/* If the closest point is inside the circle */
+	if (distanceSquared(a.x, a.y, cX, cY) < (a.r * a.r)) {
+		/* This circle and box have collided */
+		return true;
+	}
+	
+	/* No collision */
+	return false;
+}
+
+double distanceSquared(int x1, int y1, int x2, int y2)
+{
+	int deltaX = x2 - x1;
+	int deltaY = y2 - y1;
+	return (deltaX * deltaX) + (deltaY * deltaY);
+}
\ No newline at end of file
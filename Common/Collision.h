@@ -0,0 +1,17 @@
+#pragma once
+#include "SDL2/SDL.h"
+
+/* Circle struct */
+struct Circle {
+	int x, y;
+	int r;
+};
+
+/* Box-Box collision detector */
+bool checkCollision(const SDL_Rect& a, const SDL_Rect& b);
+/* Circle-Circle collision detector */
+bool checkCollision(const Circle& a, const Circle& b);
+/* Circle-Box collision detector */
+bool checkCollision(const Circle& a, const SDL_Rect& b);
+/* Calculate distance squared between two points */
+double distanceSquared(int x1, int y1, int x2, int y2);
\ No newline at end of file
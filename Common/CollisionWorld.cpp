@@ -0,0 +1,202 @@
+#include "CollisionWorld.h"
+
+#include <algorithm>
+
+CollisionWorld::CollisionWorld() : m_sorted(true), m_maxWidth(0), m_candidates(0)
+{
+}
+
+int CollisionWorld::addBox(const SDL_Rect& box)
+{
+	Collider collider;
+	collider.shape = ColliderShape::BOX;
+	collider.box = box;
+	collider.circle = { 0, 0, 0 };
+	return add(collider);
+}
+
+int CollisionWorld::addCircle(const Circle& circle)
+{
+	Collider collider;
+	collider.shape = ColliderShape::CIRCLE;
+	collider.box = { 0, 0, 0, 0 };
+	collider.circle = circle;
+	return add(collider);
+}
+
+int CollisionWorld::add(const Collider& collider)
+{
+	/* Reuse handle of removed collider */
+	int handle;
+	if (!m_freeHandles.empty()) {
+		handle = m_freeHandles.back();
+		m_freeHandles.pop_back();
+		m_colliders[handle] = collider;
+	}
+	else {
+		handle = static_cast<int>(m_colliders.size());
+		m_colliders.push_back(collider);
+	}
+
+	m_colliders[handle].active = true;
+	setBounds(m_colliders[handle]);
+
+	m_order.push_back(handle);
+	m_sorted = false;
+	return handle;
+}
+
+void CollisionWorld::remove(int handle)
+{
+	/* Unknown or already removed handle, freeing it again would hand it out twice */
+	if (!isActive(handle))
+		return;
+
+	m_colliders[handle].active = false;
+	m_order.erase(std::find(m_order.begin(), m_order.end(), handle));
+	m_freeHandles.push_back(handle);
+}
+
+void CollisionWorld::setBox(int handle, const SDL_Rect& box)
+{
+	/* Bounds of a freed slot would come back with its next collider */
+	if (!isActive(handle))
+		return;
+
+	m_colliders[handle].box = box;
+	setBounds(m_colliders[handle]);
+	m_sorted = false;
+}
+
+void CollisionWorld::setCircle(int handle, const Circle& circle)
+{
+	if (!isActive(handle))
+		return;
+
+	m_colliders[handle].circle = circle;
+	setBounds(m_colliders[handle]);
+	m_sorted = false;
+}
+
+bool CollisionWorld::isActive(int handle) const
+{
+	return handle >= 0 && handle < static_cast<int>(m_colliders.size()) && m_colliders[handle].active;
+}
+
+void CollisionWorld::setBounds(Collider& collider)
+{
+	if (collider.shape == ColliderShape::BOX) {
+		collider.minX = collider.box.x;
+		collider.maxX = collider.box.x + collider.box.w;
+		collider.minY = collider.box.y;
+		collider.maxY = collider.box.y + collider.box.h;
+	}
+	else {
+		collider.minX = collider.circle.x - collider.circle.r;
+		collider.maxX = collider.circle.x + collider.circle.r;
+		collider.minY = collider.circle.y - collider.circle.r;
+		collider.maxY = collider.circle.y + collider.circle.r;
+	}
+
+	/* Widest bounds only grow, which keeps queries correct */
+	m_maxWidth = SDL_max(m_maxWidth, collider.maxX - collider.minX);
+}
+
+void CollisionWorld::sort()
+{
+	if (m_sorted)
+		return;
+
+	/* Insertion sort, colliders only move a bit between frames */
+	for (size_t i = 1; i < m_order.size(); ++i) {
+		int handle = m_order[i];
+		int minX = m_colliders[handle].minX;
+
+		size_t j = i;
+		while (j > 0 && m_colliders[m_order[j - 1]].minX > minX) {
+			m_order[j] = m_order[j - 1];
+			--j;
+		}
+		m_order[j] = handle;
+	}
+
+	m_sorted = true;
+}
+
+void CollisionWorld::findPairs(std::vector<std::pair<int, int>>& pairs)
+{
+	pairs.clear();
+	m_candidates = 0;
+	sort();
+
+	/* Sweep along X, colliders overlap only if each starts before the other ends */
+	for (size_t i = 0; i < m_order.size(); ++i) {
+		const Collider& a = m_colliders[m_order[i]];
+
+		for (size_t j = i + 1; j < m_order.size(); ++j) {
+			const Collider& b = m_colliders[m_order[j]];
+			if (b.minX >= a.maxX)
+				break;
+
+			/* Prune on Y before testing the shapes */
+			if (b.minY >= a.maxY || a.minY >= b.maxY)
+				continue;
+
+			++m_candidates;
+			if (collide(m_order[i], m_order[j]))
+				pairs.push_back(std::make_pair(SDL_min(m_order[i], m_order[j]), SDL_max(m_order[i], m_order[j])));
+		}
+	}
+}
+
+bool CollisionWorld::touches(int handle)
+{
+	sort();
+
+	const Collider& a = m_colliders[handle];
+
+	/* First collider that could reach the box, none starts further left than the widest one */
+	auto first = std::lower_bound(m_order.begin(), m_order.end(), a.minX - m_maxWidth,
+		[this](int other, int minX) { return m_colliders[other].minX < minX; });
+
+	for (auto other = first; other != m_order.end(); ++other) {
+		const Collider& b = m_colliders[*other];
+		if (b.minX >= a.maxX)
+			break;
+
+		if (*other == handle || b.maxX <= a.minX || b.minY >= a.maxY || a.minY >= b.maxY)
+			continue;
+
+		if (collide(handle, *other))
+			return true;
+	}
+
+	return false;
+}
+
+bool CollisionWorld::collide(int first, int second) const
+{
+	const Collider& a = m_colliders[first];
+	const Collider& b = m_colliders[second];
+
+	/* Narrow phase by the shapes of both */
+	if (a.shape == ColliderShape::BOX) {
+		if (b.shape == ColliderShape::BOX)
+			return checkCollision(a.box, b.box);
+		return checkCollision(b.circle, a.box);
+	}
+
+	if (b.shape == ColliderShape::BOX)
+		return checkCollision(a.circle, b.box);
+	return checkCollision(a.circle, b.circle);
+}
+
+int CollisionWorld::size() const
+{
+	return static_cast<int>(m_order.size());
+}
+
+int CollisionWorld::candidatePairs() const
+{
+	return m_candidates;
+}
\ No newline at end of file
@@ -0,0 +1,84 @@
+#pragma once
+#include "SDL2/SDL.h"
+
+#include "Collision.h"
+
+#include <utility>
+#include <vector>
+
+/* Shapes a collider can have */
+enum class ColliderShape
+{
+	BOX,
+	CIRCLE
+};
+
+/* Set of boxes and circles, sweep and prune finds the pairs that checkCollision gets to test */
+class CollisionWorld
+{
+public:
+	CollisionWorld();
+
+	/* Register collider, returns its handle */
+	int addBox(const SDL_Rect& box);
+	int addCircle(const Circle& circle);
+
+	/* Unregister collider, its handle may be given to a new one */
+	void remove(int handle);
+
+	/* Move collider to new place, unknown or removed handles are ignored */
+	void setBox(int handle, const SDL_Rect& box);
+	void setCircle(int handle, const Circle& circle);
+
+	/* Find every pair of colliding colliders, lower handle first */
+	void findPairs(std::vector<std::pair<int, int>>& pairs);
+
+	/* Check if collider touches any other one */
+	bool touches(int handle);
+
+	/* Check if two colliders collide, skipping the broad phase */
+	bool collide(int first, int second) const;
+
+	/* Get amount of colliders */
+	int size() const;
+	/* Get amount of pairs the broad phase let through during last findPairs */
+	int candidatePairs() const;
+
+private:
+	/* Registered collider with its bounds */
+	struct Collider
+	{
+		ColliderShape shape;
+		SDL_Rect box;
+		Circle circle;
+
+		/* Bounding box */
+		int minX, maxX, minY, maxY;
+
+		bool active;
+	};
+
+	/* Add collider to the sweep order */
+	int add(const Collider& collider);
+
+	/* Check if handle belongs to a registered collider */
+	bool isActive(int handle) const;
+
+	/* Update bounds after the shape changed */
+	void setBounds(Collider& collider);
+
+	/* Restore order by left edge, nearly sorted after small moves */
+	void sort();
+
+	std::vector<Collider> m_colliders;
+	std::vector<int> m_freeHandles;
+
+	/* Active handles ordered by left edge of their bounds */
+	std::vector<int> m_order;
+	bool m_sorted;
+
+	/* Widest bounds, limits how far back queries have to look */
+	int m_maxWidth;
+
+	int m_candidates;
+};
\ No newline at end of file
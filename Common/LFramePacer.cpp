@@ -0,0 +1,143 @@
+#include "LFramePacer.h"
+
+#include <stdio.h>
+
+
+LFramePacer::LFramePacer(int framesPerSecond, Mode mode, Uint32 spinMicroseconds) : m_mode(mode),
+	m_deadline(0), m_lastFrame(0)
+{
+	m_frequency = SDL_GetPerformanceFrequency();
+	m_period = m_frequency / (framesPerSecond > 0 ? framesPerSecond : 60);
+	m_spin = m_frequency * spinMicroseconds / 1000000;
+
+	resetStats();
+}
+
+void LFramePacer::start()
+{
+	m_lastFrame = SDL_GetPerformanceCounter();
+	m_deadline = m_lastFrame + m_period;
+}
+
+double LFramePacer::wait()
+{
+	/* Started by first frame */
+	if (m_deadline == 0)
+		start();
+
+	Uint64 now = SDL_GetPerformanceCounter();
+	if (now < m_deadline) {
+		Uint64 remaining = m_deadline - now;
+
+		if (m_mode == Mode::SLEEP)
+			SDL_Delay(static_cast<Uint32>(remaining * 1000 / m_frequency));
+		else {
+			/* Sleep coarse, whatever of it the OS oversleeps has to fit into spin window */
+			if (remaining > m_spin)
+				SDL_Delay(static_cast<Uint32>((remaining - m_spin) * 1000 / m_frequency));
+
+			/* Spin the rest */
+			while (SDL_GetPerformanceCounter() < m_deadline) {
+			}
+		}
+	}
+
+	now = SDL_GetPerformanceCounter();
+	Uint64 frame = now - m_lastFrame;
+	record(frame);
+	m_lastFrame = now;
+
+	/* Next deadline follows the last one so error doesn't add up, unless the frame ran a whole period late */
+	m_deadline += m_period;
+	if (m_deadline <= now)
+		m_deadline = now + m_period;
+
+	return static_cast<double>(frame) / m_frequency;
+}
+
+void LFramePacer::setMode(Mode mode)
+{
+	m_mode = mode;
+}
+
+LFramePacer::Mode LFramePacer::getMode() const
+{
+	return m_mode;
+}
+
+double LFramePacer::getTargetSeconds() const
+{
+	return static_cast<double>(m_period) / m_frequency;
+}
+
+int LFramePacer::getFrames() const
+{
+	return m_frames;
+}
+
+double LFramePacer::getMeanErrorSeconds() const
+{
+	return m_frames > 0 ? m_errorSum / m_frames : 0.0;
+}
+
+double LFramePacer::getWorstErrorSeconds() const
+{
+	return m_worstError;
+}
+
+int LFramePacer::getBin(int bin) const
+{
+	return bin >= 0 && bin < HISTOGRAM_BINS ? m_histogram[bin] : 0;
+}
+
+void LFramePacer::resetStats()
+{
+	m_frames = 0;
+	m_errorSum = m_worstError = 0.0;
+	for (int bin = 0; bin < HISTOGRAM_BINS; ++bin)
+		m_histogram[bin] = 0;
+}
+
+void LFramePacer::printHistogram() const
+{
+	printf("%d frames against %.3f ms target, %.4f ms mean error, %.4f ms worst\n", m_frames,
+		getTargetSeconds() * 1000.0, getMeanErrorSeconds() * 1000.0, m_worstError * 1000.0);
+
+	/* Scale bars to the fullest bin */
+	int fullest = 1;
+	for (int bin = 0; bin < HISTOGRAM_BINS; ++bin)
+		fullest = SDL_max(fullest, m_histogram[bin]);
+
+	for (int bin = 0; bin < HISTOGRAM_BINS; ++bin) {
+		/* Skip empty bins */
+		if (m_histogram[bin] == 0)
+			continue;
+
+		int from = (bin - BINS_EARLY) * static_cast<int>(BIN_MICROSECONDS);
+		char bar[41];
+		int length = m_histogram[bin] * 40 / fullest;
+		SDL_memset(bar, '#', length);
+		bar[length] = '\0';
+
+		if (bin == 0)
+			printf("        < %+6.2f ms %6d %s\n", (from + static_cast<int>(BIN_MICROSECONDS)) / 1000.0, m_histogram[bin], bar);
+		else if (bin == HISTOGRAM_BINS - 1)
+			printf("       >= %+6.2f ms %6d %s\n", from / 1000.0, m_histogram[bin], bar);
+		else
+			printf("%+6.2f to %+6.2f ms %6d %s\n", from / 1000.0, (from + static_cast<int>(BIN_MICROSECONDS)) / 1000.0,
+				m_histogram[bin], bar);
+	}
+}
+
+void LFramePacer::record(Uint64 counts)
+{
+	/* Signed distance from target, in seconds and in bins */
+	double error = (static_cast<double>(counts) - static_cast<double>(m_period)) / m_frequency;
+	int bin = static_cast<int>(SDL_floor(error * 1000000.0 / BIN_MICROSECONDS)) + BINS_EARLY;
+	bin = SDL_clamp(bin, 0, HISTOGRAM_BINS - 1);
+	++m_histogram[bin];
+
+	++m_frames;
+	m_errorSum += SDL_fabs(error);
+	m_worstError = SDL_max(m_worstError, SDL_fabs(error));
+}
\ No newline at end of file
@@ -0,0 +1,72 @@
+#pragma once
+#include "SDL2/SDL.h"
+
+/* Holds frames to a steady rate, keeping track of how close to it they actually were */
+class LFramePacer
+{
+public:
+	/* How frames are waited out */
+	enum class Mode
+	{
+		/* SDL_Delay whole milliseconds, early by the fraction and late by however long the OS oversleeps */
+		SLEEP,
+		/* SDL_Delay most of the way, then spin on the performance counter up to the deadline */
+		PRECISE
+	};
+
+	/* Time before deadline spent spinning instead of sleeping, covers OS sleep overshoot */
+	static const Uint32 DEFAULT_SPIN_MICROSECONDS = 2000;
+
+	/* Histogram of achieved minus target frame time, outer bins catch everything beyond them */
+	static const int HISTOGRAM_BINS = 32;
+	static const Uint32 BIN_MICROSECONDS = 100;
+	static const int BINS_EARLY = 8;
+
+	LFramePacer(int framesPerSecond = 60, Mode mode = Mode::PRECISE, Uint32 spinMicroseconds = DEFAULT_SPIN_MICROSECONDS);
+
+	/* First frame starts now */
+	void start();
+
+	/* Wait until current frame's deadline, get how long the frame took in seconds */
+	double wait();
+
+	/* Set how frames are waited out */
+	void setMode(Mode mode);
+	Mode getMode() const;
+
+	/* Get target frame time */
+	double getTargetSeconds() const;
+
+	/* Get amount of frames measured */
+	int getFrames() const;
+	/* Get mean and worst distance of frame time from target */
+	double getMeanErrorSeconds() const;
+	double getWorstErrorSeconds() const;
+	/* Get amount of frames in histogram bin */
+	int getBin(int bin) const;
+
+	/* Forget frames measured so far */
+	void resetStats();
+
+	/* Print frame time histogram */
+	void printHistogram() const;
+
+private:
+	/* Add frame time to statistics */
+	void record(Uint64 counts);
+
+	Mode m_mode;
+
+	/* Counter frequency, frame time and spin window in counter counts */
+	Uint64 m_frequency;
+	Uint64 m_period;
+	Uint64 m_spin;
+
+	/* Counter at which current frame should end and at which last one did */
+	Uint64 m_deadline;
+	Uint64 m_lastFrame;
+
+	int m_frames;
+	double m_errorSum, m_worstError;
+	int m_histogram[HISTOGRAM_BINS];
+};
\ No newline at end of file
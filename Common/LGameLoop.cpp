@@ -0,0 +1,91 @@
+#include "LGameLoop.h"
+
+
+LGameLoop::LGameLoop(int updatesPerSecond, int maxUpdates) : m_timer(LTimer::Resolution::HIGH),
+	m_maxUpdates(maxUpdates > 0 ? maxUpdates : 1), m_accumulator(0), m_updates(0), m_frames(0),
+	m_cappedFrames(0), m_dropped(0)
+{
+	/* Round to nearest nanosecond */
+	Uint64 rate = updatesPerSecond > 0 ? updatesPerSecond : 60;
+	m_step = (1000000000ull + rate / 2) / rate;
+}
+
+void LGameLoop::start()
+{
+	m_accumulator = 0;
+	m_updates = m_frames = 0;
+	m_cappedFrames = m_dropped = 0;
+
+	m_timer.start();
+}
+
+int LGameLoop::beginFrame()
+{
+	/* First frame starts the timer, nothing happened yet */
+	if (!m_timer.isStarted()) {
+		start();
+		return advance(0);
+	}
+
+	/* Restart reads the clock once, so no time falls between frames */
+	double seconds = m_timer.restart();
+	return advance(static_cast<Uint64>(seconds * 1000000000.0 + 0.5));
+}
+
+int LGameLoop::advance(Uint64 frameNanoseconds)
+{
+	++m_frames;
+	m_accumulator += frameNanoseconds;
+
+	Uint64 updates = m_accumulator / m_step;
+
+	/* Spiral of death guard, updates that take longer than they simulate would only pile up more */
+	if (updates > static_cast<Uint64>(m_maxUpdates)) {
+		Uint64 dropped = (updates - m_maxUpdates) * m_step;
+		m_accumulator -= dropped;
+		m_dropped += dropped;
+		++m_cappedFrames;
+		updates = m_maxUpdates;
+	}
+
+	/* Whatever is left is less than one step, it carries over to the next frame */
+	m_accumulator -= updates * m_step;
+	m_updates += updates;
+
+	return static_cast<int>(updates);
+}
+
+float LGameLoop::getAlpha() const
+{
+	return static_cast<float>(static_cast<double>(m_accumulator) / m_step);
+}
+
+float LGameLoop::getStep() const
+{
+	return static_cast<float>(m_step / 1000000000.0);
+}
+
+Uint64 LGameLoop::getStepNanoseconds() const
+{
+	return m_step;
+}
+
+Uint64 LGameLoop::getUpdates() const
+{
+	return m_updates;
+}
+
+Uint64 LGameLoop::getFrames() const
+{
+	return m_frames;
+}
+
+Uint64 LGameLoop::getCappedFrames() const
+{
+	return m_cappedFrames;
+}
+
+Uint64 LGameLoop::getDroppedNanoseconds() const
+{
+	return m_dropped;
+}
\ No newline at end of file
@@ -0,0 +1,51 @@
+#pragma once
+#include "SDL2/SDL.h"
+
+#include "LTimer.h"
+
+/* Runs the simulation at a fixed rate, however often frames get rendered */
+class LGameLoop
+{
+public:
+	/* Updates run for one frame at most, before the loop stops trying to catch up */
+	static const int DEFAULT_MAX_UPDATES = 5;
+
+	LGameLoop(int updatesPerSecond = 60, int maxUpdates = DEFAULT_MAX_UPDATES);
+
+	/* Start measuring frame time from now, dropping time left over from before */
+	void start();
+
+	/* Measure time since last frame, get how many updates to run for it */
+	int beginFrame();
+	/* Add frame time in nanoseconds, get how many updates to run for it */
+	int advance(Uint64 frameNanoseconds);
+
+	/* Get how far rendering is between the last two updates, from 0 to 1 */
+	float getAlpha() const;
+
+	/* Get time every update simulates */
+	float getStep() const;
+	Uint64 getStepNanoseconds() const;
+
+	/* Get amount of updates run and frames advanced since start */
+	Uint64 getUpdates() const;
+	Uint64 getFrames() const;
+
+	/* Get amount of frames which hit the update cap, and time they dropped */
+	Uint64 getCappedFrames() const;
+	Uint64 getDroppedNanoseconds() const;
+
+private:
+	/* Measures frame time */
+	LTimer m_timer;
+
+	/* Time of one update and the cap on updates per frame */
+	Uint64 m_step;
+	int m_maxUpdates;
+
+	/* Time not simulated yet, kept in whole nanoseconds so splitting it into frames never changes the updates */
+	Uint64 m_accumulator;
+
+	Uint64 m_updates, m_frames;
+	Uint64 m_cappedFrames, m_dropped;
+};
\ No newline at end of file
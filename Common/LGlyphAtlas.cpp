@@ -0,0 +1,298 @@
+#include "LGlyphAtlas.h"
+
+#include <stdio.h>
+
+
+LGlyphAtlas::LGlyphAtlas() : m_font(nullptr), m_texture(nullptr), m_size(0), m_lineHeight(0), m_shelvesHeight(0),
+	m_rasterized(0), m_full(false)
+{
+	for (Glyph& glyph : m_glyphs)
+		glyph = { { 0, 0, 0, 0 }, 0, false };
+}
+
+LGlyphAtlas::~LGlyphAtlas()
+{
+	/* Deallocate */
+	free();
+}
+
+bool LGlyphAtlas::create(TTF_Font* font, int size)
+{
+	/* Get rid of preexisting atlas */
+	free();
+
+	if (font == nullptr) {
+		printf("Can't create glyph atlas without a font!\n");
+		return false;
+	}
+
+	/* Create texture glyphs get copied into */
+	m_texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, size, size);
+	if (m_texture == nullptr) {
+		printf("Unable to create glyph atlas texture! SDL_Error: %s\n", SDL_GetError());
+		return false;
+	}
+	SDL_SetTextureBlendMode(m_texture, SDL_BLENDMODE_BLEND);
+
+	/* Start fully transparent, so padding around glyphs is empty */
+	std::vector<Uint32> blank(static_cast<size_t>(size) * size, 0);
+	if (SDL_UpdateTexture(m_texture, nullptr, blank.data(), size * 4) < 0) {
+		printf("Unable to clear glyph atlas texture! SDL_Error: %s\n", SDL_GetError());
+		free();
+		return false;
+	}
+
+	m_font = font;
+	m_size = size;
+	m_lineHeight = TTF_FontHeight(font);
+
+	/* Room for a typical line, so rendering doesn't have to grow buffers */
+	m_vertices.reserve(64 * 4);
+	m_indices.reserve(64 * 6);
+
+	return true;
+}
+
+bool LGlyphAtlas::preload(const std::string& text)
+{
+	bool success = true;
+	for (unsigned char character : text) {
+		if (!cacheGlyph(character))
+			success = false;
+	}
+	return success;
+}
+
+void LGlyphAtlas::free()
+{
+	if (m_texture != nullptr) {
+		SDL_DestroyTexture(m_texture);
+		m_texture = nullptr;
+	}
+
+	for (Glyph& glyph : m_glyphs)
+		glyph = { { 0, 0, 0, 0 }, 0, false };
+
+	m_font = nullptr;
+	m_size = 0;
+	m_lineHeight = 0;
+	m_shelves.clear();
+	m_shelvesHeight = 0;
+	m_rasterized = 0;
+	m_full = false;
+}
+
+void LGlyphAtlas::render(int x, int y, const std::string& text, SDL_Color color)
+{
+	if (m_texture == nullptr)
+		return;
+
+	int penX = x;
+	Uint8 previous = 0;
+
+	for (unsigned char character : text) {
+		if (!m_glyphs[character].cached)
+			cacheGlyph(character);
+		const Glyph& glyph = m_glyphs[character];
+
+		/* Move pen closer or further from previous glyph */
+		if (previous != 0)
+			penX += TTF_GetFontKerningSizeGlyphs(m_font, previous, character);
+		previous = character;
+
+		addQuad(static_cast<float>(penX), static_cast<float>(y), glyph, color);
+		penX += glyph.advance;
+	}
+
+	/* Draw whole string at once */
+	flush();
+}
+
+void LGlyphAtlas::render(int x, int y, const char* text, const int* offsets, size_t count, SDL_Color color)
+{
+	if (m_texture == nullptr)
+		return;
+
+	for (size_t i = 0; i < count; ++i) {
+		Uint8 character = static_cast<Uint8>(text[i]);
+		if (!m_glyphs[character].cached)
+			cacheGlyph(character);
+
+		addQuad(static_cast<float>(x + offsets[i]), static_cast<float>(y), m_glyphs[character], color);
+	}
+
+	flush();
+}
+
+int LGlyphAtlas::textWidth(const std::string& text)
+{
+	if (m_font == nullptr)
+		return 0;
+
+	int width = 0;
+	Uint8 previous = 0;
+
+	for (unsigned char character : text) {
+		if (!m_glyphs[character].cached)
+			cacheGlyph(character);
+
+		if (previous != 0)
+			width += TTF_GetFontKerningSizeGlyphs(m_font, previous, character);
+		previous = character;
+
+		width += m_glyphs[character].advance;
+	}
+
+	return width;
+}
+
+int LGlyphAtlas::lineHeight() const
+{
+	return m_lineHeight;
+}
+
+int LGlyphAtlas::advance(Uint8 character)
+{
+	if (!m_glyphs[character].cached)
+		cacheGlyph(character);
+	return m_glyphs[character].advance;
+}
+
+int LGlyphAtlas::kerning(Uint8 previous, Uint8 character) const
+{
+	if (m_font == nullptr)
+		return 0;
+	return TTF_GetFontKerningSizeGlyphs(m_font, previous, character);
+}
+
+int LGlyphAtlas::rasterizedGlyphs() const
+{
+	return m_rasterized;
+}
+
+bool LGlyphAtlas::cacheGlyph(Uint8 character)
+{
+	if (m_font == nullptr)
+		return false;
+
+	Glyph& glyph = m_glyphs[character];
+	if (glyph.cached)
+		return true;
+
+	/* Whatever happens, don't try again each frame */
+	glyph.cached = true;
+
+	int minX, maxX, minY, maxY;
+	if (TTF_GlyphMetrics(m_font, character, &minX, &maxX, &minY, &maxY, &glyph.advance) == -1) {
+		printf("Unable to get glyph metrics! TTF_Error: %s\n", TTF_GetError());
+		glyph.advance = 0;
+		return false;
+	}
+
+	/* Nothing to draw, like space */
+	if (maxX <= minX || maxY <= minY)
+		return true;
+
+	/* Rasterize in white, color comes from vertices */
+	SDL_Color white = { 0xFF, 0xFF, 0xFF, 0xFF };
+	SDL_Surface* surface = TTF_RenderGlyph_Blended(m_font, character, white);
+	if (surface == nullptr) {
+		printf("Unable to render glyph surface! TTF_Error: %s\n", TTF_GetError());
+		return false;
+	}
+
+	/* Make sure pixels match the atlas format */
+	if (surface->format->format != SDL_PIXELFORMAT_ARGB8888) {
+		SDL_Surface* converted = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_ARGB8888, 0);
+		SDL_FreeSurface(surface);
+		surface = converted;
+		if (surface == nullptr) {
+			printf("Unable to convert glyph surface! SDL_Error: %s\n", SDL_GetError());
+			return false;
+		}
+	}
+
+	bool success = allocate(surface->w, surface->h, glyph.clip);
+	if (!success) {
+		/* Report only once, glyphs that don't fit just won't show */
+		if (!m_full)
+			printf("Glyph atlas is full!\n");
+		m_full = true;
+	}
+	else if (SDL_UpdateTexture(m_texture, &glyph.clip, surface->pixels, surface->pitch) < 0) {
+		printf("Unable to copy glyph into atlas! SDL_Error: %s\n", SDL_GetError());
+		success = false;
+	}
+	else
+		++m_rasterized;
+
+	if (!success)
+		glyph.clip = { 0, 0, 0, 0 };
+
+	SDL_FreeSurface(surface);
+	return success;
+}
+
+bool LGlyphAtlas::allocate(int width, int height, SDL_Rect& clip)
+{
+	int paddedWidth = width + PADDING, paddedHeight = height + PADDING;
+	if (paddedWidth > m_size)
+		return false;
+
+	/* Pick the lowest shelf glyph fits on, to waste the least space */
+	Shelf* best = nullptr;
+	for (Shelf& shelf : m_shelves) {
+		if (shelf.height >= paddedHeight && m_size - shelf.x >= paddedWidth &&
+			(best == nullptr || shelf.height < best->height))
+			best = &shelf;
+	}
+
+	/* Open new shelf under the others */
+	if (best == nullptr) {
+		if (m_size - m_shelvesHeight < paddedHeight)
+			return false;
+
+		m_shelves.push_back({ m_shelvesHeight, paddedHeight, 0 });
+		m_shelvesHeight += paddedHeight;
+		best = &m_shelves.back();
+	}
+
+	clip = { best->x, best->y, width, height };
+	best->x += paddedWidth;
+	return true;
+}
+
+void LGlyphAtlas::addQuad(float x, float y, const Glyph& glyph, SDL_Color color)
+{
+	/* Nothing to draw */
+	if (glyph.clip.w <= 0)
+		return;
+
+	float scale = 1.0f / m_size;
+	float right = x + glyph.clip.w, bottom = y + glyph.clip.h;
+
+	float u0 = glyph.clip.x * scale, v0 = glyph.clip.y * scale;
+	float u1 = (glyph.clip.x + glyph.clip.w) * scale, v1 = (glyph.clip.y + glyph.clip.h) * scale;
+
+	int first = static_cast<int>(m_vertices.size());
+	m_vertices.push_back({ { x, y }, color, { u0, v0 } });
+	m_vertices.push_back({ { right, y }, color, { u1, v0 } });
+	m_vertices.push_back({ { right, bottom }, color, { u1, v1 } });
+	m_vertices.push_back({ { x, bottom }, color, { u0, v1 } });
+
+	/* Two triangles per glyph */
+	const int corners[6] = { 0, 1, 2, 0, 2, 3 };
+	for (int corner : corners)
+		m_indices.push_back(first + corner);
+}
+
+void LGlyphAtlas::flush()
+{
+	if (!m_indices.empty())
+		SDL_RenderGeometry(renderer, m_texture, m_vertices.data(), static_cast<int>(m_vertices.size()),
+			m_indices.data(), static_cast<int>(m_indices.size()));
+
+	/* Buffers keep their capacity, so this doesn't allocate once they've grown big enough */
+	m_vertices.clear();
+	m_indices.clear();
+}
\ No newline at end of file
@@ -0,0 +1,98 @@
+#pragma once
+#include "SDL2/SDL.h"
+#include "SDL2/SDL_ttf.h"
+
+#include <string>
+#include <vector>
+
+/* Global renderer */
+extern SDL_Renderer* renderer;
+
+/* Glyphs of a font rasterized once into one shared texture, strings get drawn from it */
+class LGlyphAtlas
+{
+public:
+	/* Default atlas width and height */
+	static const int DEFAULT_SIZE = 512;
+
+	LGlyphAtlas();
+	~LGlyphAtlas();
+
+	/* Create empty atlas for font, glyphs are rasterized the first time they're needed */
+	bool create(TTF_Font* font, int size = DEFAULT_SIZE);
+
+	/* Rasterize glyphs of string ahead of time, false if some didn't fit */
+	bool preload(const std::string& text);
+
+	/* Deallocate memory */
+	void free();
+
+	/* Render string with its top left corner at given point */
+	void render(int x, int y, const std::string& text, SDL_Color color);
+
+	/* Render already laid out characters, character i going at x + offsets[i] */
+	void render(int x, int y, const char* text, const int* offsets, size_t count, SDL_Color color);
+
+	/* Get width of rendered string */
+	int textWidth(const std::string& text);
+	/* Get height of a line */
+	int lineHeight() const;
+
+	/* Get how far pen moves over character */
+	int advance(Uint8 character);
+	/* Get how much closer character goes to previous one */
+	int kerning(Uint8 previous, Uint8 character) const;
+
+	/* Get amount of glyphs rasterized into the atlas */
+	int rasterizedGlyphs() const;
+
+private:
+	/* Empty pixels left around every glyph, so filtering doesn't bleed neighbours in */
+	static const int PADDING = 1;
+
+	struct Glyph
+	{
+		/* Part of atlas holding the glyph, empty if it has nothing to draw */
+		SDL_Rect clip;
+		int advance;
+		/* Was glyph looked up already */
+		bool cached;
+	};
+
+	/* Row of glyphs in the atlas, filled from left to right */
+	struct Shelf
+	{
+		int y, height;
+		int x;
+	};
+
+	/* Look up glyph and rasterize it into the atlas, false if it couldn't be added */
+	bool cacheGlyph(Uint8 character);
+
+	/* Find free part of the atlas for area of given size */
+	bool allocate(int width, int height, SDL_Rect& clip);
+
+	/* Queue quad of glyph with top left corner at given point */
+	void addQuad(float x, float y, const Glyph& glyph, SDL_Color color);
+	/* Draw queued quads in one call */
+	void flush();
+
+	TTF_Font* m_font;
+	SDL_Texture* m_texture;
+	int m_size;
+	int m_lineHeight;
+
+	/* Glyphs indexed by Latin-1 character, the same way TTF_RenderText reads strings */
+	Glyph m_glyphs[256];
+
+	/* Shelves and the height they take up */
+	std::vector<Shelf> m_shelves;
+	int m_shelvesHeight;
+
+	int m_rasterized;
+	bool m_full;
+
+	/* Quads of string being rendered, kept so their memory is reused */
+	std::vector<SDL_Vertex> m_vertices;
+	std::vector<int> m_indices;
+};
\ No newline at end of file
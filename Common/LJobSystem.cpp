@@ -0,0 +1,286 @@
+#include "LJobSystem.h"
+
+#include <stdio.h>
+
+
+/* Job system and deque of calling thread, none for threads outside of any */
+static thread_local LJobSystem* s_system = nullptr;
+static thread_local int s_thread = -1;
+/* Picks whom to steal from */
+static thread_local Uint32 s_seed = 0;
+
+/* Chase-Lev deque, owner pushes and takes at bottom while others steal from top */
+struct LJobSystem::Deque
+{
+	alignas(64) std::atomic<Sint64> top;
+	alignas(64) std::atomic<Sint64> bottom;
+	alignas(64) std::atomic<LJob*> jobs[DEQUE_SIZE];
+
+	Deque() : top(0), bottom(0)
+	{
+		for (int i = 0; i < DEQUE_SIZE; ++i)
+			jobs[i].store(nullptr, std::memory_order_relaxed);
+	}
+
+	/* Owner only, false if full */
+	bool push(LJob* job)
+	{
+		Sint64 b = bottom.load(std::memory_order_relaxed);
+		Sint64 t = top.load(std::memory_order_acquire);
+		if (b - t >= DEQUE_SIZE)
+			return false;
+
+		jobs[b & (DEQUE_SIZE - 1)].store(job, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		bottom.store(b + 1, std::memory_order_relaxed);
+		return true;
+	}
+
+	/* Owner only, newest job */
+	LJob* take()
+	{
+		/* Claim bottom job before looking whether thieves got there first */
+		Sint64 b = bottom.load(std::memory_order_relaxed) - 1;
+		bottom.store(b, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		Sint64 t = top.load(std::memory_order_relaxed);
+
+		LJob* job = nullptr;
+		if (t <= b) {
+			job = jobs[b & (DEQUE_SIZE - 1)].load(std::memory_order_relaxed);
+
+			/* Last job, race thieves for it */
+			if (t == b) {
+				if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+					job = nullptr;
+				bottom.store(b + 1, std::memory_order_relaxed);
+			}
+		}
+		else
+			bottom.store(b + 1, std::memory_order_relaxed);
+
+		return job;
+	}
+
+	/* Any thread, oldest job, null if empty or another thread was faster */
+	LJob* steal()
+	{
+		Sint64 t = top.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		Sint64 b = bottom.load(std::memory_order_acquire);
+
+		if (t >= b)
+			return nullptr;
+
+		LJob* job = jobs[t & (DEQUE_SIZE - 1)].load(std::memory_order_relaxed);
+		if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+			return nullptr;
+		return job;
+	}
+};
+
+
+LJobCounter::LJobCounter() : m_pending(0), m_lock(0)
+{
+}
+
+int LJobCounter::pending() const
+{
+	return m_pending.load(std::memory_order_acquire);
+}
+
+
+LJobSystem::LJobSystem(int workers) : m_started(0), m_sleeping(0), m_quit(false), m_steals(0)
+{
+	if (workers < 0)
+		workers = SDL_max(SDL_GetCPUCount() - 1, 0);
+
+	/* Creating thread is the main one */
+	s_system = this;
+	s_thread = 0;
+
+	for (int i = 0; i <= workers; ++i)
+		m_deques.emplace_back(new Deque);
+
+	m_wake = SDL_CreateSemaphore(0);
+	if (m_wake == NULL)
+		printf("Unable to create job system semaphore! SDL_Error: %s\n", SDL_GetError());
+
+	for (int i = 0; i < workers; ++i) {
+		SDL_Thread* worker = SDL_CreateThread(workerThread, "JobWorker", this);
+		if (worker == NULL)
+			printf("Unable to create job worker! SDL_Error: %s\n", SDL_GetError());
+		else
+			m_workers.push_back(worker);
+	}
+}
+
+LJobSystem::~LJobSystem()
+{
+	/* Wake everyone up to see they should quit */
+	m_quit.store(true);
+	for (size_t i = 0; i < m_workers.size(); ++i)
+		SDL_SemPost(m_wake);
+	for (SDL_Thread* worker : m_workers)
+		SDL_WaitThread(worker, NULL);
+
+	SDL_DestroySemaphore(m_wake);
+
+	if (s_system == this) {
+		s_system = nullptr;
+		s_thread = -1;
+	}
+}
+
+void LJobSystem::run(LJob& job)
+{
+	if (job.counter)
+		job.counter->m_pending.fetch_add(1, std::memory_order_relaxed);
+	push(&job);
+}
+
+void LJobSystem::run(LJob* jobs, int count)
+{
+	/* Count all of them first, so none finishing early can make counter reach zero */
+	for (int i = 0; i < count; ++i) {
+		if (jobs[i].counter)
+			jobs[i].counter->m_pending.fetch_add(1, std::memory_order_relaxed);
+	}
+	for (int i = 0; i < count; ++i)
+		push(&jobs[i]);
+}
+
+void LJobSystem::runAfter(LJobCounter& dependency, LJob& job)
+{
+	if (job.counter)
+		job.counter->m_pending.fetch_add(1, std::memory_order_relaxed);
+
+	/* Dependency finishing takes continuations under the same lock, so job is either seen by it or sees zero */
+	SDL_AtomicLock(&dependency.m_lock);
+	if (dependency.m_pending.load(std::memory_order_acquire) > 0) {
+		dependency.m_continuations.push_back(&job);
+		SDL_AtomicUnlock(&dependency.m_lock);
+	}
+	else {
+		SDL_AtomicUnlock(&dependency.m_lock);
+		push(&job);
+	}
+}
+
+void LJobSystem::wait(LJobCounter& counter)
+{
+	bool member = s_system == this;
+	while (counter.m_pending.load(std::memory_order_acquire) > 0) {
+		/* Help instead of idling */
+		LJob* job = member ? findJob(s_thread) : nullptr;
+		if (job)
+			execute(job);
+		else
+			SDL_Delay(0);
+	}
+
+	/* Last job may still be releasing counter's lock, counter can't go away before it did */
+	SDL_AtomicLock(&counter.m_lock);
+	SDL_AtomicUnlock(&counter.m_lock);
+}
+
+int LJobSystem::threadCount() const
+{
+	return static_cast<int>(m_deques.size());
+}
+
+Uint64 LJobSystem::getSteals() const
+{
+	return m_steals.load(std::memory_order_relaxed);
+}
+
+int LJobSystem::workerThread(void* data)
+{
+	LJobSystem* system = static_cast<LJobSystem*>(data);
+	int thread = system->m_started.fetch_add(1) + 1;
+	s_system = system;
+	s_thread = thread;
+	s_seed = 2654435761u * thread;
+
+	while (!system->m_quit.load(std::memory_order_acquire)) {
+		LJob* job = system->findJob(thread);
+		if (job) {
+			system->execute(job);
+			continue;
+		}
+
+		/* Announce sleeping before looking once more, so a push either sees it or gets found */
+		system->m_sleeping.fetch_add(1, std::memory_order_seq_cst);
+		job = system->findJob(thread);
+		if (job) {
+			system->m_sleeping.fetch_sub(1, std::memory_order_relaxed);
+			system->execute(job);
+			continue;
+		}
+
+		/* Time out now and then anyway, a missed wake up only costs that much */
+		if (!system->m_quit.load(std::memory_order_acquire))
+			SDL_SemWaitTimeout(system->m_wake, 10);
+		system->m_sleeping.fetch_sub(1, std::memory_order_relaxed);
+	}
+
+	return 0;
+}
+
+LJob* LJobSystem::findJob(int thread)
+{
+	LJob* job = m_deques[thread]->take();
+	if (job)
+		return job;
+
+	/* Steal, starting from a random thread so thieves spread out */
+	int threads = threadCount();
+	s_seed = s_seed * 1664525u + 1013904223u;
+	int first = static_cast<int>((s_seed >> 8) % threads);
+	for (int i = 0; i < threads; ++i) {
+		int victim = (first + i) % threads;
+		if (victim == thread)
+			continue;
+
+		job = m_deques[victim]->steal();
+		if (job) {
+			m_steals.fetch_add(1, std::memory_order_relaxed);
+			return job;
+		}
+	}
+
+	return nullptr;
+}
+
+void LJobSystem::execute(LJob* job)
+{
+	/* Job may be gone once counter is released, so read it first */
+	LJobCounter* counter = job->counter;
+	job->function(job->data);
+	if (!counter)
+		return;
+
+	/* Last one to finish runs jobs waiting for the counter */
+	std::vector<LJob*> continuations;
+	SDL_AtomicLock(&counter->m_lock);
+	if (counter->m_pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		continuations.swap(counter->m_continuations);
+	SDL_AtomicUnlock(&counter->m_lock);
+
+	for (LJob* continuation : continuations)
+		push(continuation);
+}
+
+void LJobSystem::push(LJob* job)
+{
+	/* Threads outside the system and full deques run the job right away */
+	if (s_system != this || !m_deques[s_thread]->push(job)) {
+		execute(job);
+		return;
+	}
+
+	/* Wake a sleeping worker for it */
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (m_sleeping.load(std::memory_order_relaxed) > 0)
+		SDL_SemPost(m_wake);
+}
\ No newline at end of file
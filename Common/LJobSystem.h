@@ -0,0 +1,144 @@
+#pragma once
+#include "SDL2/SDL.h"
+#include "SDL2/SDL_thread.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+class LJobCounter;
+
+/* Function with its data, run by whichever thread of the job system gets to it first */
+struct LJob
+{
+	void (*function)(void* data);
+	void* data;
+	/* Counter the job counts towards until it finished, may be null */
+	LJobCounter* counter;
+};
+
+/* Amount of unfinished jobs, jobs can be made to wait for it to reach zero */
+class LJobCounter
+{
+public:
+	LJobCounter();
+
+	LJobCounter(const LJobCounter&) = delete;
+	LJobCounter& operator=(const LJobCounter&) = delete;
+
+	/* Get amount of jobs not finished yet */
+	int pending() const;
+
+private:
+	friend class LJobSystem;
+
+	std::atomic<int> m_pending;
+
+	/* Jobs to run once pending reaches zero */
+	SDL_SpinLock m_lock;
+	std::vector<LJob*> m_continuations;
+};
+
+/* Pool of one worker per core besides the main thread, each with its own deque of jobs the others steal from */
+class LJobSystem
+{
+public:
+	/* Jobs one thread can have queued, pushing more runs them right away */
+	static const int DEQUE_SIZE = 4096;
+
+	/* Given amount of workers, or one less than there are cores */
+	LJobSystem(int workers = -1);
+	~LJobSystem();
+
+	LJobSystem(const LJobSystem&) = delete;
+	LJobSystem& operator=(const LJobSystem&) = delete;
+
+	/* Queue job from main thread or a job, it has to stay alive until it ran */
+	void run(LJob& job);
+	void run(LJob* jobs, int count);
+
+	/* Queue job once every job counted by dependency finished */
+	void runAfter(LJobCounter& dependency, LJob& job);
+
+	/* Run queued jobs, stealing if needed, until counter reaches zero */
+	void wait(LJobCounter& counter);
+
+	/* Call function(begin, end) on batches of at least grain indices of 0 to count, on every thread, and wait for it */
+	template<typename Function>
+	void parallelFor(int count, int grain, Function function);
+
+	/* Get amount of threads running jobs, main thread included */
+	int threadCount() const;
+
+	/* Get amount of jobs taken from another thread's deque */
+	Uint64 getSteals() const;
+
+private:
+	struct Deque;
+
+	/* Part of parallelFor range */
+	template<typename Function>
+	struct Batch
+	{
+		Function* function;
+		int begin, end;
+	};
+
+	template<typename Function>
+	static void runBatch(void* data);
+
+	static int workerThread(void* data);
+
+	/* Get next job for thread, own ones newest first then stolen ones oldest first */
+	LJob* findJob(int thread);
+	/* Run job and finish it on its counter */
+	void execute(LJob* job);
+	/* Push job to calling thread's deque, waking a worker for it */
+	void push(LJob* job);
+
+	/* Deque of main thread first, then one per worker */
+	std::vector<std::unique_ptr<Deque>> m_deques;
+	std::vector<SDL_Thread*> m_workers;
+	std::atomic<int> m_started;
+
+	/* Sleeping workers wait on semaphore for new jobs */
+	SDL_sem* m_wake;
+	std::atomic<int> m_sleeping;
+	std::atomic<bool> m_quit;
+
+	std::atomic<Uint64> m_steals;
+};
+
+template<typename Function>
+void LJobSystem::parallelFor(int count, int grain, Function function)
+{
+	if (count <= 0)
+		return;
+
+	/* A few batches per thread so stealing can even out uneven ones */
+	int batchSize = (count + threadCount() * 4 - 1) / (threadCount() * 4);
+	batchSize = SDL_max(batchSize, SDL_max(grain, 1));
+	int batchCount = (count + batchSize - 1) / batchSize;
+
+	std::vector<Batch<Function>> batches(batchCount);
+	std::vector<LJob> jobs(batchCount);
+	LJobCounter counter;
+	for (int i = 0; i < batchCount; ++i) {
+		batches[i].function = &function;
+		batches[i].begin = i * batchSize;
+		batches[i].end = SDL_min(count, (i + 1) * batchSize);
+		jobs[i].function = runBatch<Function>;
+		jobs[i].data = &batches[i];
+		jobs[i].counter = &counter;
+	}
+
+	run(jobs.data(), batchCount);
+	wait(counter);
+}
+
+template<typename Function>
+void LJobSystem::runBatch(void* data)
+{
+	Batch<Function>* batch = static_cast<Batch<Function>*>(data);
+	(*batch->function)(batch->begin, batch->end);
+}
\ No newline at end of file
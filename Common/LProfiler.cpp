@@ -0,0 +1,403 @@
+#include "LProfiler.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+
+#if !defined(LPROFILER_DISABLED)
+
+namespace
+{
+	/* One measured run of a zone */
+	struct Event
+	{
+		const char* name;
+		Uint64 start, end;
+		Uint32 depth;
+	};
+
+	/* Events of one thread, only that thread writes them */
+	struct ThreadBuffer
+	{
+		Event events[LProfiler::RING_SIZE];
+		/* Amount of events started and finished writing, an event is published after itself */
+		std::atomic<Uint64> begun{ 0 };
+		std::atomic<Uint64> written{ 0 };
+		/* Events before this were reset away */
+		std::atomic<Uint64> resetAt{ 0 };
+		/* Events before this were summed into frames already */
+		Uint64 framed = 0;
+		/* Open zones */
+		Uint32 depth = 0;
+
+		SDL_threadID id = 0;
+		const char* name = nullptr;
+	};
+
+	/* Outermost zone times of one frame */
+	struct Frame
+	{
+		Uint64 total;
+		Uint64 zones[LProfiler::MAX_CATEGORIES];
+	};
+
+	/* Every thread's buffer, kept after thread ends so its events still get exported */
+	SDL_SpinLock s_lock = 0;
+	std::vector<std::unique_ptr<ThreadBuffer>> s_buffers;
+	thread_local ThreadBuffer* s_buffer = nullptr;
+
+	/* Frame history, used only by thread calling frame */
+	Frame s_frames[LProfiler::FRAME_HISTORY];
+	int s_frameCount = 0, s_nextFrame = 0;
+	Uint64 s_lastFrameEnd = 0;
+	const char* s_categories[LProfiler::MAX_CATEGORIES];
+	int s_categoryCount = 0;
+
+	/* Colors of categories in overlay, other time is gray */
+	const SDL_Color CATEGORY_COLORS[LProfiler::MAX_CATEGORIES] = {
+		{ 0x4C, 0xAF, 0x50, 0xFF }, { 0x21, 0x96, 0xF3, 0xFF }, { 0xFF, 0x98, 0x00, 0xFF }, { 0xE9, 0x1E, 0x63, 0xFF },
+		{ 0x9C, 0x27, 0xB0, 0xFF }, { 0x00, 0xBC, 0xD4, 0xFF }, { 0xCD, 0xDC, 0x39, 0xFF }, { 0x79, 0x55, 0x48, 0xFF }
+	};
+
+	ThreadBuffer* threadBuffer()
+	{
+		/* Register thread on its first event */
+		if (!s_buffer) {
+			std::unique_ptr<ThreadBuffer> buffer(new ThreadBuffer);
+			buffer->id = SDL_ThreadID();
+			s_buffer = buffer.get();
+
+			SDL_AtomicLock(&s_lock);
+			s_buffers.push_back(std::move(buffer));
+			SDL_AtomicUnlock(&s_lock);
+		}
+		return s_buffer;
+	}
+
+	/* Category of zone name, -1 if there's no room for another one */
+	int category(const char* name)
+	{
+		for (int i = 0; i < s_categoryCount; ++i) {
+			if (s_categories[i] == name || strcmp(s_categories[i], name) == 0)
+				return i;
+		}
+
+		if (s_categoryCount == LProfiler::MAX_CATEGORIES)
+			return -1;
+		s_categories[s_categoryCount] = name;
+		return s_categoryCount++;
+	}
+
+	/* Copy kept events of buffer, possibly while its thread writes more */
+	void copyEvents(ThreadBuffer& buffer, std::vector<Event>& events)
+	{
+		Uint64 written = buffer.written.load(std::memory_order_acquire);
+		Uint64 from = written > LProfiler::RING_SIZE ? written - LProfiler::RING_SIZE : 0;
+		from = SDL_max(from, buffer.resetAt.load(std::memory_order_relaxed));
+
+		size_t first = events.size();
+		for (Uint64 i = from; i < written; ++i)
+			events.push_back(buffer.events[i % LProfiler::RING_SIZE]);
+
+		/* Drop whatever got overwritten while copying, the slot being written included */
+		std::atomic_thread_fence(std::memory_order_acquire);
+		Uint64 begun = buffer.begun.load(std::memory_order_relaxed);
+		if (begun > from + LProfiler::RING_SIZE) {
+			size_t overwritten = static_cast<size_t>(SDL_min(begun - LProfiler::RING_SIZE - from, written - from));
+			events.erase(events.begin() + first, events.begin() + first + overwritten);
+		}
+	}
+
+	/* Append name as JSON string */
+	void appendString(std::string& json, const char* text)
+	{
+		json += '"';
+		for (const char* c = text; *c; ++c) {
+			if (*c == '"' || *c == '\\')
+				json += '\\';
+			json += *c;
+		}
+		json += '"';
+	}
+}
+
+void LProfiler::setThreadName(const char* name)
+{
+	threadBuffer()->name = name;
+}
+
+void LProfiler::record(const char* name, Uint64 start, Uint64 end, Uint32 depth)
+{
+	ThreadBuffer* buffer = threadBuffer();
+	Uint64 written = buffer->written.load(std::memory_order_relaxed);
+
+	/* Readers copying meanwhile know to drop the slot */
+	buffer->begun.store(written + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	Event& event = buffer->events[written % RING_SIZE];
+	event.name = name;
+	event.start = start;
+	event.end = end;
+	event.depth = depth;
+
+	buffer->written.store(written + 1, std::memory_order_release);
+}
+
+void LProfiler::frame()
+{
+	ThreadBuffer* buffer = threadBuffer();
+	Uint64 now = SDL_GetPerformanceCounter();
+
+	/* First frame only starts measuring */
+	if (s_lastFrameEnd == 0) {
+		s_lastFrameEnd = now;
+		buffer->framed = buffer->written.load(std::memory_order_relaxed);
+		return;
+	}
+
+	Frame& frame = s_frames[s_nextFrame];
+	frame.total = now - s_lastFrameEnd;
+	for (int i = 0; i < MAX_CATEGORIES; ++i)
+		frame.zones[i] = 0;
+
+	/* Sum outermost zones, ones that fell out of the ring are lost */
+	Uint64 written = buffer->written.load(std::memory_order_relaxed);
+	Uint64 from = written > RING_SIZE ? SDL_max(buffer->framed, written - RING_SIZE) : buffer->framed;
+	for (Uint64 i = from; i < written; ++i) {
+		const Event& event = buffer->events[i % RING_SIZE];
+		if (event.depth != 0)
+			continue;
+
+		int index = category(event.name);
+		if (index >= 0)
+			frame.zones[index] += event.end - event.start;
+	}
+	buffer->framed = written;
+
+	s_lastFrameEnd = now;
+	s_nextFrame = (s_nextFrame + 1) % FRAME_HISTORY;
+	s_frameCount = SDL_min(s_frameCount + 1, FRAME_HISTORY);
+}
+
+void LProfiler::renderOverlay(const SDL_Rect& area, double targetSeconds)
+{
+	/* Keep renderer state as it was */
+	Uint8 r, g, b, a;
+	SDL_BlendMode blendMode;
+	SDL_GetRenderDrawColor(renderer, &r, &g, &b, &a);
+	SDL_GetRenderDrawBlendMode(renderer, &blendMode);
+
+	/* Translucent background */
+	SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+	SDL_SetRenderDrawColor(renderer, 0x00, 0x00, 0x00, 0xB0);
+	SDL_RenderFillRect(renderer, &area);
+
+	/* Area is tall enough for twice the target time */
+	double countsPerPixel = targetSeconds * 2.0 * SDL_GetPerformanceFrequency() / area.h;
+	int barWidth = SDL_max(area.w / FRAME_HISTORY, 1);
+
+	/* Oldest frame on the left */
+	for (int i = 0; i < s_frameCount; ++i) {
+		const Frame& frame = s_frames[(s_nextFrame - s_frameCount + i + FRAME_HISTORY) % FRAME_HISTORY];
+		SDL_Rect bar = { area.x + i * barWidth, area.y + area.h, barWidth, 0 };
+		if (bar.x + barWidth > area.x + area.w)
+			break;
+
+		/* Stack zones from the bottom */
+		Uint64 zoned = 0;
+		for (int category = 0; category <= s_categoryCount; ++category) {
+			Uint64 counts;
+			if (category < s_categoryCount) {
+				counts = frame.zones[category];
+				zoned += counts;
+				const SDL_Color& color = CATEGORY_COLORS[category];
+				SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, 0xFF);
+			}
+			else {
+				/* Frame time outside of any zone */
+				counts = frame.total > zoned ? frame.total - zoned : 0;
+				SDL_SetRenderDrawColor(renderer, 0x80, 0x80, 0x80, 0xFF);
+			}
+
+			bar.h = static_cast<int>(counts / countsPerPixel);
+			bar.h = SDL_min(bar.h, bar.y - area.y);
+			bar.y -= bar.h;
+			SDL_RenderFillRect(renderer, &bar);
+		}
+	}
+
+	/* Target frame time line halfway up, and outline */
+	SDL_SetRenderDrawColor(renderer, 0xFF, 0x00, 0x00, 0xFF);
+	SDL_RenderDrawLine(renderer, area.x, area.y + area.h / 2, area.x + area.w - 1, area.y + area.h / 2);
+	SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
+	SDL_RenderDrawRect(renderer, &area);
+
+	SDL_SetRenderDrawColor(renderer, r, g, b, a);
+	SDL_SetRenderDrawBlendMode(renderer, blendMode);
+}
+
+bool LProfiler::exportChromeTrace(const std::string& path)
+{
+	/* Gather every thread's events */
+	std::vector<Event> events;
+	std::vector<std::pair<ThreadBuffer*, size_t>> threads;
+	SDL_AtomicLock(&s_lock);
+	for (auto& buffer : s_buffers) {
+		copyEvents(*buffer, events);
+		threads.push_back(std::make_pair(buffer.get(), events.size()));
+	}
+	SDL_AtomicUnlock(&s_lock);
+
+	/* Times relative to earliest event, in microseconds */
+	Uint64 origin = 0;
+	for (size_t i = 0; i < events.size(); ++i)
+		origin = i == 0 ? events[i].start : SDL_min(origin, events[i].start);
+	double microsecondsPerCount = 1000000.0 / SDL_GetPerformanceFrequency();
+
+	std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	char number[128];
+	bool first = true;
+	size_t event = 0;
+	for (auto& thread : threads) {
+		unsigned long tid = static_cast<unsigned long>(thread.first->id);
+
+		/* Thread name as metadata event */
+		if (thread.first->name) {
+			json += first ? "" : ",";
+			first = false;
+			snprintf(number, sizeof(number), "{\"ph\":\"M\",\"pid\":1,\"tid\":%lu,\"name\":\"thread_name\",\"args\":{\"name\":", tid);
+			json += number;
+			appendString(json, thread.first->name);
+			json += "}}";
+		}
+
+		for (; event < thread.second; ++event) {
+			json += first ? "" : ",";
+			first = false;
+			json += "{\"ph\":\"X\",\"name\":";
+			appendString(json, events[event].name);
+			snprintf(number, sizeof(number), ",\"pid\":1,\"tid\":%lu,\"ts\":%.3f,\"dur\":%.3f}", tid,
+				(events[event].start - origin) * microsecondsPerCount,
+				(events[event].end - events[event].start) * microsecondsPerCount);
+			json += number;
+		}
+	}
+	json += "]}";
+
+	/* Write file */
+	SDL_RWops* file = SDL_RWFromFile(path.c_str(), "wb");
+	if (file == NULL) {
+		printf("Unable to open %s for writing! SDL_Error: %s\n", path.c_str(), SDL_GetError());
+		return false;
+	}
+	bool success = SDL_RWwrite(file, json.data(), 1, json.size()) == json.size();
+	if (!success)
+		printf("Unable to write trace to %s! SDL_Error: %s\n", path.c_str(), SDL_GetError());
+	SDL_RWclose(file);
+
+	return success;
+}
+
+Uint64 LProfiler::eventCount()
+{
+	Uint64 count = 0;
+	SDL_AtomicLock(&s_lock);
+	for (auto& buffer : s_buffers)
+		count += buffer->written.load(std::memory_order_relaxed);
+	SDL_AtomicUnlock(&s_lock);
+	return count;
+}
+
+double LProfiler::getAverageMilliseconds(const char* name)
+{
+	for (int category = 0; category < s_categoryCount; ++category) {
+		if (strcmp(s_categories[category], name) != 0)
+			continue;
+
+		Uint64 counts = 0;
+		for (int i = 0; i < s_frameCount; ++i)
+			counts += s_frames[i].zones[category];
+		return s_frameCount > 0 ? counts * 1000.0 / SDL_GetPerformanceFrequency() / s_frameCount : 0.0;
+	}
+
+	return -1.0;
+}
+
+void LProfiler::reset()
+{
+	SDL_AtomicLock(&s_lock);
+	for (auto& buffer : s_buffers)
+		buffer->resetAt.store(buffer->written.load(std::memory_order_relaxed), std::memory_order_relaxed);
+	SDL_AtomicUnlock(&s_lock);
+
+	/* Next frame starts measuring over */
+	s_frameCount = s_nextFrame = 0;
+	s_categoryCount = 0;
+	s_lastFrameEnd = 0;
+}
+
+LProfileZone::LProfileZone(const char* name) : m_name(name)
+{
+	m_depth = threadBuffer()->depth++;
+	m_start = SDL_GetPerformanceCounter();
+}
+
+LProfileZone::~LProfileZone()
+{
+	Uint64 end = SDL_GetPerformanceCounter();
+	--s_buffer->depth;
+	LProfiler::record(m_name, m_start, end, m_depth);
+}
+
+#else
+
+/* Compiled out, nothing gets recorded */
+void LProfiler::setThreadName(const char*)
+{
+}
+
+void LProfiler::record(const char*, Uint64, Uint64, Uint32)
+{
+}
+
+void LProfiler::frame()
+{
+}
+
+void LProfiler::renderOverlay(const SDL_Rect&, double)
+{
+}
+
+bool LProfiler::exportChromeTrace(const std::string& path)
+{
+	printf("Profiler is compiled out, nothing to write to %s!\n", path.c_str());
+	return false;
+}
+
+Uint64 LProfiler::eventCount()
+{
+	return 0;
+}
+
+double LProfiler::getAverageMilliseconds(const char*)
+{
+	return -1.0;
+}
+
+void LProfiler::reset()
+{
+}
+
+LProfileZone::LProfileZone(const char* name) : m_name(name), m_start(0), m_depth(0)
+{
+}
+
+LProfileZone::~LProfileZone()
+{
+}
+
+#endif
\ No newline at end of file
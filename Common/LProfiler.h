@@ -0,0 +1,75 @@
+#pragma once
+#include "SDL2/SDL.h"
+
+#include <string>
+
+/* Global renderer */
+extern SDL_Renderer* renderer;
+
+/* Zones are compiled in unless LPROFILER_DISABLED is defined, then they cost nothing at all */
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#if !defined(LPROFILER_DISABLED)
+/* Measure the rest of the enclosing scope under given name */
+#define PROFILE_ZONE(name) LProfileZone PROFILE_CONCAT(profileZone, __LINE__)(name)
+/* Mark end of frame on this thread */
+#define PROFILE_FRAME() LProfiler::frame()
+/* Name this thread in exported trace */
+#define PROFILE_THREAD(name) LProfiler::setThreadName(name)
+#else
+#define PROFILE_ZONE(name) ((void)0)
+#define PROFILE_FRAME() ((void)0)
+#define PROFILE_THREAD(name) ((void)0)
+#endif
+
+/* Collects zone timings of every thread into per thread ring buffers */
+class LProfiler
+{
+public:
+	/* Events kept per thread, oldest get overwritten */
+	static const Uint32 RING_SIZE = 8192;
+	/* Frames kept for overlay */
+	static const int FRAME_HISTORY = 120;
+	/* Distinct outermost zones overlay tells apart, the rest are drawn as other */
+	static const int MAX_CATEGORIES = 8;
+
+	/* Name calling thread, name has to outlive the profiler */
+	static void setThreadName(const char* name);
+
+	/* Record finished zone of calling thread, name has to outlive the profiler like a string literal does */
+	static void record(const char* name, Uint64 start, Uint64 end, Uint32 depth);
+
+	/* End frame, summing outermost zones calling thread finished since last one into frame history */
+	static void frame();
+
+	/* Draw time of last frames as stacked bars, with a line at target frame time; on the thread calling frame */
+	static void renderOverlay(const SDL_Rect& area, double targetSeconds = 1.0 / 60);
+
+	/* Write kept events of every thread as Chrome trace JSON, for chrome://tracing or Perfetto */
+	static bool exportChromeTrace(const std::string& path);
+
+	/* Get amount of events recorded by every thread, overwritten ones included */
+	static Uint64 eventCount();
+	/* Get average milliseconds zone took over kept frames, negative if it was never outermost */
+	static double getAverageMilliseconds(const char* name);
+
+	/* Forget frames and events recorded so far */
+	static void reset();
+};
+
+/* Measures from its construction to the end of its scope */
+class LProfileZone
+{
+public:
+	LProfileZone(const char* name);
+	~LProfileZone();
+
+	LProfileZone(const LProfileZone&) = delete;
+	LProfileZone& operator=(const LProfileZone&) = delete;
+
+private:
+	const char* m_name;
+	Uint64 m_start;
+	Uint32 m_depth;
+};
\ No newline at end of file
@@ -0,0 +1,216 @@
+#pragma once
+#include "SDL2/SDL.h"
+#include "SDL2/SDL_thread.h"
+
+#include <atomic>
+#include <memory>
+#include <utility>
+
+/* Bounded lock free queue between exactly one producer thread and one consumer thread */
+template<typename T>
+class LSPSCQueue
+{
+public:
+	/* Indices of producer and consumer live on cache lines of their own, so they don't bounce between cores */
+	static const size_t CACHE_LINE = 64;
+
+	/* Capacity is rounded up to power of two */
+	LSPSCQueue(size_t capacity) : m_tail(0), m_cachedHead(0), m_head(0), m_cachedTail(0)
+	{
+		m_capacity = 1;
+		while (m_capacity < capacity)
+			m_capacity <<= 1;
+		m_mask = m_capacity - 1;
+		m_items.reset(new T[m_capacity]);
+	}
+
+	LSPSCQueue(const LSPSCQueue&) = delete;
+	LSPSCQueue& operator=(const LSPSCQueue&) = delete;
+
+	/* Add item from producer thread, false if queue is full */
+	bool tryPush(const T& item)
+	{
+		T copy(item);
+		return tryPush(std::move(copy));
+	}
+
+	bool tryPush(T&& item)
+	{
+		size_t tail = m_tail.load(std::memory_order_relaxed);
+
+		/* Only look at consumer's index when the one seen last says full */
+		if (tail - m_cachedHead == m_capacity) {
+			m_cachedHead = m_head.load(std::memory_order_acquire);
+			if (tail - m_cachedHead == m_capacity)
+				return false;
+		}
+
+		m_items[tail & m_mask] = std::move(item);
+		m_tail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	/* Take item from consumer thread, false if queue is empty */
+	bool tryPop(T& item)
+	{
+		size_t head = m_head.load(std::memory_order_relaxed);
+
+		/* Only look at producer's index when the one seen last says empty */
+		if (head == m_cachedTail) {
+			m_cachedTail = m_tail.load(std::memory_order_acquire);
+			if (head == m_cachedTail)
+				return false;
+		}
+
+		item = std::move(m_items[head & m_mask]);
+		m_head.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	/* Get amount of queued items, only a snapshot while the other thread works */
+	size_t size() const
+	{
+		return m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire);
+	}
+
+	size_t capacity() const
+	{
+		return m_capacity;
+	}
+
+private:
+	/* Written by producer */
+	alignas(CACHE_LINE) std::atomic<size_t> m_tail;
+	size_t m_cachedHead;
+
+	/* Written by consumer */
+	alignas(CACHE_LINE) std::atomic<size_t> m_head;
+	size_t m_cachedTail;
+
+	/* Read only after construction */
+	alignas(CACHE_LINE) std::unique_ptr<T[]> m_items;
+	size_t m_capacity;
+	size_t m_mask;
+};
+
+/* LSPSCQueue that waits when full or empty, falling back to the condition variables only then */
+template<typename T>
+class LBlockingQueue
+{
+public:
+	LBlockingQueue(size_t capacity) : m_queue(capacity), m_producerWaiting(false), m_consumerWaiting(false)
+	{
+		m_lock = SDL_CreateMutex();
+		m_canPush = SDL_CreateCond();
+		m_canPop = SDL_CreateCond();
+	}
+
+	~LBlockingQueue()
+	{
+		SDL_DestroyCond(m_canPop);
+		SDL_DestroyCond(m_canPush);
+		SDL_DestroyMutex(m_lock);
+	}
+
+	LBlockingQueue(const LBlockingQueue&) = delete;
+	LBlockingQueue& operator=(const LBlockingQueue&) = delete;
+
+	/* Add item from producer thread, waiting for room if queue is full */
+	void push(T item)
+	{
+		if (!m_queue.tryPush(std::move(item))) {
+			SDL_LockMutex(m_lock);
+
+			/* Announce waiting before trying again, so consumer either sees it or makes the retry succeed */
+			m_producerWaiting.store(true, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			while (!m_queue.tryPush(std::move(item)))
+				SDL_CondWait(m_canPush, m_lock);
+			m_producerWaiting.store(false, std::memory_order_relaxed);
+
+			SDL_UnlockMutex(m_lock);
+		}
+
+		/* Wake consumer if it waits for this item */
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (m_consumerWaiting.load(std::memory_order_relaxed))
+			signal(m_canPop);
+	}
+
+	/* Take item from consumer thread, waiting for one if queue is empty */
+	T pop()
+	{
+		T item;
+		if (!m_queue.tryPop(item)) {
+			SDL_LockMutex(m_lock);
+
+			/* Same handshake as push */
+			m_consumerWaiting.store(true, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			while (!m_queue.tryPop(item))
+				SDL_CondWait(m_canPop, m_lock);
+			m_consumerWaiting.store(false, std::memory_order_relaxed);
+
+			SDL_UnlockMutex(m_lock);
+		}
+
+		/* Wake producer if it waits for room */
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (m_producerWaiting.load(std::memory_order_relaxed))
+			signal(m_canPush);
+
+		return item;
+	}
+
+	/* Non waiting versions, for threads with something else to do */
+	bool tryPush(T item)
+	{
+		if (!m_queue.tryPush(std::move(item)))
+			return false;
+
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (m_consumerWaiting.load(std::memory_order_relaxed))
+			signal(m_canPop);
+		return true;
+	}
+
+	bool tryPop(T& item)
+	{
+		if (!m_queue.tryPop(item))
+			return false;
+
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (m_producerWaiting.load(std::memory_order_relaxed))
+			signal(m_canPush);
+		return true;
+	}
+
+	size_t size() const
+	{
+		return m_queue.size();
+	}
+
+	size_t capacity() const
+	{
+		return m_queue.capacity();
+	}
+
+private:
+	/* Signal under lock, so it can't fall between waiting thread's last try and its wait */
+	void signal(SDL_cond* condition)
+	{
+		SDL_LockMutex(m_lock);
+		SDL_CondSignal(condition);
+		SDL_UnlockMutex(m_lock);
+	}
+
+	LSPSCQueue<T> m_queue;
+
+	SDL_mutex* m_lock;
+	SDL_cond* m_canPush;
+	SDL_cond* m_canPop;
+
+	/* Set by a thread about to wait, under lock */
+	std::atomic<bool> m_producerWaiting;
+	std::atomic<bool> m_consumerWaiting;
+};
\ No newline at end of file
@@ -0,0 +1,115 @@
+#include "LSpriteBatch.h"
+
+LSpriteBatch::LSpriteBatch() : m_texture(nullptr), m_textureWidth(0), m_textureHeight(0),
+	m_blendMode(SDL_BLENDMODE_BLEND)
+{
+	m_region = { 0, 0, 0, 0 };
+	m_color = { 0xFF, 0xFF, 0xFF, 0xFF };
+}
+
+void LSpriteBatch::begin(LTexture& texture)
+{
+	SDL_BlendMode blending = SDL_BLENDMODE_BLEND;
+	if (texture.getTexture() != NULL)
+		SDL_GetTextureBlendMode(texture.getTexture(), &blending);
+
+	setTexture(texture.getTexture(), texture.width(), texture.height(), blending);
+	m_region = { 0, 0, texture.width(), texture.height() };
+
+	/* Geometry ignores texture modulation, so apply it through vertex color */
+	m_color = { 0xFF, 0xFF, 0xFF, 0xFF };
+	if (m_texture != NULL) {
+		SDL_GetTextureColorMod(m_texture, &m_color.r, &m_color.g, &m_color.b);
+		SDL_GetTextureAlphaMod(m_texture, &m_color.a);
+	}
+}
+
+void LSpriteBatch::begin(LSubTexture& texture)
+{
+	LTexture* parent = texture.getParent();
+	if (parent == nullptr) {
+		setTexture(NULL, 0, 0, texture.getBlendMode());
+		return;
+	}
+
+	setTexture(parent->getTexture(), parent->width(), parent->height(), texture.getBlendMode());
+	m_region = texture.getClip();
+
+	/* Modulation of each part goes into its own vertices */
+	m_color = texture.getColor();
+}
+
+void LSpriteBatch::draw(int x, int y, const SDL_Rect* clip)
+{
+	if (m_texture == NULL || m_textureWidth == 0 || m_textureHeight == 0)
+		return;
+
+	/* Source rectangle, whole part by default */
+	SDL_Rect source = m_region;
+	if (clip != NULL)
+		source = { m_region.x + clip->x, m_region.y + clip->y, clip->w, clip->h };
+
+	/* Screen corners */
+	float left = static_cast<float>(x);
+	float top = static_cast<float>(y);
+	float right = static_cast<float>(x + source.w);
+	float bottom = static_cast<float>(y + source.h);
+
+	/* Texture coordinates */
+	float u0 = static_cast<float>(source.x) / m_textureWidth;
+	float v0 = static_cast<float>(source.y) / m_textureHeight;
+	float u1 = static_cast<float>(source.x + source.w) / m_textureWidth;
+	float v1 = static_cast<float>(source.y + source.h) / m_textureHeight;
+
+	/* Two triangles per quad */
+	int first = static_cast<int>(m_vertices.size());
+	m_vertices.push_back({ { left, top }, m_color, { u0, v0 } });
+	m_vertices.push_back({ { right, top }, m_color, { u1, v0 } });
+	m_vertices.push_back({ { right, bottom }, m_color, { u1, v1 } });
+	m_vertices.push_back({ { left, bottom }, m_color, { u0, v1 } });
+
+	m_indices.push_back(first);
+	m_indices.push_back(first + 1);
+	m_indices.push_back(first + 2);
+	m_indices.push_back(first);
+	m_indices.push_back(first + 2);
+	m_indices.push_back(first + 3);
+}
+
+void LSpriteBatch::flush()
+{
+	/* Nothing queued */
+	if (m_indices.empty())
+		return;
+
+	/* Render every quad at once */
+	SDL_SetTextureBlendMode(m_texture, m_blendMode);
+	if (SDL_RenderGeometry(renderer, m_texture, m_vertices.data(), static_cast<int>(m_vertices.size()),
+		m_indices.data(), static_cast<int>(m_indices.size())) < 0)
+		printf("Unable to render sprite batch! SDL_Error: %s\n", SDL_GetError());
+	LTexture::countDraw(m_texture);
+
+	/* Keep the memory for the next batch */
+	m_vertices.clear();
+	m_indices.clear();
+}
+
+int LSpriteBatch::size() const
+{
+	return static_cast<int>(m_vertices.size() / 4);
+}
+
+void LSpriteBatch::setTexture(SDL_Texture* texture, int width, int height, SDL_BlendMode blending)
+{
+	/* Quads can keep piling up */
+	if (texture == m_texture && blending == m_blendMode)
+		return;
+
+	/* Submit quads of previous texture */
+	flush();
+
+	m_texture = texture;
+	m_textureWidth = width;
+	m_textureHeight = height;
+	m_blendMode = blending;
+}
\ No newline at end of file
@@ -0,0 +1,47 @@
+#pragma once
+#include "SDL2/SDL.h"
+#include "LTexture.h"
+#include "LSubTexture.h"
+
+#include <vector>
+
+/* Collects quads sharing one texture and submits them in a single geometry call */
+class LSpriteBatch
+{
+public:
+	LSpriteBatch();
+
+	/* Start collecting quads for given texture, flushes quads of the previous one */
+	void begin(LTexture& texture);
+
+	/* Start collecting quads for part of a texture, parts of the same texture don't flush */
+	void begin(LSubTexture& texture);
+
+	/* Queue texture at given point, clip being relative to current part */
+	void draw(int x, int y, const SDL_Rect* clip = NULL);
+
+	/* Submit queued quads */
+	void flush();
+
+	/* Get amount of queued quads */
+	int size() const;
+
+private:
+	/* Switch texture queued quads share, flushing if it or blending changes */
+	void setTexture(SDL_Texture* texture, int width, int height, SDL_BlendMode blending);
+
+	/* Texture shared by queued quads */
+	SDL_Texture* m_texture;
+	int m_textureWidth, m_textureHeight;
+	SDL_BlendMode m_blendMode;
+
+	/* Part of texture being drawn */
+	SDL_Rect m_region;
+
+	/* Texture modulation baked into vertices */
+	SDL_Color m_color;
+
+	/* Queued geometry */
+	std::vector<SDL_Vertex> m_vertices;
+	std::vector<int> m_indices;
+};
\ No newline at end of file
@@ -0,0 +1,89 @@
+#include "LSubTexture.h"
+
+LSubTexture::LSubTexture() : m_parent(nullptr), m_blendMode(SDL_BLENDMODE_BLEND)
+{
+	m_clip = { 0, 0, 0, 0 };
+	m_color = { 0xFF, 0xFF, 0xFF, 0xFF };
+}
+
+LSubTexture::LSubTexture(LTexture& texture) : m_parent(&texture), m_blendMode(SDL_BLENDMODE_BLEND)
+{
+	m_clip = { 0, 0, texture.width(), texture.height() };
+	m_color = { 0xFF, 0xFF, 0xFF, 0xFF };
+}
+
+LSubTexture::LSubTexture(LTexture& texture, const SDL_Rect& clip) : m_parent(&texture), m_clip(clip),
+	m_blendMode(SDL_BLENDMODE_BLEND)
+{
+	m_color = { 0xFF, 0xFF, 0xFF, 0xFF };
+}
+
+void LSubTexture::setColor(Uint8 red, Uint8 green, Uint8 blue)
+{
+	m_color.r = red;
+	m_color.g = green;
+	m_color.b = blue;
+}
+
+void LSubTexture::setBlendMode(SDL_BlendMode blending)
+{
+	m_blendMode = blending;
+}
+
+void LSubTexture::setAlpha(Uint8 alpha)
+{
+	m_color.a = alpha;
+}
+
+void LSubTexture::render(int x, int y, SDL_Rect* clip, double angle, SDL_Point* center, SDL_RendererFlip flip)
+{
+	if (m_parent == nullptr)
+		return;
+
+	/* Move clip into this part of the texture */
+	SDL_Rect source = m_clip;
+	if (clip != NULL)
+		source = { m_clip.x + clip->x, m_clip.y + clip->y, clip->w, clip->h };
+
+	/* Texture is shared, so its modulation is set right before every draw */
+	m_parent->setColor(m_color.r, m_color.g, m_color.b);
+	m_parent->setAlpha(m_color.a);
+	m_parent->setBlendMode(m_blendMode);
+
+	m_parent->render(x, y, &source, angle, center, flip);
+}
+
+int LSubTexture::width() const
+{
+	return m_clip.w;
+}
+
+int LSubTexture::height() const
+{
+	return m_clip.h;
+}
+
+SDL_Texture* LSubTexture::getTexture() const
+{
+	return m_parent != nullptr ? m_parent->getTexture() : nullptr;
+}
+
+LTexture* LSubTexture::getParent() const
+{
+	return m_parent;
+}
+
+const SDL_Rect& LSubTexture::getClip() const
+{
+	return m_clip;
+}
+
+SDL_Color LSubTexture::getColor() const
+{
+	return m_color;
+}
+
+SDL_BlendMode LSubTexture::getBlendMode() const
+{
+	return m_blendMode;
+}
\ No newline at end of file
@@ -0,0 +1,51 @@
+#pragma once
+#include "SDL2/SDL.h"
+
+#include "LTexture.h"
+
+/* Part of a texture, rendered the same way as a whole LTexture */
+class LSubTexture
+{
+public:
+	LSubTexture();
+	/* Whole of loaded texture */
+	LSubTexture(LTexture& texture);
+	/* Part of texture */
+	LSubTexture(LTexture& texture, const SDL_Rect& clip);
+
+	/* Set color modulation, kept apart from other parts of the texture */
+	void setColor(Uint8 red, Uint8 green, Uint8 blue);
+
+	/* Set blending */
+	void setBlendMode(SDL_BlendMode blending);
+
+	/* Set alpha modulation */
+	void setAlpha(Uint8 alpha);
+
+	/* Render at given point, clip being relative to this part */
+	void render(int x, int y, SDL_Rect* clip = NULL, double angle = 0.0, SDL_Point* center = NULL,
+		SDL_RendererFlip flip = SDL_FLIP_NONE);
+
+	/* Get width */
+	int width() const;
+	/* Get height */
+	int height() const;
+
+	/* Get the hardware texture this is part of */
+	SDL_Texture* getTexture() const;
+	/* Get texture this is part of */
+	LTexture* getParent() const;
+	/* Get part of texture */
+	const SDL_Rect& getClip() const;
+
+	/* Get modulation and blending */
+	SDL_Color getColor() const;
+	SDL_BlendMode getBlendMode() const;
+
+private:
+	LTexture* m_parent;
+	SDL_Rect m_clip;
+
+	SDL_Color m_color;
+	SDL_BlendMode m_blendMode;
+};
\ No newline at end of file
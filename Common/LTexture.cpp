@@ -2,8 +2,16 @@
 
 #include "SDL2/SDL_image.h"
 
+#include <stdio.h>
+#include <string.h>
 
-LTexture::LTexture() : m_width(0), m_height(0), m_texture(nullptr), m_surfacePixels(nullptr)
+
+int LTexture::drawCalls = 0;
+int LTexture::textureSwitches = 0;
+SDL_Texture* LTexture::s_lastTexture = nullptr;
+
+LTexture::LTexture() : m_texture(nullptr), m_surfacePixels(nullptr), m_rawPixels(nullptr), m_rawPitch(0),
+	m_width(0), m_height(0)
 {
 }
 
@@ -13,110 +21,86 @@ LTexture::~LTexture()
 	free();
 }
 
-bool LTexture::loadFromFile(const std::string& path)
+LTexture::LTexture(LTexture&& other) noexcept : m_texture(other.m_texture), m_surfacePixels(other.m_surfacePixels),
+	m_rawPixels(other.m_rawPixels), m_rawPitch(other.m_rawPitch), m_width(other.m_width), m_height(other.m_height)
 {
-	if (!loadPixelsFromFile(path))
-		printf("Couldn't load pixels for %s!\n", path.c_str());
-	else {
-		/* Load texture from pixels */
-		if (!loadFromPixels())
-			printf("Couldn't load texture from pixels from %s!\n", path.c_str());
-	}
-
-	return m_texture;
+	/* Other one doesn't own anything anymore */
+	other.m_texture = nullptr;
+	other.m_surfacePixels = nullptr;
+	other.m_rawPixels = nullptr;
+	other.m_rawPitch = 0;
+	other.m_width = 0;
+	other.m_height = 0;
 }
 
-void LTexture::free()
+LTexture& LTexture::operator=(LTexture&& other) noexcept
 {
-	/* Free texture if it exists */
-	if (m_texture != NULL) {
-		SDL_DestroyTexture(m_texture);
-		m_texture = nullptr;
-		m_width = 0;
-		m_height = 0;
-	}
-
-	/* Free surface if it exists */
-	if (m_surfacePixels) {
-		SDL_FreeSurface(m_surfacePixels);
-		m_surfacePixels = nullptr;
+	if (this != &other) {
+		/* Deallocate own texture before taking over the other one */
+		free();
+
+		m_texture = other.m_texture;
+		m_surfacePixels = other.m_surfacePixels;
+		m_rawPixels = other.m_rawPixels;
+		m_rawPitch = other.m_rawPitch;
+		m_width = other.m_width;
+		m_height = other.m_height;
+
+		other.m_texture = nullptr;
+		other.m_surfacePixels = nullptr;
+		other.m_rawPixels = nullptr;
+		other.m_rawPitch = 0;
+		other.m_width = 0;
+		other.m_height = 0;
 	}
-}
 
-void LTexture::setColor(Uint8 red, Uint8 green, Uint8 blue)
-{
-	/* Modulate texture */
-	SDL_SetTextureColorMod(m_texture, red, green, blue);
+	return *this;
 }
 
-void LTexture::render(int x, int y, SDL_Rect* clip, double angle, SDL_Point* center,
-	SDL_RendererFlip flip)
+bool LTexture::loadFromFile(const std::string& path)
 {
-	/* Set rendering space and render to screen */
-	SDL_Rect renderQuad = { x, y, m_width, m_height };
+	/* Destroy preexisting texture */
+	free();
 
-	/* Set clip rendering dimensions */
-	if (clip != NULL) {
-		renderQuad.w = clip->w;
-		renderQuad.h = clip->h;
+	/* Load image */
+	SDL_Surface* loadedSurface = IMG_Load(path.c_str());
+	if (loadedSurface == NULL) {
+		printf("Unable to load image %s! SDL_image_Error: %s\n", path.c_str(), IMG_GetError());
+		return false;
 	}
 
-	/* Render to screen */
-	SDL_RenderCopyEx(renderer, m_texture, clip, &renderQuad, angle, center, flip);
-}
-
-int LTexture::width() const
-{
-	return m_width;
-}
+	/* Color key image */
+	SDL_SetColorKey(loadedSurface, SDL_TRUE, SDL_MapRGB(loadedSurface->format, 0, 0xFF, 0xFF));
 
-int LTexture::height() const
-{
-	return m_height;
-}
+	/* Create texture */
+	if (!loadFromSurface(loadedSurface))
+		printf("Unable to create texture from %s!\n", path.c_str());
 
-void LTexture::setBlendMode(SDL_BlendMode mode)
-{
-	/* Set blending function */
-	SDL_SetTextureBlendMode(m_texture, mode);
-}
+	/* Clean up */
+	SDL_FreeSurface(loadedSurface);
 
-void LTexture::setAlpha(Uint8 alpha)
-{
-	/* Modulate texture alpha */
-	SDL_SetTextureAlphaMod(m_texture, alpha);
+	/* Return success */
+	return m_texture != NULL;
 }
 
-#if defined(SDL_TTF_MAJOR_VERSION)
-bool LTexture::loadFromRenderedText(std::string textureText, SDL_Color textColor)
+bool LTexture::loadFromSurface(SDL_Surface* surface)
 {
-	/* Clean up old texture */
+	/* Destroy preexisting texture */
 	free();
 
-	/* Render text surface */
-	SDL_Surface* textSurface = TTF_RenderText_Solid(font, textureText.c_str(), textColor);
-	if (textSurface == NULL) {
-		printf("Unable to render text surface! TTF_Error: %s\n", TTF_GetError());
-		return false;
-	}
-
 	/* Create texture from surface pixels */
-	m_texture = SDL_CreateTextureFromSurface(renderer, textSurface);
-	if (m_texture == NULL)
-		printf("Unable to create texture from renderer text! SDL_Error: %s\n", SDL_GetError());
-	else {
-		/* Get image dimensions */
-		m_width = textSurface->w;
-		m_height = textSurface->h;
+	m_texture = SDL_CreateTextureFromSurface(renderer, surface);
+	if (m_texture == NULL) {
+		printf("Unable to create texture from surface! SDL_Error: %s\n", SDL_GetError());
+		return false;
 	}
 
-	/* Clean up */
-	SDL_FreeSurface(textSurface);
+	/* Get image dimensions */
+	m_width = surface->w;
+	m_height = surface->h;
 
-	/* Return success */
-	return m_texture != NULL;
+	return true;
 }
-#endif
 
 bool LTexture::loadPixelsFromFile(const std::string& path)
 {
@@ -128,7 +112,9 @@ bool LTexture::loadPixelsFromFile(const std::string& path)
 	if (!loadedSurface)
 		printf("Couldn't load image %s! IMG_Error: %s\n", path.c_str(), IMG_GetError());
 	else {
-		m_surfacePixels = SDL_ConvertSurfaceFormat(loadedSurface, SDL_GetWindowPixelFormat(window), 0);
+		/* Window is the one renderer draws into */
+		Uint32 format = SDL_GetWindowPixelFormat(SDL_RenderGetWindow(renderer));
+		m_surfacePixels = SDL_ConvertSurfaceFormat(loadedSurface, format, 0);
 		if (!m_surfacePixels)
 			printf("Couldn't convert loaded surface to display format! SDL_Error: %s\n", SDL_GetError());
 		else {
@@ -172,6 +158,99 @@ bool LTexture::loadFromPixels()
 	return m_texture;
 }
 
+bool LTexture::createBlank(int width, int height, SDL_TextureAccess access)
+{
+	/* Free preexisting texture */
+	free();
+
+	/* Create uninitialized texture */
+	m_texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, access, width, height);
+	if (!m_texture)
+		printf("Couldn't create blank texture! SDL_Error: %s\n", SDL_GetError());
+	else {
+		m_width = width;
+		m_height = height;
+	}
+
+	return m_texture;
+}
+
+void LTexture::free()
+{
+	/* Free texture if it exists */
+	if (m_texture != NULL) {
+		SDL_DestroyTexture(m_texture);
+		m_texture = nullptr;
+		m_rawPixels = nullptr;
+		m_rawPitch = 0;
+	}
+
+	/* Free surface if it exists */
+	if (m_surfacePixels) {
+		SDL_FreeSurface(m_surfacePixels);
+		m_surfacePixels = nullptr;
+	}
+
+	m_width = 0;
+	m_height = 0;
+}
+
+void LTexture::setColor(Uint8 red, Uint8 green, Uint8 blue)
+{
+	/* Modulate texture */
+	SDL_SetTextureColorMod(m_texture, red, green, blue);
+}
+
+void LTexture::setBlendMode(SDL_BlendMode mode)
+{
+	/* Set blending function */
+	SDL_SetTextureBlendMode(m_texture, mode);
+}
+
+void LTexture::setAlpha(Uint8 alpha)
+{
+	/* Modulate texture alpha */
+	SDL_SetTextureAlphaMod(m_texture, alpha);
+}
+
+void LTexture::render(int x, int y, SDL_Rect* clip, double angle, SDL_Point* center,
+	SDL_RendererFlip flip)
+{
+	/* Set rendering space and render to screen */
+	SDL_Rect renderQuad = { x, y, m_width, m_height };
+
+	/* Set clip rendering dimensions */
+	if (clip != NULL) {
+		renderQuad.w = clip->w;
+		renderQuad.h = clip->h;
+	}
+
+	/* Render to screen */
+	SDL_RenderCopyEx(renderer, m_texture, clip, &renderQuad, angle, center, flip);
+	countDraw(m_texture);
+}
+
+void LTexture::setAsRenderTarget()
+{
+	/* Make self render target */
+	SDL_SetRenderTarget(renderer, m_texture);
+}
+
+int LTexture::width() const
+{
+	return m_width;
+}
+
+int LTexture::height() const
+{
+	return m_height;
+}
+
+SDL_Texture* LTexture::getTexture() const
+{
+	return m_texture;
+}
+
 Uint32* LTexture::getPixels32()
 {
 	Uint32* pixels = nullptr;
@@ -180,38 +259,46 @@ Uint32* LTexture::getPixels32()
 	return pixels;
 }
 
-Uint32 LTexture::getPitch32() const
+const Uint32* LTexture::getPixels32() const
 {
-	Uint32 pitch = 0;
+	const Uint32* pixels = nullptr;
 	if (m_surfacePixels)
-		pitch = m_surfacePixels->pitch / 4;
-	return pitch;
+		pixels = static_cast<const Uint32*>(m_surfacePixels->pixels);
+	return pixels;
 }
 
 Uint32 LTexture::getPixel32(int x, int y) const
 {
 	/* Convert the pixels to 32 bit */
 	Uint32* pixels = static_cast<Uint32*>(m_surfacePixels->pixels);
-	
+
 	/* Get the pixel requested */
 	return pixels[(y * getPitch32()) + x];
 }
 
-bool LTexture::createBlank(int width, int height, SDL_TextureAccess access)
+Uint32 LTexture::getPitch32() const
 {
-	/* Free preexisting texture */
-	free();
+	Uint32 pitch = 0;
+	if (m_surfacePixels)
+		pitch = m_surfacePixels->pitch / 4;
+	return pitch;
+}
 
-	/* Create uninitialized texture */
-	m_texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, access, width, height);
-	if (!m_texture)
-		printf("Couldn't create streamable blank texture! SDL_Error: %s\n", SDL_GetError());
-	else {
-		m_width = width;
-		m_height = height;
-	}
+const SDL_PixelFormat* LTexture::getPixelFormat() const
+{
+	const SDL_PixelFormat* format = nullptr;
+	if (m_surfacePixels)
+		format = m_surfacePixels->format;
+	return format;
+}
 
-	return m_texture;
+void LTexture::copyRawPixels32(void* pixels)
+{
+	/* Texture is locked */
+	if (m_rawPixels) {
+		/* Copy to locked pixels */
+		memcpy(m_rawPixels, pixels, m_rawPitch * m_height);
+	}
 }
 
 bool LTexture::lockTexture()
@@ -253,17 +340,10 @@ bool LTexture::unlockTexture()
 	return success;
 }
 
-void LTexture::copyRawPixels32(void* pixels)
-{
-	/* Texture is locked */
-	if (m_rawPixels) {
-		/* Copy to locked pixels */
-		memcpy(m_rawPixels, pixels, m_rawPitch * m_height);
-	}
-}
-
-void LTexture::setAsRenderTarget()
+void LTexture::countDraw(SDL_Texture* texture)
 {
-	/* Make self render target */
-	SDL_SetRenderTarget(renderer, m_texture);
+	++drawCalls;
+	if (texture != s_lastTexture)
+		++textureSwitches;
+	s_lastTexture = texture;
 }
\ No newline at end of file
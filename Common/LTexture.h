@@ -3,29 +3,38 @@
 
 #include <string>
 
-/* Global window and renderer */
+/* Global renderer */
 extern SDL_Renderer* renderer;
-extern SDL_Window* window;
 
 #if defined(SDL_TTF_MAJOR_VERSION)
 /* Global font */
 extern TTF_Font* font;
 #endif
 
-/* Texture wrapper class */
+/* Texture wrapper class, owns its texture so it can be moved but not copied */
 class LTexture
 {
 public:
 	LTexture();
 	~LTexture();
 
+	/* Take texture over from other one, leaving it empty */
+	LTexture(LTexture&& other) noexcept;
+	LTexture& operator=(LTexture&& other) noexcept;
+
+	/* Copies would destroy the same texture twice */
+	LTexture(const LTexture&) = delete;
+	LTexture& operator=(const LTexture&) = delete;
+
 	/* Load texture from given path */
 	bool loadFromFile(const std::string& path);
 
-	/* Load image into pixel buffer */
-	bool loadPixelsFromFile(const std::string& path);
+	/* Create texture from surface pixels as they are */
+	bool loadFromSurface(SDL_Surface* surface);
 
-	/* Create image from preloaded pixels */
+	/* Load pixels from file, converted to window format */
+	bool loadPixelsFromFile(const std::string& path);
+	/* Create texture from loaded pixels */
 	bool loadFromPixels();
 
 #if defined(SDL_TTF_MAJOR_VERSION)
@@ -34,7 +43,7 @@ public:
 #endif
 
 	/* Create blank texture */
-	bool createBlank(int width, int height, SDL_TextureAccess access);
+	bool createBlank(int width, int height, SDL_TextureAccess access = SDL_TEXTUREACCESS_STREAMING);
 
 	/* Deallocate memory */
 	void free();
@@ -52,7 +61,7 @@ public:
 	void render(int x, int y, SDL_Rect* clip = NULL, double angle = 0.0, SDL_Point* center = NULL,
 		SDL_RendererFlip flip = SDL_FLIP_NONE);
 
-	/* Set self as render target */
+	/* Set self as rendering target */
 	void setAsRenderTarget();
 
 	/* Get width */
@@ -60,18 +69,32 @@ public:
 	/* Get height */
 	int height() const;
 
+	/* Get the hardware texture */
+	SDL_Texture* getTexture() const;
+
 	/* Pixel accesors */
 	Uint32* getPixels32();
+	const Uint32* getPixels32() const;
 	Uint32 getPixel32(int x, int y) const;
 	Uint32 getPitch32() const;
+	const SDL_PixelFormat* getPixelFormat() const;
 	void copyRawPixels32(void* pixels);
 	bool lockTexture();
 	bool unlockTexture();
 
+	/* Count draw call using given texture */
+	static void countDraw(SDL_Texture* texture);
+
+public:
+	/* Amount of draw calls issued since last reset */
+	static int drawCalls;
+	/* Amount of draw calls using different texture than the one before, since last reset */
+	static int textureSwitches;
+
 private:
 	/* The actual hardware texture */
 	SDL_Texture* m_texture;
-	
+
 	/* Surface pixels */
 	SDL_Surface* m_surfacePixels;
 
@@ -82,4 +105,7 @@ private:
 	/* Image dimensions */
 	int m_width;
 	int m_height;
+
+	/* Texture used by last draw call */
+	static SDL_Texture* s_lastTexture;
 };
\ No newline at end of file
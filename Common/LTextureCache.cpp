@@ -0,0 +1,183 @@
+#include "LTextureCache.h"
+
+#include "SDL2/SDL_image.h"
+
+#include <stdio.h>
+
+
+LTextureCache::LTextureCache(size_t budget) : m_budget(budget), m_bytes(0), m_hits(0), m_misses(0), m_evictions(0)
+{
+}
+
+LTextureCache::~LTextureCache()
+{
+	clear();
+}
+
+LTextureCache::Handle LTextureCache::acquire(const std::string& path)
+{
+	/* Path loaded before */
+	auto known = m_paths.find(path);
+	if (known != m_paths.end()) {
+		Entry& entry = m_entries[known->second];
+		touch(entry);
+		++m_hits;
+		return entry.texture;
+	}
+
+	/* Read file, its content is the key */
+	size_t size = 0;
+	void* data = SDL_LoadFile(path.c_str(), &size);
+	if (data == NULL) {
+		printf("Unable to read image %s! SDL_Error: %s\n", path.c_str(), SDL_GetError());
+		return nullptr;
+	}
+	Uint64 key = hash(data, size);
+
+	/* Same image loaded under another path */
+	auto found = m_entries.find(key);
+	if (found != m_entries.end()) {
+		SDL_free(data);
+		found->second.paths.push_back(path);
+		m_paths[path] = key;
+		touch(found->second);
+		++m_hits;
+		return found->second.texture;
+	}
+
+	/* Decode from the bytes already read */
+	++m_misses;
+	SDL_Surface* loadedSurface = IMG_Load_RW(SDL_RWFromConstMem(data, static_cast<int>(size)), 1);
+	SDL_free(data);
+	if (loadedSurface == NULL) {
+		printf("Unable to load image %s! SDL_image_Error: %s\n", path.c_str(), IMG_GetError());
+		return nullptr;
+	}
+
+	/* Color key image */
+	SDL_SetColorKey(loadedSurface, SDL_TRUE, SDL_MapRGB(loadedSurface->format, 0, 0xFF, 0xFF));
+
+	Handle texture = std::make_shared<LTexture>();
+	bool loaded = texture->loadFromSurface(loadedSurface);
+	SDL_FreeSurface(loadedSurface);
+	if (!loaded) {
+		printf("Unable to create texture from %s!\n", path.c_str());
+		return nullptr;
+	}
+
+	/* Estimate memory from texture format */
+	Uint32 format = 0;
+	SDL_QueryTexture(texture->getTexture(), &format, NULL, NULL, NULL);
+	int bytesPerPixel = SDL_BYTESPERPIXEL(format) > 0 ? SDL_BYTESPERPIXEL(format) : 4;
+
+	Entry& entry = m_entries[key];
+	entry.texture = texture;
+	entry.bytes = static_cast<size_t>(texture->width()) * texture->height() * bytesPerPixel;
+	entry.paths.push_back(path);
+	m_recent.push_front(key);
+	entry.recent = m_recent.begin();
+	m_paths[path] = key;
+	m_bytes += entry.bytes;
+
+	/* Make room, new texture is held by caller so it stays */
+	trim();
+	return texture;
+}
+
+void LTextureCache::setBudget(size_t budget)
+{
+	m_budget = budget;
+	trim();
+}
+
+void LTextureCache::trim()
+{
+	/* Walk from least recently used, skipping textures still held */
+	auto it = m_recent.end();
+	while (m_bytes > m_budget && it != m_recent.begin()) {
+		--it;
+		Entry& entry = m_entries[*it];
+		if (entry.texture.use_count() > 1)
+			continue;
+
+		/* Step past it first, evicting removes it from the list */
+		Uint64 key = *it++;
+		evict(key);
+	}
+}
+
+void LTextureCache::clear()
+{
+	/* Holders keep their LTexture, but without the hardware texture */
+	for (auto& pair : m_entries)
+		pair.second.texture->free();
+
+	m_entries.clear();
+	m_paths.clear();
+	m_recent.clear();
+	m_bytes = 0;
+}
+
+int LTextureCache::hits() const
+{
+	return m_hits;
+}
+
+int LTextureCache::misses() const
+{
+	return m_misses;
+}
+
+int LTextureCache::evictions() const
+{
+	return m_evictions;
+}
+
+int LTextureCache::size() const
+{
+	return static_cast<int>(m_entries.size());
+}
+
+size_t LTextureCache::bytes() const
+{
+	return m_bytes;
+}
+
+void LTextureCache::printStats() const
+{
+	printf("Texture cache: %d hits, %d misses, %d evictions, %d textures in %.1f of %.1f KB\n", m_hits, m_misses,
+		m_evictions, size(), m_bytes / 1024.0, m_budget / 1024.0);
+}
+
+Uint64 LTextureCache::hash(const void* data, size_t size)
+{
+	/* 64 bit FNV-1a */
+	const Uint8* bytes = static_cast<const Uint8*>(data);
+	Uint64 result = 14695981039346656037ull;
+	for (size_t i = 0; i < size; ++i) {
+		result ^= bytes[i];
+		result *= 1099511628211ull;
+	}
+	return result;
+}
+
+void LTextureCache::touch(Entry& entry)
+{
+	m_recent.splice(m_recent.begin(), m_recent, entry.recent);
+}
+
+void LTextureCache::evict(Uint64 key)
+{
+	auto found = m_entries.find(key);
+	if (found == m_entries.end())
+		return;
+
+	Entry& entry = found->second;
+	for (const std::string& path : entry.paths)
+		m_paths.erase(path);
+	m_recent.erase(entry.recent);
+	m_bytes -= entry.bytes;
+
+	m_entries.erase(found);
+	++m_evictions;
+}
\ No newline at end of file
@@ -0,0 +1,81 @@
+#pragma once
+#include "SDL2/SDL.h"
+
+#include "LTexture.h"
+
+#include <string>
+#include <list>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+
+/* Shares loaded textures, so the same image is only ever loaded once */
+class LTextureCache
+{
+public:
+	/* Shared texture, stays loaded as long as anyone holds it */
+	typedef std::shared_ptr<LTexture> Handle;
+
+	/* Bytes of texture memory kept by default */
+	static const size_t DEFAULT_BUDGET = 64 * 1024 * 1024;
+
+	LTextureCache(size_t budget = DEFAULT_BUDGET);
+	~LTextureCache();
+
+	/* Get texture of image at path, loading it only if no path with the same content was loaded yet */
+	Handle acquire(const std::string& path);
+
+	/* Set bytes of texture memory to keep, evicting unused textures over it */
+	void setBudget(size_t budget);
+	/* Evict unused textures, least recently used first, until cache fits into budget */
+	void trim();
+
+	/* Free every texture, handles still held are left empty */
+	void clear();
+
+	/* Get amount of acquires served from cache and loaded from file */
+	int hits() const;
+	int misses() const;
+	/* Get amount of textures evicted */
+	int evictions() const;
+
+	/* Get amount of cached textures and bytes they take */
+	int size() const;
+	size_t bytes() const;
+
+	/* Print hits, misses and memory used */
+	void printStats() const;
+
+private:
+	/* Texture of one image content, which can be known under several paths */
+	struct Entry
+	{
+		Handle texture;
+		size_t bytes;
+		std::list<Uint64>::iterator recent;
+		std::vector<std::string> paths;
+	};
+
+	/* Hash file content */
+	static Uint64 hash(const void* data, size_t size);
+
+	/* Move entry to front of recently used list */
+	void touch(Entry& entry);
+
+	/* Drop entry, forgetting its paths */
+	void evict(Uint64 key);
+
+	size_t m_budget;
+	size_t m_bytes;
+
+	/* Entries by content hash, and content hash by path */
+	std::unordered_map<Uint64, Entry> m_entries;
+	std::unordered_map<std::string, Uint64> m_paths;
+	/* Content hashes, most recently used first */
+	std::list<Uint64> m_recent;
+
+	int m_hits, m_misses, m_evictions;
+};
+
+/* Global texture cache */
+extern LTextureCache textureCache;
\ No newline at end of file
@@ -0,0 +1,37 @@
+#include "SDL2/SDL.h"
+#include "SDL2/SDL_ttf.h"
+
+#include "LTexture.h"
+
+#include <stdio.h>
+
+/* Kept apart from LTexture.cpp, so only programs rendering text need SDL_ttf and a global font */
+
+bool LTexture::loadFromRenderedText(std::string textureText, SDL_Color textColor)
+{
+	/* Clean up old texture */
+	free();
+
+	/* Render text surface */
+	SDL_Surface* textSurface = TTF_RenderText_Solid(font, textureText.c_str(), textColor);
+	if (textSurface == NULL) {
+		printf("Unable to render text surface! TTF_Error: %s\n", TTF_GetError());
+		return false;
+	}
+
+	/* Create texture from surface pixels */
+	m_texture = SDL_CreateTextureFromSurface(renderer, textSurface);
+	if (m_texture == NULL)
+		printf("Unable to create texture from renderer text! SDL_Error: %s\n", SDL_GetError());
+	else {
+		/* Get image dimensions */
+		m_width = textSurface->w;
+		m_height = textSurface->h;
+	}
+
+	/* Clean up */
+	SDL_FreeSurface(textSurface);
+
+	/* Return success */
+	return m_texture != NULL;
+}
\ No newline at end of file
@@ -0,0 +1,135 @@
+#include "LTimer.h"
+
+LTimer::LTimer(Resolution resolution) : m_resolution(resolution), m_startCounts(0), m_pausedCounts(0),
+	m_paused(false), m_started(false)
+{
+	m_frequency = resolution == Resolution::HIGH ? SDL_GetPerformanceFrequency() : 1000;
+}
+
+void LTimer::start()
+{
+	/* Start the timer */
+	m_started = true;
+
+	/* Unpause the timer */
+	m_paused = false;
+
+	/* Get the current clock time */
+	m_startCounts = now();
+	m_pausedCounts = 0;
+}
+
+void LTimer::stop()
+{
+	/* Stop the timer */
+	m_started = false;
+
+	/* Unpause the timer */
+	m_paused = false;
+
+	/* Clear tick variables */
+	m_startCounts = 0;
+	m_pausedCounts = 0;
+}
+
+void LTimer::pause()
+{
+	/* If the timer is running and isn't already paused */
+	if (m_started && !m_paused) {
+		/* Pause the timer */
+		m_paused = true;
+
+		/* Calculate the paused ticks */
+		m_pausedCounts = now() - m_startCounts;
+		m_startCounts = 0;
+	}
+}
+
+void LTimer::unpause()
+{
+	/* If the timer is running and is paused */
+	if (m_started && m_paused) {
+		/* Unpause the timer */
+		m_paused = false;
+
+		/* Reset the starting ticks */
+		m_startCounts = now() - m_pausedCounts;
+
+		/* Reset the paused ticks */
+		m_pausedCounts = 0;
+	}
+}
+
+Uint32 LTimer::getTicks() const
+{
+	return static_cast<Uint32>(getNanoseconds() / 1000000);
+}
+
+Uint64 LTimer::getNanoseconds() const
+{
+	/* Whole seconds and the rest apart, so multiplying doesn't overflow */
+	Uint64 counts = getCounts();
+	return counts / m_frequency * 1000000000 + counts % m_frequency * 1000000000 / m_frequency;
+}
+
+double LTimer::getSeconds() const
+{
+	return static_cast<double>(getCounts()) / m_frequency;
+}
+
+double LTimer::restart()
+{
+	/* Read the clock once, so no time gets lost between reading and starting */
+	Uint64 time = now();
+	double seconds = 0.0;
+	if (m_started)
+		seconds = static_cast<double>(m_paused ? m_pausedCounts : time - m_startCounts) / m_frequency;
+
+	m_started = true;
+	m_paused = false;
+	m_startCounts = time;
+	m_pausedCounts = 0;
+
+	return seconds;
+}
+
+bool LTimer::isStarted() const
+{
+	return m_started;
+}
+
+bool LTimer::isPaused() const
+{
+	return m_paused && m_started;
+}
+
+LTimer::Resolution LTimer::getResolution() const
+{
+	return m_resolution;
+}
+
+Uint64 LTimer::now() const
+{
+	return m_resolution == Resolution::HIGH ? SDL_GetPerformanceCounter() : SDL_GetTicks64();
+}
+
+Uint64 LTimer::getCounts() const
+{
+	/* Actual timer time */
+	Uint64 counts = 0;
+
+	/* If the timer is running */
+	if (m_started) {
+		/* If the timer is paused */
+		if (m_paused) {
+			/* Return the number of counts when timer was paused */
+			counts = m_pausedCounts;
+		}
+		else {
+			/* Return the current time minus the start time */
+			counts = now() - m_startCounts;
+		}
+	}
+
+	return counts;
+}
\ No newline at end of file
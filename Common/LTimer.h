@@ -0,0 +1,57 @@
+#pragma once
+#include "SDL2/SDL.h"
+
+/* The application time based timer */
+class LTimer
+{
+public:
+	/* Clock the timer reads */
+	enum class Resolution
+	{
+		/* SDL_GetTicks64, whole milliseconds */
+		MILLISECONDS,
+		/* SDL_GetPerformanceCounter, as fine as the platform's counter goes */
+		HIGH
+	};
+
+	LTimer(Resolution resolution = Resolution::MILLISECONDS);
+
+	/* Various clock actions */
+	void start();
+	void stop();
+	void pause();
+	void unpause();
+
+	/* Get the timer's time */
+	Uint32 getTicks() const;
+	Uint64 getNanoseconds() const;
+	double getSeconds() const;
+
+	/* Get the timer's time in seconds and start over from now */
+	double restart();
+
+	/* Check the timer's status */
+	bool isStarted() const;
+	bool isPaused() const;
+
+	/* Get the clock the timer reads */
+	Resolution getResolution() const;
+
+private:
+	/* Read the clock */
+	Uint64 now() const;
+	/* Get the timer's time in clock counts */
+	Uint64 getCounts() const;
+
+	/* The clock and how many counts it makes per second */
+	Resolution m_resolution;
+	Uint64 m_frequency;
+
+	/* The clock time when the timer started */
+	Uint64 m_startCounts;
+	/* The counts stored when the timer was paused */
+	Uint64 m_pausedCounts;
+	/* The timer status */
+	bool m_paused;
+	bool m_started;
+};
\ No newline at end of file
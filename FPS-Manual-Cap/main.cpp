@@ -4,8 +4,12 @@
 
 #include "LTexture.h"
 #include "LTimer.h"
+#include "LGlyphAtlas.h"
+#include "LFramePacer.h"
+#include "LProfiler.h"
 
 #include <stdio.h>
+#include <string.h>
 #include <string>
 #include <sstream>
 
@@ -16,13 +20,18 @@ bool init();
 bool loadMedia();
 /* Clean up */
 void close();
+/* Route SDL memory functions through counting ones */
+void countSDLAllocations();
+/* Compare rendering FPS text through a new texture each frame and through glyph atlas */
+bool runBenchmark();
+/* Compare frame times of sleeping and precise pacing, false if precise pacing isn't closer to target */
+bool runPacingBenchmark();
 
 
 /* Screen constants */
 const int SCREEN_WIDTH = 640;
 const int SCREEN_HEIGHT = 480;
 const int SCREEN_FPS = 60;
-const int SCREEN_TICKS_PER_FRAME = 1000 / SCREEN_FPS;
 
 /* Global window and renderer */
 SDL_Window* window = nullptr;
@@ -31,12 +40,24 @@ SDL_Renderer* renderer = nullptr;
 /* Global font */
 TTF_Font* font = nullptr;
 
-/* Text texture */
-LTexture infoText;
+/* Glyphs of the font text is drawn from */
+LGlyphAtlas infoText;
+
+/* SDL allocations made since benchmark started counting */
+size_t sdlAllocations = 0;
 
 
 int main(int argc, char* args[])
 {
+	/* Benchmark mode, SDL memory functions have to be replaced before anything is allocated */
+	bool benchmark = argc > 1 && strcmp(args[1], "--bench") == 0;
+	if (benchmark) {
+		SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+		SDL_SetHint(SDL_HINT_RENDER_DRIVER, "software");
+		SDL_SetHint(SDL_HINT_RENDER_VSYNC, "0");
+		countSDLAllocations();
+	}
+
 	/* Initialize */
 	if (!init()) {
 		printf("Failed to initialize!\n");
@@ -51,6 +72,18 @@ int main(int argc, char* args[])
 		return -1;
 	}
 
+	if (benchmark) {
+		/* Either benchmark can be run alone by naming it */
+		std::string only = argc > 2 ? args[2] : "";
+		bool passed = true;
+		if (only.empty() || only == "text")
+			passed = runBenchmark() && passed;
+		if (only.empty() || only == "pacing")
+			passed = runPacingBenchmark() && passed;
+		close();
+		return passed ? 0 : -1;
+	}
+
 	bool quit = false;
 	SDL_Event e;
 
@@ -58,9 +91,9 @@ int main(int argc, char* args[])
 	SDL_Color textColor = { 0, 0, 0, 255 };
 
 	/* Frames Per Second timer */
-	LTimer fpsTimer;
-	/* Frames Per Second cap timer */
-	LTimer capTimer;
+	LTimer fpsTimer(LTimer::Resolution::HIGH);
+	/* Frames Per Second cap, sleeps most of the frame and spins the rest so frames don't jitter between 16 and 17 ms */
+	LFramePacer pacer(SCREEN_FPS);
 
 	/* In memory text stream */
 	std::stringstream timeText;
@@ -68,47 +101,76 @@ int main(int argc, char* args[])
 	/* Start counting FPS */
 	int countFrames = 0;
 	fpsTimer.start();
+	pacer.start();
+
+	/* Frame time graph, F1 shows it and F2 writes Chrome trace of recent frames */
+	bool showProfile = false;
+	const SDL_Rect profileArea = { 10, 10, 2 * LProfiler::FRAME_HISTORY, 80 };
+	PROFILE_THREAD("Main");
 
 	while (!quit) {
-		/* Start cap timer */
-		capTimer.start();
+		{
+			PROFILE_ZONE("Events");
+			while (SDL_PollEvent(&e)) {
+				if (e.type == SDL_QUIT)
+					quit = true;
+				else if (e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_F1)
+					showProfile = !showProfile;
+				else if (e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_F2) {
+					if (LProfiler::exportChromeTrace("profile.json"))
+						printf("Wrote profile.json\n");
+				}
+			}
+		}
+
+		{
+			PROFILE_ZONE("Update");
 
-		while (SDL_PollEvent(&e)) {
-			if (e.type == SDL_QUIT)
-				quit = true;
+			/* Calculate and correct FPS */
+			float avgFPS = static_cast<float>(countFrames / fpsTimer.getSeconds());
+			if (avgFPS > 2000000)
+				avgFPS = 0;
+
+			/* Set text to be rendered */
+			timeText.str("");
+			timeText << "Average Frames Per Second (with cap): " << avgFPS;
 		}
 
-		/* Calculate and correct FPS */
-		float avgFPS = countFrames / (fpsTimer.getTicks() / 1000.0f);
-		if (avgFPS > 2000000)
-			avgFPS = 0;
+		{
+			PROFILE_ZONE("Render");
 
-		/* Set text to be rendered */
-		timeText.str("");
-		timeText << "Average Frames Per Second (with cap): " << avgFPS;
+			/* Clear screen */
+			SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
+			SDL_RenderClear(renderer);
 
-		/* Load text */
-		if (!infoText.loadFromRenderedText(timeText.str(), textColor))
-			printf("Couldn't render FPS text texture!\n");
+			/* Render text straight from the glyphs */
+			infoText.render((SCREEN_WIDTH - infoText.textWidth(timeText.str())) / 2,
+				(SCREEN_HEIGHT - infoText.lineHeight()) / 2, timeText.str(), textColor);
 
-		/* Clear screen */
-		SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
-		SDL_RenderClear(renderer);
-		
-		/* Render texture */
-		infoText.render((SCREEN_WIDTH - infoText.width()) / 2, (SCREEN_HEIGHT - infoText.height()) / 2);
+			if (showProfile)
+				LProfiler::renderOverlay(profileArea, pacer.getTargetSeconds());
+		}
 
-		/* Update screen */
-		SDL_RenderPresent(renderer);
-		++countFrames;
+		{
+			PROFILE_ZONE("Present");
+
+			/* Update screen */
+			SDL_RenderPresent(renderer);
+			++countFrames;
+		}
+
+		{
+			PROFILE_ZONE("Wait");
 
-		/* If frame finished early */
-		int frameTicks = capTimer.getTicks();
-		if (frameTicks < SCREEN_TICKS_PER_FRAME) {
 			/* Wait remaining time */
-			SDL_Delay(SCREEN_TICKS_PER_FRAME - frameTicks);
+			pacer.wait();
 		}
+
+		PROFILE_FRAME();
 	}
+
+	/* Show how steady frames were */
+	pacer.printHistogram();
 	
 	/* Clean up */
 	close();
@@ -174,13 +236,18 @@ bool loadMedia()
 		printf("Couldn't load lazy font! TTF_Error: %s\n", TTF_GetError());
 		success = false;
 	}
+	/* Create atlas for its glyphs */
+	else if (!infoText.create(font)) {
+		printf("Couldn't create glyph atlas!\n");
+		success = false;
+	}
 
 	return success;
 }
 
 void close()
 {
-	/* Free textures */
+	/* Free glyph atlas */
 	infoText.free();
 
 	/* Close the font */
@@ -197,4 +264,142 @@ void close()
 	TTF_Quit();
 	IMG_Quit();
 	SDL_Quit();
-} 
\ No newline at end of file
+} 
+
+
+/* SDL memory functions being wrapped */
+SDL_malloc_func baseMalloc = nullptr;
+SDL_calloc_func baseCalloc = nullptr;
+SDL_realloc_func baseRealloc = nullptr;
+SDL_free_func baseFree = nullptr;
+
+void* SDLCALL countedMalloc(size_t size)
+{
+	++sdlAllocations;
+	return baseMalloc(size);
+}
+
+void* SDLCALL countedCalloc(size_t count, size_t size)
+{
+	++sdlAllocations;
+	return baseCalloc(count, size);
+}
+
+void* SDLCALL countedRealloc(void* memory, size_t size)
+{
+	++sdlAllocations;
+	return baseRealloc(memory, size);
+}
+
+void SDLCALL countedFree(void* memory)
+{
+	baseFree(memory);
+}
+
+void countSDLAllocations()
+{
+	SDL_GetMemoryFunctions(&baseMalloc, &baseCalloc, &baseRealloc, &baseFree);
+	if (SDL_SetMemoryFunctions(countedMalloc, countedCalloc, countedRealloc, countedFree) < 0)
+		printf("Couldn't count SDL allocations! SDL_Error: %s\n", SDL_GetError());
+}
+
+bool runBenchmark()
+{
+	const int FRAMES = 600;
+	SDL_Color textColor = { 0, 0, 0, 255 };
+
+	/* Counter the way the demo shows it, slowly settling around 60 */
+	std::stringstream timeText;
+	auto setFrameText = [&](int frame) {
+		timeText.str("");
+		timeText << "Average Frames Per Second (with cap): " << 60.0f - 30.0f / (frame + 1) + (frame % 7) * 0.0013f;
+	};
+
+	Uint64 frequency = SDL_GetPerformanceFrequency();
+	double msPerFrame[2];
+	double allocationsPerFrame[2];
+
+	/* Render text into a new texture every frame, like before */
+	LTexture texture;
+	size_t allocations = sdlAllocations;
+	Uint64 start = SDL_GetPerformanceCounter();
+	for (int frame = 0; frame < FRAMES; ++frame) {
+		setFrameText(frame);
+		if (!texture.loadFromRenderedText(timeText.str(), textColor)) {
+			printf("Couldn't render FPS text texture!\n");
+			return false;
+		}
+
+		SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
+		SDL_RenderClear(renderer);
+		texture.render((SCREEN_WIDTH - texture.width()) / 2, (SCREEN_HEIGHT - texture.height()) / 2);
+		SDL_RenderPresent(renderer);
+	}
+	msPerFrame[0] = (SDL_GetPerformanceCounter() - start) * 1000.0 / frequency / FRAMES;
+	allocationsPerFrame[0] = static_cast<double>(sdlAllocations - allocations) / FRAMES;
+	texture.free();
+
+	/* Warm atlas up with every character the counter can show */
+	infoText.preload("Average Frames Per Second (with cap): 0123456789.-+e");
+	int rasterized = infoText.rasterizedGlyphs();
+	setFrameText(0);
+	infoText.render(0, 0, timeText.str(), textColor);
+
+	/* Draw the same text from the atlas */
+	allocations = sdlAllocations;
+	start = SDL_GetPerformanceCounter();
+	for (int frame = 0; frame < FRAMES; ++frame) {
+		setFrameText(frame);
+
+		SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
+		SDL_RenderClear(renderer);
+		infoText.render((SCREEN_WIDTH - infoText.textWidth(timeText.str())) / 2,
+			(SCREEN_HEIGHT - infoText.lineHeight()) / 2, timeText.str(), textColor);
+		SDL_RenderPresent(renderer);
+	}
+	msPerFrame[1] = (SDL_GetPerformanceCounter() - start) * 1000.0 / frequency / FRAMES;
+	allocationsPerFrame[1] = static_cast<double>(sdlAllocations - allocations) / FRAMES;
+
+	printf("%d frames of \"%s\"\n", FRAMES, timeText.str().c_str());
+	printf("texture per frame: %8.4f ms/frame, %6.2f SDL allocations/frame\n", msPerFrame[0], allocationsPerFrame[0]);
+	printf("glyph atlas:       %8.4f ms/frame, %6.2f SDL allocations/frame (%d glyphs rasterized)\n",
+		msPerFrame[1], allocationsPerFrame[1], infoText.rasterizedGlyphs());
+
+	/* Steady state mustn't rasterize anything or create textures */
+	bool passed = infoText.rasterizedGlyphs() == rasterized && allocationsPerFrame[1] < allocationsPerFrame[0];
+	printf("Glyph atlas benchmark %s\n", passed ? "passed" : "FAILED");
+	return passed;
+}
+
+bool runPacingBenchmark()
+{
+	const int FRAMES = 180;
+	/* Simulated work per frame, deliberately not a whole amount of milliseconds */
+	const double WORK_SECONDS = 0.0037;
+	const double frequency = static_cast<double>(SDL_GetPerformanceFrequency());
+
+	const LFramePacer::Mode modes[2] = { LFramePacer::Mode::SLEEP, LFramePacer::Mode::PRECISE };
+	const char* names[2] = { "SDL_Delay", "precise" };
+	double meanError[2];
+
+	for (int i = 0; i < 2; ++i) {
+		LFramePacer pacer(SCREEN_FPS, modes[i]);
+		pacer.start();
+		for (int frame = 0; frame < FRAMES; ++frame) {
+			/* Busy work, sleeping would add the scheduler's jitter */
+			Uint64 until = SDL_GetPerformanceCounter() + static_cast<Uint64>(WORK_SECONDS * frequency);
+			while (SDL_GetPerformanceCounter() < until) {
+			}
+
+			pacer.wait();
+		}
+
+		printf("%s pacing: ", names[i]);
+		pacer.printHistogram();
+		meanError[i] = pacer.getMeanErrorSeconds();
+	}
+
+	bool passed = meanError[1] < meanError[0];
+	printf("Frame pacing benchmark %s\n", passed ? "passed" : "FAILED");
+	return passed;
+}
\ No newline at end of file
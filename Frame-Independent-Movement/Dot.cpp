@@ -1,6 +1,6 @@
 #include "Dot.h"
 
-Dot::Dot(int x, int y) : m_velX(0), m_velY(0), m_posX(0), m_posY(0)
+Dot::Dot(int x, int y) : m_velX(0), m_velY(0), m_posX(0), m_posY(0), m_prevX(0), m_prevY(0)
 {
 	/* Load texture */
 	if (!m_texture.loadFromFile("Images/dot.bmp"))
@@ -55,6 +55,10 @@ void Dot::handleEvent(SDL_Event& event)
 
 void Dot::move(float timeStep)
 {
+	/* Remember where the dot was, for rendering in between */
+	m_prevX = m_posX;
+	m_prevY = m_posY;
+
 	/* Move the dot left or right */
 	m_posX += m_velX * timeStep;
 
@@ -74,8 +78,22 @@ void Dot::move(float timeStep)
 		m_posY = SCREEN_HEIGHT - DOT_HEIGHT;
 }
 
-void Dot::render()
+void Dot::render(float alpha)
 {
+	/* Blend between last two positions */
+	float x = m_prevX + (m_posX - m_prevX) * alpha;
+	float y = m_prevY + (m_posY - m_prevY) * alpha;
+
 	/* Show the dot */
-	m_texture.render(static_cast<int>(m_posX), static_cast<int>(m_posY));
+	m_texture.render(static_cast<int>(x), static_cast<int>(y));
+}
+
+float Dot::getPosX() const
+{
+	return m_posX;
+}
+
+float Dot::getPosY() const
+{
+	return m_posY;
 }
\ No newline at end of file
@@ -31,14 +31,20 @@ public:
 	/* Move and check collisions with tiles */
 	void move(float timeStep);
 
-	/* Show the dot on screen */
-	void render();
+	/* Show the dot on screen, alpha of the way from position before last move to the current one */
+	void render(float alpha = 1.0f);
+
+	/* Get position */
+	float getPosX() const;
+	float getPosY() const;
 
 private:
 	/* Velocity */
 	float m_velX, m_velY;
 	/* Position */
 	float m_posX, m_posY;
+	/* Position before last move */
+	float m_prevX, m_prevY;
 
 	/* Texture */
 	LTexture m_texture;
@@ -3,10 +3,12 @@
 
 #include "Dot.h"
 #include "LTimer.h"
+#include "LGameLoop.h"
 
 #include <stdio.h>
 #include <string>
 #include <fstream>
+#include <vector>
 
 
 /* Initialize the program */
@@ -16,6 +18,11 @@ bool loadMedia();
 /* Clean up */
 void close();
 
+/* Compare step times measured by millisecond and high resolution timers, false if high resolution isn't steadier */
+bool runBenchmark();
+/* Play the same input at several render rates, false if fixed updates don't end up in the same place */
+bool runLoopBenchmark();
+
 
 /* Screen dimensions */
 const int SCREEN_WIDTH = 640;
@@ -28,6 +35,14 @@ SDL_Renderer* renderer = nullptr;
 
 int main(int argc, char* args[])
 {
+	/* Run headless benchmark instead of the demo */
+	bool benchmark = (argc > 1) && (std::string(args[1]) == "--bench");
+	if (benchmark) {
+		SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+		SDL_SetHint(SDL_HINT_RENDER_DRIVER, "software");
+		SDL_SetHint(SDL_HINT_RENDER_VSYNC, "0");
+	}
+
 	/* Initialize */
 	if (!init()) {
 		printf("Failed to initialize!\n");
@@ -42,6 +57,14 @@ int main(int argc, char* args[])
 		return -1;
 	}
 
+	if (benchmark) {
+		/* Run both, even if the first one fails */
+		bool passed = runBenchmark();
+		passed = runLoopBenchmark() && passed;
+		close();
+		return passed ? 0 : -1;
+	}
+
 
 	bool quit = false;
 	SDL_Event e;
@@ -49,8 +72,9 @@ int main(int argc, char* args[])
 	/* Dot that will be moving */
 	Dot dot;
 
-	/* Timer that keeps track of time between steps */
-	LTimer stepTimer;
+	/* Dot moves in fixed steps, the same however fast the screen refreshes */
+	LGameLoop loop;
+	loop.start();
 
 
 	while (!quit) {
@@ -62,22 +86,17 @@ int main(int argc, char* args[])
 			dot.handleEvent(e);
 		}
 
-		/* Calculate step time */
-		float timeStep = stepTimer.getTicks() / 1000.0f;
-
-		/* Move the dot */
-		dot.move(timeStep);
-
-		/* Restart step timer */
-		stepTimer.start();
+		/* Move the dot as many steps as time since last frame covers */
+		for (int updates = loop.beginFrame(); updates > 0; --updates)
+			dot.move(loop.getStep());
 
 
 		/* Clear screen */
 		SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
 		SDL_RenderClear(renderer);
 
-		/* Render dot */
-		dot.render();
+		/* Render dot in between its last two steps */
+		dot.render(loop.getAlpha());
 
 		/* Update screen */
 		SDL_RenderPresent(renderer);
@@ -153,4 +172,193 @@ void close()
 	/* Quit the SDL library */
 	IMG_Quit();
 	SDL_Quit();
+}
+
+bool runBenchmark()
+{
+	const int FRAMES = 1000;
+	/* Simulated work per frame, deliberately not a whole amount of milliseconds */
+	const double WORK_SECONDS = 0.0015;
+	const double frequency = static_cast<double>(SDL_GetPerformanceFrequency());
+
+	/* Both timers measure the very same frames */
+	LTimer timers[2] = { LTimer(LTimer::Resolution::MILLISECONDS), LTimer(LTimer::Resolution::HIGH) };
+	const char* names[2] = { "millisecond", "high resolution" };
+	std::vector<double> steps[2], actual;
+
+	timers[0].start();
+	timers[1].start();
+	Uint64 last = SDL_GetPerformanceCounter();
+	for (int frame = 0; frame < FRAMES; ++frame) {
+		/* Busy work, sleeping would add the scheduler's jitter */
+		Uint64 until = SDL_GetPerformanceCounter() + static_cast<Uint64>(WORK_SECONDS * frequency);
+		while (SDL_GetPerformanceCounter() < until) {
+		}
+
+		Uint64 counter = SDL_GetPerformanceCounter();
+		actual.push_back((counter - last) / frequency);
+		last = counter;
+
+		for (int i = 0; i < 2; ++i)
+			steps[i].push_back(timers[i].restart());
+	}
+
+	/* Spread of step times and how far they're off actual frame times, in milliseconds */
+	double variance[2], error[2], distance[2];
+	double actualDistance = 0.0;
+	for (double step : actual)
+		actualDistance += step * Dot::DOT_VEL;
+
+	for (int i = 0; i < 2; ++i) {
+		double mean = 0.0;
+		for (double step : steps[i])
+			mean += step;
+		distance[i] = mean * Dot::DOT_VEL;
+		mean /= FRAMES;
+
+		variance[i] = error[i] = 0.0;
+		for (int frame = 0; frame < FRAMES; ++frame) {
+			double deviation = (steps[i][frame] - mean) * 1000.0;
+			variance[i] += deviation * deviation;
+			error[i] += SDL_fabs(steps[i][frame] - actual[frame]) * 1000.0;
+		}
+		variance[i] /= FRAMES;
+		error[i] /= FRAMES;
+
+		printf("%-16s timer: %.4f ms mean step, %.6f ms^2 variance, %.4f ms mean error, "
+			"dot moved %.2f of %.2f pixels\n", names[i], mean * 1000.0, variance[i], error[i], distance[i],
+			actualDistance);
+	}
+
+	bool passed = variance[1] < variance[0] && error[1] < error[0];
+	printf("Timer benchmark %s\n", passed ? "passed" : "FAILED");
+	return passed;
+}
+
+bool runLoopBenchmark()
+{
+	/* Simulated time, not a whole amount of steps so some of it is always left over */
+	const Uint64 TOTAL_NANOSECONDS = 2500000000ull;
+	const int RUNS = 5;
+	/* Render rates to play at, 0 being random frame times */
+	const int RATES[RUNS] = { 30, 60, 144, 240, 0 };
+
+	/* Key presses at given simulated time */
+	struct ScriptedKey
+	{
+		Uint64 time;
+		Uint32 type;
+		SDL_Keycode key;
+	};
+	const ScriptedKey SCRIPT[] = {
+		{ 0, SDL_KEYDOWN, SDLK_RIGHT },
+		{ 400000000ull, SDL_KEYDOWN, SDLK_DOWN },
+		{ 900000000ull, SDL_KEYUP, SDLK_RIGHT },
+		{ 1200000000ull, SDL_KEYDOWN, SDLK_LEFT },
+		{ 1600000000ull, SDL_KEYUP, SDLK_LEFT },
+		{ 1750000000ull, SDL_KEYUP, SDLK_DOWN }
+	};
+	const int SCRIPT_SIZE = sizeof(SCRIPT) / sizeof(SCRIPT[0]);
+
+	bool passed = true;
+	float fixedX[RUNS], fixedY[RUNS], variableX[RUNS], variableY[RUNS];
+	Uint64 updates[RUNS];
+
+	for (int run = 0; run < RUNS; ++run) {
+		/* Same random frame times every time the benchmark runs */
+		Uint32 seed = 12345;
+
+		LGameLoop loop;
+		loop.start();
+		Dot fixedDot, variableDot;
+		int nextKey = 0, nextVariableKey = 0;
+		Uint64 elapsed = 0;
+		float minAlpha = 1.0f, maxAlpha = 0.0f;
+
+		while (elapsed < TOTAL_NANOSECONDS) {
+			/* Time of this frame, last one cut to end at total time */
+			Uint64 frame;
+			if (RATES[run] > 0)
+				frame = 1000000000ull / RATES[run];
+			else {
+				seed = seed * 1664525u + 1013904223u;
+				frame = 1000000ull + (seed >> 8) % 40000000ull;
+			}
+			if (frame > TOTAL_NANOSECONDS - elapsed)
+				frame = TOTAL_NANOSECONDS - elapsed;
+			elapsed += frame;
+
+			/* Fixed steps, input lands on the step its time falls into */
+			for (int update = loop.advance(frame); update > 0; --update) {
+				Uint64 stepTime = (loop.getUpdates() - update) * loop.getStepNanoseconds();
+				while (nextKey < SCRIPT_SIZE && SCRIPT[nextKey].time <= stepTime) {
+					SDL_Event e = {};
+					e.type = SCRIPT[nextKey].type;
+					e.key.keysym.sym = SCRIPT[nextKey++].key;
+					fixedDot.handleEvent(e);
+				}
+				fixedDot.move(loop.getStep());
+			}
+
+			float alpha = loop.getAlpha();
+			minAlpha = alpha < minAlpha ? alpha : minAlpha;
+			maxAlpha = alpha > maxAlpha ? alpha : maxAlpha;
+
+			/* Old way for comparison, one step as long as the frame with input landing on the frame */
+			while (nextVariableKey < SCRIPT_SIZE && SCRIPT[nextVariableKey].time < elapsed) {
+				SDL_Event e = {};
+				e.type = SCRIPT[nextVariableKey].type;
+				e.key.keysym.sym = SCRIPT[nextVariableKey++].key;
+				variableDot.handleEvent(e);
+			}
+			variableDot.move(frame / 1000000000.0f);
+		}
+
+		fixedX[run] = fixedDot.getPosX();
+		fixedY[run] = fixedDot.getPosY();
+		variableX[run] = variableDot.getPosX();
+		variableY[run] = variableDot.getPosY();
+		updates[run] = loop.getUpdates();
+
+		/* Alpha is what is left of a step, it can never reach a whole one */
+		if (minAlpha < 0.0f || maxAlpha >= 1.0f) {
+			printf("Interpolation alpha went out of range: %.4f to %.4f\n", minAlpha, maxAlpha);
+			passed = false;
+		}
+
+		if (RATES[run] > 0)
+			printf("%3d FPS:    ", RATES[run]);
+		else
+			printf("random FPS: ");
+		printf("%4d frames, %llu updates, fixed step dot at (%.3f, %.3f), variable step dot at (%.3f, %.3f)\n",
+			static_cast<int>(loop.getFrames()), static_cast<unsigned long long>(updates[run]), fixedX[run],
+			fixedY[run], variableX[run], variableY[run]);
+	}
+
+	/* Fixed steps have to match exactly, variable ones only show how far they'd drift */
+	float drift = 0.0f;
+	for (int run = 1; run < RUNS; ++run) {
+		if (updates[run] != updates[0] || fixedX[run] != fixedX[0] || fixedY[run] != fixedY[0]) {
+			printf("Fixed step run %d ended up different from the first one!\n", run);
+			passed = false;
+		}
+		float dx = SDL_fabsf(variableX[run] - variableX[0]), dy = SDL_fabsf(variableY[run] - variableY[0]);
+		drift = SDL_max(drift, SDL_max(dx, dy));
+	}
+	printf("Variable step dots drift up to %.3f pixels apart\n", drift);
+
+	/* One huge frame, like a breakpoint or dragged window, has to be capped instead of caught up on */
+	LGameLoop loop(60, 5);
+	loop.start();
+	int capped = loop.advance(1000000000ull);
+	int next = loop.advance(loop.getStepNanoseconds());
+	printf("1 s frame ran %d updates, %llu ms dropped, next frame ran %d\n", capped,
+		static_cast<unsigned long long>(loop.getDroppedNanoseconds() / 1000000), next);
+	if (capped != 5 || loop.getCappedFrames() != 1 || next != 1 || loop.getAlpha() >= 1.0f) {
+		printf("Spiral of death guard didn't cap the updates!\n");
+		passed = false;
+	}
+
+	printf("Game loop benchmark %s\n", passed ? "passed" : "FAILED");
+	return passed;
 }
\ No newline at end of file
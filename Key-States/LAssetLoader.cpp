@@ -0,0 +1,226 @@
+#include "LAssetLoader.h"
+
+#include "SDL2/SDL_image.h"
+
+#include <stdio.h>
+
+
+LAssetLoader::LAssetLoader() : m_pixelFormat(SDL_PIXELFORMAT_ARGB8888), m_lock(nullptr), m_queuedCondition(nullptr),
+	m_decodedCondition(nullptr), m_decoding(0), m_failed(0), m_quit(false)
+{
+}
+
+LAssetLoader::~LAssetLoader()
+{
+	stop();
+}
+
+bool LAssetLoader::start(Uint32 pixelFormat, int workers)
+{
+	/* Get rid of previous workers */
+	stop();
+
+	/* Color key becomes alpha, so keep a format that has it */
+	m_pixelFormat = SDL_ISPIXELFORMAT_ALPHA(pixelFormat) ? pixelFormat : static_cast<Uint32>(SDL_PIXELFORMAT_ARGB8888);
+
+	m_lock = SDL_CreateMutex();
+	m_queuedCondition = SDL_CreateCond();
+	m_decodedCondition = SDL_CreateCond();
+	if (m_lock == nullptr || m_queuedCondition == nullptr || m_decodedCondition == nullptr) {
+		printf("Unable to create asset loader locks! SDL_Error: %s\n", SDL_GetError());
+		stop();
+		return false;
+	}
+
+	m_quit = false;
+	m_failed = 0;
+
+	/* One worker per core, main thread has enough with uploads */
+	if (workers <= 0)
+		workers = SDL_max(1, SDL_GetCPUCount());
+
+	for (int i = 0; i < workers; ++i) {
+		SDL_Thread* worker = SDL_CreateThread(workerThread, "AssetLoader", this);
+		if (worker == nullptr) {
+			printf("Unable to create asset loader thread! SDL_Error: %s\n", SDL_GetError());
+			break;
+		}
+		m_workers.push_back(worker);
+	}
+
+	if (m_workers.empty()) {
+		stop();
+		return false;
+	}
+
+	return true;
+}
+
+void LAssetLoader::stop()
+{
+	if (m_lock != nullptr) {
+		/* Wake workers up so they see they should quit */
+		SDL_LockMutex(m_lock);
+		m_quit = true;
+		SDL_CondBroadcast(m_queuedCondition);
+		SDL_UnlockMutex(m_lock);
+	}
+
+	for (SDL_Thread* worker : m_workers)
+		SDL_WaitThread(worker, nullptr);
+	m_workers.clear();
+
+	/* Drop what's left */
+	for (Job& job : m_decoded)
+		SDL_FreeSurface(job.surface);
+	m_decoded.clear();
+	m_queued.clear();
+	m_decoding = 0;
+
+	if (m_decodedCondition != nullptr) {
+		SDL_DestroyCond(m_decodedCondition);
+		m_decodedCondition = nullptr;
+	}
+	if (m_queuedCondition != nullptr) {
+		SDL_DestroyCond(m_queuedCondition);
+		m_queuedCondition = nullptr;
+	}
+	if (m_lock != nullptr) {
+		SDL_DestroyMutex(m_lock);
+		m_lock = nullptr;
+	}
+}
+
+void LAssetLoader::load(const std::string& path, LTexture* texture)
+{
+	if (m_lock == nullptr) {
+		printf("Asset loader isn't started, can't load %s!\n", path.c_str());
+		return;
+	}
+
+	SDL_LockMutex(m_lock);
+	m_queued.push_back({ path, texture, nullptr });
+	SDL_CondSignal(m_queuedCondition);
+	SDL_UnlockMutex(m_lock);
+}
+
+int LAssetLoader::upload(double budgetMs)
+{
+	if (m_lock == nullptr)
+		return 0;
+
+	Uint64 start = SDL_GetPerformanceCounter();
+	Uint64 budget = static_cast<Uint64>(budgetMs * SDL_GetPerformanceFrequency() / 1000.0);
+	int uploaded = 0;
+
+	do {
+		/* Take next decoded image */
+		SDL_LockMutex(m_lock);
+		if (m_decoded.empty()) {
+			SDL_UnlockMutex(m_lock);
+			break;
+		}
+		Job job = m_decoded.front();
+		m_decoded.pop_front();
+		SDL_UnlockMutex(m_lock);
+
+		/* Only this part needs the renderer */
+		if (!job.texture->loadFromSurface(job.surface)) {
+			printf("Unable to upload %s!\n", job.path.c_str());
+			SDL_LockMutex(m_lock);
+			++m_failed;
+			SDL_UnlockMutex(m_lock);
+		}
+		SDL_FreeSurface(job.surface);
+		++uploaded;
+	} while (SDL_GetPerformanceCounter() - start < budget);
+
+	return uploaded;
+}
+
+void LAssetLoader::finish()
+{
+	if (m_lock == nullptr)
+		return;
+
+	while (true) {
+		upload(0.0);
+
+		/* Wait for workers to decode more */
+		SDL_LockMutex(m_lock);
+		if (m_decoded.empty() && m_queued.empty() && m_decoding == 0) {
+			SDL_UnlockMutex(m_lock);
+			break;
+		}
+		if (m_decoded.empty())
+			SDL_CondWait(m_decodedCondition, m_lock);
+		SDL_UnlockMutex(m_lock);
+	}
+}
+
+int LAssetLoader::pending()
+{
+	if (m_lock == nullptr)
+		return 0;
+
+	SDL_LockMutex(m_lock);
+	int count = static_cast<int>(m_queued.size() + m_decoded.size()) + m_decoding;
+	SDL_UnlockMutex(m_lock);
+	return count;
+}
+
+int LAssetLoader::failed()
+{
+	if (m_lock == nullptr)
+		return m_failed;
+
+	SDL_LockMutex(m_lock);
+	int count = m_failed;
+	SDL_UnlockMutex(m_lock);
+	return count;
+}
+
+int LAssetLoader::workerThread(void* data)
+{
+	static_cast<LAssetLoader*>(data)->work();
+	return 0;
+}
+
+void LAssetLoader::work()
+{
+	SDL_LockMutex(m_lock);
+	while (true) {
+		/* Sleep until there's something to do */
+		while (m_queued.empty() && !m_quit)
+			SDL_CondWait(m_queuedCondition, m_lock);
+		if (m_quit)
+			break;
+
+		Job job = m_queued.front();
+		m_queued.pop_front();
+		++m_decoding;
+		SDL_UnlockMutex(m_lock);
+
+		/* Decode and convert without holding the lock */
+		SDL_Surface* loaded = IMG_Load(job.path.c_str());
+		if (loaded == nullptr)
+			printf("Unable to load image %s! SDL_image_Error: %s\n", job.path.c_str(), IMG_GetError());
+		else {
+			/* Color key the same way textures get it, converting turns it into alpha */
+			SDL_SetColorKey(loaded, SDL_TRUE, SDL_MapRGB(loaded->format, 0, 0xFF, 0xFF));
+			job.surface = SDL_ConvertSurfaceFormat(loaded, m_pixelFormat, 0);
+			if (job.surface == nullptr)
+				printf("Unable to convert image %s! SDL_Error: %s\n", job.path.c_str(), SDL_GetError());
+			SDL_FreeSurface(loaded);
+		}
+
+		SDL_LockMutex(m_lock);
+		--m_decoding;
+		if (job.surface != nullptr)
+			m_decoded.push_back(job);
+		else
+			++m_failed;
+		SDL_CondSignal(m_decodedCondition);
+	}
+	SDL_UnlockMutex(m_lock);
+}
\ No newline at end of file
@@ -0,0 +1,70 @@
+#pragma once
+#include "SDL2/SDL.h"
+#include "SDL2/SDL_thread.h"
+
+#include "LTexture.h"
+
+#include <string>
+#include <vector>
+#include <deque>
+
+/* Loads images in the background, worker threads decode and the main thread only uploads */
+class LAssetLoader
+{
+public:
+	/* Milliseconds per frame spent uploading by default */
+	static const int DEFAULT_UPLOAD_BUDGET = 4;
+
+	LAssetLoader();
+	~LAssetLoader();
+
+	/* Start worker threads decoding into given pixel format, 0 workers meaning one per CPU core */
+	bool start(Uint32 pixelFormat, int workers = 0);
+
+	/* Stop worker threads, images not uploaded yet are dropped */
+	void stop();
+
+	/* Queue image to be loaded into texture, which stays empty until it's uploaded */
+	void load(const std::string& path, LTexture* texture);
+
+	/* Upload decoded images until budget runs out, at least one if any is ready, returns amount uploaded */
+	int upload(double budgetMs = DEFAULT_UPLOAD_BUDGET);
+
+	/* Upload everything, waiting for workers to decode it */
+	void finish();
+
+	/* Get amount of images not uploaded yet */
+	int pending();
+	/* Get amount of images that couldn't be loaded */
+	int failed();
+
+private:
+	/* Image on its way to a texture */
+	struct Job
+	{
+		std::string path;
+		LTexture* texture;
+		SDL_Surface* surface;
+	};
+
+	/* Worker thread entry */
+	static int workerThread(void* data);
+	/* Decode queued images until stopped */
+	void work();
+
+	std::vector<SDL_Thread*> m_workers;
+	Uint32 m_pixelFormat;
+
+	/* Protects everything below */
+	SDL_mutex* m_lock;
+	/* Signaled when image gets queued or workers should stop */
+	SDL_cond* m_queuedCondition;
+	/* Signaled when image gets decoded */
+	SDL_cond* m_decodedCondition;
+
+	std::deque<Job> m_queued;
+	std::deque<Job> m_decoded;
+	int m_decoding;
+	int m_failed;
+	bool m_quit;
+};
\ No newline at end of file
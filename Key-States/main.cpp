@@ -2,9 +2,12 @@
 #include "SDL2/SDL_image.h"
 
 #include "LTexture.h"
+#include "LAssetLoader.h"
 
 #include <stdio.h>
+#include <string.h>
 #include <string>
+#include <vector>
 #include <cmath>
 
 
@@ -14,6 +17,8 @@ bool init();
 bool loadMedia();
 /* Clean up */
 void close();
+/* Compare loading a large image set serially and through the asset loader */
+bool runBenchmark();
 
 
 /* Screen constants */
@@ -36,9 +41,20 @@ LTexture downTexture;
 LTexture leftTexture;
 LTexture rightTexture;
 
+/* Loads textures in the background */
+LAssetLoader loader;
+
 
 int main(int argc, char* args[])
 {
+	/* Benchmark mode, render offscreen without waiting for VSync */
+	bool benchmark = argc > 1 && strcmp(args[1], "--bench") == 0;
+	if (benchmark) {
+		SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+		SDL_SetHint(SDL_HINT_RENDER_DRIVER, "software");
+		SDL_SetHint(SDL_HINT_RENDER_VSYNC, "0");
+	}
+
 	/* Initialize */
 	if (!init()) {
 		printf("Failed to initialize!\n");
@@ -46,7 +62,13 @@ int main(int argc, char* args[])
 		return -1;
 	}
 
-	/* Load media */
+	if (benchmark) {
+		bool passed = runBenchmark();
+		close();
+		return passed ? 0 : -1;
+	}
+
+	/* Start loading media */
 	if (!loadMedia()) {
 		printf("Failed to load media!\n");
 		close();
@@ -65,6 +87,16 @@ int main(int argc, char* args[])
 				quit = true;
 		}
 
+		/* Move decoded images into textures */
+		if (loader.pending() > 0)
+			loader.upload();
+
+		/* Some image is gone for good, even if it was the last one to finish */
+		if (loader.failed() > 0) {
+			printf("Failed to load media!\n");
+			quit = true;
+		}
+
 		/* Set texture based on current keystate */
 		const Uint8* currentKeyStates = SDL_GetKeyboardState(NULL);
 		if (currentKeyStates[SDL_SCANCODE_UP])
@@ -82,8 +114,9 @@ int main(int argc, char* args[])
 		SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
 		SDL_RenderClear(renderer);
 
-		/* Render texture */
-		currentTexture->render(0, 0);
+		/* Render texture once it's loaded */
+		if (currentTexture->width() > 0)
+			currentTexture->render(0, 0);
 		
 		/* Update screen */
 		SDL_RenderPresent(renderer);
@@ -141,38 +174,27 @@ bool init()
 
 bool loadMedia()
 {
-	bool success = true;
-
-	if (!defaultTexture.loadFromFile("Images/default.png")) {
-		printf("Couldn't load buttons texture!\n");
-		success = false;
-	}
-
-	if (!upTexture.loadFromFile("Images/up.png")) {
-		printf("Couldn't load buttons texture!\n");
-		success = false;
-	}
-
-	if (!downTexture.loadFromFile("Images/down.png")) {
-		printf("Couldn't load buttons texture!\n");
-		success = false;
-	}
-
-	if (!leftTexture.loadFromFile("Images/left.png")) {
-		printf("Couldn't load buttons texture!\n");
-		success = false;
+	/* Decode in the window's format, so uploading doesn't have to convert */
+	if (!loader.start(SDL_GetWindowPixelFormat(window))) {
+		printf("Couldn't start asset loader!\n");
+		return false;
 	}
 
-	if (!rightTexture.loadFromFile("Images/right.png")) {
-		printf("Couldn't load buttons texture!\n");
-		success = false;
-	}
+	/* Textures fill in over the first frames */
+	loader.load("Images/default.png", &defaultTexture);
+	loader.load("Images/up.png", &upTexture);
+	loader.load("Images/down.png", &downTexture);
+	loader.load("Images/left.png", &leftTexture);
+	loader.load("Images/right.png", &rightTexture);
 
-	return success;
+	return true;
 }
 
 void close()
 {
+	/* Stop loading */
+	loader.stop();
+
 	/* Free loaded textures */
 	defaultTexture.free();
 	upTexture.free();
@@ -198,4 +220,144 @@ void close()
 #endif
 	IMG_Quit();
 	SDL_Quit();
+}
+
+bool runBenchmark()
+{
+	const int IMAGES = 48;
+	const int IMAGE_SIZE = 512;
+	const double frequency = static_cast<double>(SDL_GetPerformanceFrequency());
+	bool passed = true;
+
+	/* Noisy images with color keyed holes, so decoding takes real work */
+	SDL_Surface* image = SDL_CreateRGBSurfaceWithFormat(0, IMAGE_SIZE, IMAGE_SIZE, 32, SDL_PIXELFORMAT_ARGB8888);
+	if (image == NULL) {
+		printf("Unable to create benchmark image! SDL_Error: %s\n", SDL_GetError());
+		return false;
+	}
+
+	std::vector<std::string> paths;
+	Uint32 seed = 2463534242u;
+	for (int i = 0; i < IMAGES; ++i) {
+		SDL_LockSurface(image);
+		for (int y = 0; y < IMAGE_SIZE; ++y) {
+			Uint32* row = reinterpret_cast<Uint32*>(static_cast<Uint8*>(image->pixels) + y * image->pitch);
+			for (int x = 0; x < IMAGE_SIZE; ++x) {
+				seed ^= seed << 13;
+				seed ^= seed >> 17;
+				seed ^= seed << 5;
+
+				if ((x / 32 + y / 32 + i) % 7 == 0)
+					row[x] = SDL_MapRGB(image->format, 0, 0xFF, 0xFF);
+				else
+					row[x] = SDL_MapRGB(image->format, (x + i * 8) & 0xFF, y & 0xFF, seed & 0x3F);
+			}
+		}
+		SDL_UnlockSurface(image);
+
+		paths.push_back("bench_asset_" + std::to_string(i) + ".png");
+		if (IMG_SavePNG(image, paths.back().c_str()) < 0) {
+			printf("Unable to save benchmark image! SDL_image_Error: %s\n", IMG_GetError());
+			passed = false;
+		}
+	}
+	SDL_FreeSurface(image);
+
+	/* Everything loaded on main thread before the first frame, like before */
+	std::vector<LTexture> serial(IMAGES);
+	Uint64 start = SDL_GetPerformanceCounter();
+	for (int i = 0; i < IMAGES; ++i) {
+		if (!serial[i].loadFromFile(paths[i]))
+			passed = false;
+	}
+	double serialMs = (SDL_GetPerformanceCounter() - start) * 1000.0 / frequency;
+	printf("%d images of %dx%d\n", IMAGES, IMAGE_SIZE, IMAGE_SIZE);
+	printf("serial:            first frame after %9.3f ms\n", serialMs);
+
+	/* Through the loader, with a single worker and one per core */
+	const int workerCounts[] = { 1, SDL_max(1, SDL_GetCPUCount()) };
+	double totals[2] = { 0.0, 0.0 };
+	for (int run = 0; run < 2; ++run) {
+		int workers = workerCounts[run];
+		std::vector<LTexture> async(IMAGES);
+		start = SDL_GetPerformanceCounter();
+
+		if (!loader.start(SDL_GetWindowPixelFormat(window), workers)) {
+			passed = false;
+			break;
+		}
+		for (int i = 0; i < IMAGES; ++i)
+			loader.load(paths[i], &async[i]);
+
+		/* Frames go on while images come in */
+		double firstFrameMs = 0.0, worstFrameMs = 0.0;
+		int frames = 0;
+		do {
+			Uint64 frameStart = SDL_GetPerformanceCounter();
+			loader.upload();
+
+			SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
+			SDL_RenderClear(renderer);
+			SDL_RenderPresent(renderer);
+
+			Uint64 frameEnd = SDL_GetPerformanceCounter();
+			if (frames++ == 0)
+				firstFrameMs = (frameEnd - start) * 1000.0 / frequency;
+			worstFrameMs = SDL_max(worstFrameMs, (frameEnd - frameStart) * 1000.0 / frequency);
+		} while (loader.pending() > 0);
+		double totalMs = (SDL_GetPerformanceCounter() - start) * 1000.0 / frequency;
+		totals[run] = totalMs;
+
+		printf("%2d worker thread%s: first frame after %9.3f ms, all loaded after %9.3f ms in %d frames, "
+			"worst frame %.3f ms\n", workers, workers == 1 ? " " : "s", firstFrameMs, totalMs, frames, worstFrameMs);
+
+		/* Program has to show up long before everything would have been loaded up front */
+		if (firstFrameMs * 4 > serialMs) {
+			printf("First frame isn't well ahead of loading serially!\n");
+			passed = false;
+		}
+
+		if (loader.failed() > 0) {
+			printf("%d images failed to load!\n", loader.failed());
+			passed = false;
+		}
+		loader.stop();
+
+		/* Loaded textures have to look the same as serially loaded ones */
+		std::vector<Uint32> pixels[2];
+		for (int i = 0; i < IMAGES && passed; ++i) {
+			if (async[i].width() != serial[i].width() || async[i].height() != serial[i].height()) {
+				printf("Image %d has wrong size!\n", i);
+				passed = false;
+				break;
+			}
+
+			for (int loaded = 0; loaded < 2; ++loaded) {
+				SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
+				SDL_RenderClear(renderer);
+				(loaded ? async[i] : serial[i]).render(0, 0);
+
+				pixels[loaded].resize(SCREEN_WIDTH * SCREEN_HEIGHT);
+				SDL_RenderReadPixels(renderer, NULL, SDL_PIXELFORMAT_ARGB8888, pixels[loaded].data(), SCREEN_WIDTH * 4);
+			}
+
+			if (pixels[0] != pixels[1]) {
+				printf("Image %d looks different loaded through the loader!\n", i);
+				passed = false;
+			}
+		}
+	}
+
+	/* More workers have to decode faster when there are more cores for them */
+	if (passed && workerCounts[1] > 1 && totals[1] >= totals[0]) {
+		printf("%d workers aren't faster than one!\n", workerCounts[1]);
+		passed = false;
+	}
+
+	/* Clean up */
+	for (const std::string& path : paths)
+		remove(path.c_str());
+
+	printf("Asset loader benchmark %s\n", passed ? "passed" : "FAILED");
+	return passed;
 }
\ No newline at end of file
@@ -3,10 +3,13 @@
 #include "SDL2/SDL_thread.h"
 
 #include "LTexture.h"
+#include "LJobSystem.h"
 
 #include <stdio.h>
+#include <stdint.h>
 #include <string>
 #include <fstream>
+#include <vector>
 
 
 /* Initialize the program */
@@ -16,8 +19,11 @@ bool loadMedia();
 /* Clean up */
 void close();
 
-/* Test thread function */
-int threadFunction(void* data);
+/* Test job function */
+void jobFunction(void* data);
+
+/* Run parallel for, uneven jobs and dependent jobs on job system, false if anything ran wrong or didn't scale */
+bool runBenchmark();
 
 
 /* Screen dimensions */
@@ -34,6 +40,10 @@ LTexture splashTexture;
 
 int main(int argc, char* args[])
 {
+	/* Job benchmark needs no window */
+	if ((argc > 1) && (std::string(args[1]) == "--bench"))
+		return runBenchmark() ? 0 : -1;
+
 	/* Initialize */
 	if (!init()) {
 		printf("Failed to initialize!\n");
@@ -52,9 +62,14 @@ int main(int argc, char* args[])
 	bool quit = false;
 	SDL_Event e;
 
-	/* Run the thread */
+	/* Workers waiting for jobs, one per core besides this thread */
+	LJobSystem jobSystem;
+
+	/* Run the job */
 	int data = 101;
-	SDL_Thread* threadID = SDL_CreateThread(threadFunction, "SomeThread", reinterpret_cast<void*>(data));
+	LJobCounter jobDone;
+	LJob job = { jobFunction, reinterpret_cast<void*>(static_cast<intptr_t>(data)), &jobDone };
+	jobSystem.run(job);
 
 	while (!quit) {
 		while (SDL_PollEvent(&e)) {
@@ -73,8 +88,8 @@ int main(int argc, char* args[])
 		SDL_RenderPresent(renderer);
 	}
 
-	/* Wait for thread to finish */
-	SDL_WaitThread(threadID, NULL);
+	/* Wait for job to finish, running it here if no worker got to it */
+	jobSystem.wait(jobDone);
 
 	/* Clean up */
 	close();
@@ -156,10 +171,164 @@ void close()
 	SDL_Quit();
 }
 
-int threadFunction(void* data)
+void jobFunction(void* data)
 {
 	/* Print incoming data */
-	printf("Running thread with value = %d\n", reinterpret_cast<int>(data));
+	printf("Running job with value = %d on thread %lu\n", static_cast<int>(reinterpret_cast<intptr_t>(data)),
+		static_cast<unsigned long>(SDL_ThreadID()));
+}
 
-	return 0;
+/* Busy work, steps of value depending on each other so nothing gets optimized away */
+static float spin(float value, int steps)
+{
+	for (int i = 0; i < steps; ++i)
+		value = value * 0.999f + 0.5f;
+	return value;
+}
+
+/* Job doing given amount of busy work, counting which thread ran it */
+struct UnevenJob
+{
+	int steps;
+	SDL_threadID ranOn;
+	float result;
+};
+
+static void unevenJob(void* data)
+{
+	UnevenJob* job = static_cast<UnevenJob*>(data);
+	job->result = spin(1.0f, job->steps);
+	job->ranOn = SDL_ThreadID();
+}
+
+/* Stages of dependent jobs, each only correct if the one before fully finished */
+struct Stages
+{
+	int squares[64];
+	std::atomic<int> filled;
+	int sum;
+	bool checked;
+};
+
+struct SquareJob
+{
+	Stages* stages;
+	int index;
+};
+
+static void squareJob(void* data)
+{
+	SquareJob* job = static_cast<SquareJob*>(data);
+	job->stages->squares[job->index] = job->index * job->index;
+	job->stages->filled.fetch_add(1);
+}
+
+static void sumJob(void* data)
+{
+	Stages* stages = static_cast<Stages*>(data);
+	stages->sum = 0;
+	for (int i = 0; i < 64; ++i)
+		stages->sum += stages->squares[i];
+}
+
+static void checkJob(void* data)
+{
+	Stages* stages = static_cast<Stages*>(data);
+	stages->checked = stages->filled.load() == 64 && stages->sum == 63 * 64 * 127 / 6;
+}
+
+bool runBenchmark()
+{
+	const int ELEMENTS = 1 << 20;
+	const int STEPS = 200;
+	const int UNEVEN_JOBS = 512;
+
+	LJobSystem jobSystem;
+	const double frequency = static_cast<double>(SDL_GetPerformanceFrequency());
+	printf("%d threads\n", jobSystem.threadCount());
+
+	/* Same busy work over every element, serially then in parallel */
+	std::vector<float> serial(ELEMENTS), parallel(ELEMENTS);
+	std::vector<float>* output = &serial;
+	auto work = [&output](int begin, int end) {
+		for (int i = begin; i < end; ++i)
+			(*output)[i] = spin(static_cast<float>(i % 1000), STEPS);
+	};
+
+	/* Serially in as many pieces as there are threads, so both run the very same loop */
+	int piece = ELEMENTS / jobSystem.threadCount();
+	Uint64 start = SDL_GetPerformanceCounter();
+	for (int begin = 0; begin < ELEMENTS; begin += piece)
+		work(begin, SDL_min(begin + piece, ELEMENTS));
+	double serialSeconds = (SDL_GetPerformanceCounter() - start) / frequency;
+
+	output = &parallel;
+	start = SDL_GetPerformanceCounter();
+	jobSystem.parallelFor(ELEMENTS, 1024, work);
+	double parallelSeconds = (SDL_GetPerformanceCounter() - start) / frequency;
+
+	bool same = serial == parallel;
+	double speedup = serialSeconds / parallelSeconds;
+	printf("parallel for: %.2f ms serial, %.2f ms parallel, %.2fx%s\n", serialSeconds * 1000.0,
+		parallelSeconds * 1000.0, speedup, same ? "" : ", RESULTS DIFFER");
+
+	/* Every sixteenth job a hundred times longer, only stealing spreads them */
+	std::vector<UnevenJob> uneven(UNEVEN_JOBS);
+	std::vector<LJob> jobs(UNEVEN_JOBS);
+	LJobCounter unevenDone;
+	for (int i = 0; i < UNEVEN_JOBS; ++i) {
+		uneven[i] = { i % 16 == 0 ? 200000 : 2000, 0, 0.0f };
+		jobs[i] = { unevenJob, &uneven[i], &unevenDone };
+	}
+	Uint64 stealsBefore = jobSystem.getSteals();
+	start = SDL_GetPerformanceCounter();
+	jobSystem.run(jobs.data(), UNEVEN_JOBS);
+	jobSystem.wait(unevenDone);
+	double unevenSeconds = (SDL_GetPerformanceCounter() - start) / frequency;
+
+	int ranOnMain = 0, unfinished = 0;
+	for (const UnevenJob& job : uneven) {
+		if (job.ranOn == SDL_ThreadID())
+			++ranOnMain;
+		if (job.ranOn == 0 || job.result != spin(1.0f, job.steps))
+			++unfinished;
+	}
+	Uint64 steals = jobSystem.getSteals() - stealsBefore;
+	printf("uneven jobs: %.2f ms, %d of %d run by waiting main thread, %llu stolen, %d wrong\n",
+		unevenSeconds * 1000.0, ranOnMain, UNEVEN_JOBS, static_cast<unsigned long long>(steals), unfinished);
+
+	/* Fill, then sum once every square is in, then check once sum is done */
+	Stages stages;
+	stages.filled = 0;
+	stages.sum = -1;
+	stages.checked = false;
+	SquareJob squares[64];
+	LJob squareJobs[64];
+	LJobCounter filled, summed, checked;
+	for (int i = 0; i < 64; ++i) {
+		squares[i] = { &stages, i };
+		squareJobs[i] = { squareJob, &squares[i], &filled };
+	}
+	LJob sum = { sumJob, &stages, &summed };
+	LJob check = { checkJob, &stages, &checked };
+
+	/* Each stage is queued after the one it depends on, so its counter already counts those jobs */
+	jobSystem.run(squareJobs, 64);
+	jobSystem.runAfter(filled, sum);
+	jobSystem.runAfter(summed, check);
+	jobSystem.wait(checked);
+
+	/* Depending on a finished counter runs right away */
+	stages.checked = false;
+	LJobCounter rechecked;
+	LJob recheck = { checkJob, &stages, &rechecked };
+	jobSystem.runAfter(summed, recheck);
+	jobSystem.wait(rechecked);
+	printf("dependent jobs: sum %d, %s\n", stages.sum, stages.checked ? "ran in order" : "RAN OUT OF ORDER");
+
+	/* Scaling only shows with more than one thread */
+	bool multiple = jobSystem.threadCount() > 1;
+	bool passed = same && unfinished == 0 && stages.checked && (!multiple || (speedup > 1.0 && steals > 0));
+	printf("Job system benchmark %s\n", passed ? "passed" : "FAILED");
+	return passed;
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "SDL2/SDL_thread.h"
 
 #include "LTexture.h"
+#include "LSPSCQueue.h"
 
 #include <stdio.h>
 #include <string>
@@ -22,6 +23,9 @@ int consumer(void* data);
 void produce();
 void consume();
 
+/* Compare handing items over one at a time under mutex and conditions with lock free queues, false if queues are slower */
+bool runBenchmark();
+
 
 /* Screen dimensions */
 const int SCREEN_WIDTH = 640;
@@ -47,6 +51,10 @@ int globalData = -1;
 
 int main(int argc, char* args[])
 {
+	/* Queue benchmark needs no window */
+	if ((argc > 1) && (std::string(args[1]) == "--bench"))
+		return runBenchmark() ? 0 : -1;
+
 	/* Initialize */
 	if (!init()) {
 		printf("Failed to initialize!\n");
@@ -274,4 +282,116 @@ void consume()
 
 	/* Signal producer */
 	SDL_CondSignal(canProduce);
+}
+
+/* Items every benchmarked design hands over */
+static const int BENCH_ITEMS = 500000;
+
+/* Single slot guarded like produce and consume do, without printing */
+struct MutexSlot
+{
+	SDL_mutex* lock;
+	SDL_cond* canProduce;
+	SDL_cond* canConsume;
+	int data;
+	bool full;
+};
+
+static int slotProducer(void* data)
+{
+	MutexSlot* slot = static_cast<MutexSlot*>(data);
+	for (int i = 0; i < BENCH_ITEMS; ++i) {
+		SDL_LockMutex(slot->lock);
+		while (slot->full)
+			SDL_CondWait(slot->canProduce, slot->lock);
+		slot->data = i;
+		slot->full = true;
+		SDL_UnlockMutex(slot->lock);
+		SDL_CondSignal(slot->canConsume);
+	}
+	return 0;
+}
+
+static int blockingProducer(void* data)
+{
+	LBlockingQueue<int>* queue = static_cast<LBlockingQueue<int>*>(data);
+	for (int i = 0; i < BENCH_ITEMS; ++i)
+		queue->push(i);
+	return 0;
+}
+
+static int spinningProducer(void* data)
+{
+	LSPSCQueue<int>* queue = static_cast<LSPSCQueue<int>*>(data);
+	for (int i = 0; i < BENCH_ITEMS; ++i) {
+		while (!queue->tryPush(i)) {
+		}
+	}
+	return 0;
+}
+
+/* Items per second, false in ordered if any item came out of order */
+template<typename Take>
+static double consumeAll(SDL_ThreadFunction producer, void* data, bool& ordered, Take take)
+{
+	ordered = true;
+	Uint64 start = SDL_GetPerformanceCounter();
+	SDL_Thread* thread = SDL_CreateThread(producer, "BenchProducer", data);
+	for (int i = 0; i < BENCH_ITEMS; ++i) {
+		if (take() != i)
+			ordered = false;
+	}
+	SDL_WaitThread(thread, NULL);
+	double seconds = static_cast<double>(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+	return BENCH_ITEMS / seconds;
+}
+
+bool runBenchmark()
+{
+	const size_t CAPACITY = 1024;
+	const char* names[3] = { "mutex and conditions", "blocking queue", "spinning queue" };
+	double itemsPerSecond[3];
+	bool ordered[3];
+
+	/* The design produce and consume use, one item at a time */
+	MutexSlot slot = { SDL_CreateMutex(), SDL_CreateCond(), SDL_CreateCond(), -1, false };
+	itemsPerSecond[0] = consumeAll(slotProducer, &slot, ordered[0], [&slot]() {
+		SDL_LockMutex(slot.lock);
+		while (!slot.full)
+			SDL_CondWait(slot.canConsume, slot.lock);
+		int item = slot.data;
+		slot.full = false;
+		SDL_UnlockMutex(slot.lock);
+		SDL_CondSignal(slot.canProduce);
+		return item;
+	});
+	SDL_DestroyCond(slot.canConsume);
+	SDL_DestroyCond(slot.canProduce);
+	SDL_DestroyMutex(slot.lock);
+
+	/* Waits on conditions only when empty or full */
+	LBlockingQueue<int> blocking(CAPACITY);
+	itemsPerSecond[1] = consumeAll(blockingProducer, &blocking, ordered[1], [&blocking]() {
+		return blocking.pop();
+	});
+
+	/* Never waits, both threads spin */
+	LSPSCQueue<int> spinning(CAPACITY);
+	itemsPerSecond[2] = consumeAll(spinningProducer, &spinning, ordered[2], [&spinning]() {
+		int item;
+		while (!spinning.tryPop(item)) {
+		}
+		return item;
+	});
+
+	bool passed = true;
+	for (int i = 0; i < 3; ++i) {
+		printf("%-21s %10.0f items/s, %.2fx mutex and conditions%s\n", names[i], itemsPerSecond[i],
+			itemsPerSecond[i] / itemsPerSecond[0], ordered[i] ? "" : ", OUT OF ORDER");
+		passed = passed && ordered[i];
+	}
+
+	passed = passed && itemsPerSecond[1] > itemsPerSecond[0];
+	printf("Queue benchmark %s\n", passed ? "passed" : "FAILED");
+	return passed;
 }
\ No newline at end of file
@@ -1,24 +1,13 @@
 #include "Dot.h"
 
-Dot::Dot(int x, int y) : m_posX(x), m_posY(y), m_velX(0), m_velY(0)
-{
-	/* Load texture */
-	if (!m_texture.loadFromFile("Images/dot.bmp"))
-		printf("Couldn't load dot texture!\n");
+/* Texture */
+LSubTexture dotTexture;
 
-	/* Initialize particles */
-	for (int i = 0; i < TOTAL_PARTICLES; i++)
-		particles[i] = new Particle(m_posX, m_posY);
-}
-
-Dot::~Dot()
+Dot::Dot(int x, int y, int particleCount) : m_posX(x), m_posY(y), m_velX(0), m_velY(0),
+	m_particles(particleCount)
 {
-	/* Delete texture */
-	m_texture.free();
-
-	/* Delete particles */
-	for (int i = 0; i < TOTAL_PARTICLES; i++)
-		delete particles[i];
+	/* Initialize particles */
+	m_particles.refill(m_posX, m_posY);
 }
 
 void Dot::handleEvent(SDL_Event& event)
@@ -82,27 +71,31 @@ void Dot::move()
 	}
 }
 
-void Dot::render(int camX, int camY)
+void Dot::render(int camX, int camY, LSpriteBatch* batch)
 {
 	/* Show the dot */
-	m_texture.render(m_posX - camX, m_posY - camY);
+	if (batch != nullptr) {
+		batch->begin(dotTexture);
+		batch->draw(m_posX - camX, m_posY - camY);
+	}
+	else
+		dotTexture.render(m_posX - camX, m_posY - camY);
 
 	/* Show particles on top of the dot */
-	renderParticles();
+	renderParticles(batch);
 }
 
-void Dot::renderParticles()
+void Dot::renderParticles(LSpriteBatch* batch)
 {
-	/* Go through particles */
-	for (int i = 0; i < TOTAL_PARTICLES; ++i) {
-		/* Delete and replace dead particles */
-		if (particles[i]->isDead()) {
-			delete particles[i];
-			particles[i] = new Particle(m_posX, m_posY);
-		}
-	}
+	/* Replace dead particles */
+	m_particles.refill(m_posX, m_posY);
+
+	/* Show particles */
+	if (batch != nullptr)
+		m_particles.render(*batch);
+	else
+		m_particles.render();
 
-	/* Show particle */
-	for (int i = 0; i < TOTAL_PARTICLES; ++i)
-		particles[i]->render();
+	/* Animate */
+	m_particles.update();
 }
\ No newline at end of file
@@ -2,7 +2,9 @@
 #include "SDL2/SDL.h"
 
 #include "LTexture.h"
-#include "Particle.h"
+#include "LSubTexture.h"
+#include "ParticleSystem.h"
+#include "LSpriteBatch.h"
 
 #include <vector>
 
@@ -11,6 +13,9 @@
 extern const int SCREEN_WIDTH;
 extern const int SCREEN_HEIGHT;
 
+/* Image shared by every dot */
+extern LSubTexture dotTexture;
+
 
 /* Dot that will move around on the screen */
 class Dot
@@ -23,8 +28,7 @@ public:
 	static const int DOT_VEL = 5;
 
 public:
-	Dot(int x = 0, int y = 0);
-	~Dot();
+	Dot(int x = 0, int y = 0, int particleCount = TOTAL_PARTICLES);
 
 	/* Adjust velocity based of key presses */
 	void handleEvent(SDL_Event& event);
@@ -32,20 +36,18 @@ public:
 	/* Move */
 	void move();
 
-	/* Show the dot on screen */
-	void render(int camX = 0, int camY = 0);
+	/* Show the dot on screen, dot and particles go through the batch if one is given */
+	void render(int camX = 0, int camY = 0, LSpriteBatch* batch = nullptr);
 
 private:
 	/* Shows the particles */
-	void renderParticles();
+	void renderParticles(LSpriteBatch* batch);
 
 private:
 	/* X and Y offsets */
 	int m_posX, m_posY;
 	/* Velocity */
 	int m_velX, m_velY;
-	/* Texture */
-	LTexture m_texture;
 	/* Particles */
-	Particle* particles[TOTAL_PARTICLES];
+	ParticleSystem m_particles;
 };
\ No newline at end of file
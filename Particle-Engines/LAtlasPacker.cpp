@@ -0,0 +1,116 @@
+#include "LAtlasPacker.h"
+
+#include <limits.h>
+
+
+LAtlasPacker::LAtlasPacker(int width, int height)
+{
+	reset(width, height);
+}
+
+void LAtlasPacker::reset(int width, int height)
+{
+	m_width = width;
+	m_height = height;
+	m_usedArea = 0;
+
+	/* Whole area is free */
+	m_freeRects.clear();
+	if (width > 0 && height > 0)
+		m_freeRects.push_back({ 0, 0, width, height });
+}
+
+bool LAtlasPacker::insert(int width, int height, SDL_Rect& placed)
+{
+	if (width <= 0 || height <= 0)
+		return false;
+
+	/* Best short side fit, free rectangle leaving the smallest leftover on its tighter side */
+	int bestShortSide = INT_MAX, bestLongSide = INT_MAX;
+	bool found = false;
+
+	for (const SDL_Rect& free : m_freeRects) {
+		if (free.w < width || free.h < height)
+			continue;
+
+		int leftoverX = free.w - width, leftoverY = free.h - height;
+		int shortSide = SDL_min(leftoverX, leftoverY), longSide = SDL_max(leftoverX, leftoverY);
+
+		if (shortSide < bestShortSide || (shortSide == bestShortSide && longSide < bestLongSide)) {
+			placed = { free.x, free.y, width, height };
+			bestShortSide = shortSide;
+			bestLongSide = longSide;
+			found = true;
+		}
+	}
+
+	if (!found)
+		return false;
+
+	splitFreeRects(placed);
+	pruneFreeRects();
+
+	m_usedArea += static_cast<long long>(width) * height;
+	return true;
+}
+
+float LAtlasPacker::occupancy() const
+{
+	if (m_width <= 0 || m_height <= 0)
+		return 0.0f;
+	return static_cast<float>(m_usedArea) / (static_cast<float>(m_width) * m_height);
+}
+
+void LAtlasPacker::splitFreeRects(const SDL_Rect& used)
+{
+	std::vector<SDL_Rect> split;
+	size_t kept = 0;
+
+	for (size_t i = 0; i < m_freeRects.size(); ++i) {
+		SDL_Rect free = m_freeRects[i];
+
+		/* Not overlapping, keep as it is */
+		if (used.x >= free.x + free.w || used.x + used.w <= free.x ||
+			used.y >= free.y + free.h || used.y + used.h <= free.y) {
+			m_freeRects[kept++] = free;
+			continue;
+		}
+
+		/* Leftover strips on each side of used rectangle, they may overlap each other */
+		if (used.x > free.x)
+			split.push_back({ free.x, free.y, used.x - free.x, free.h });
+		if (used.x + used.w < free.x + free.w)
+			split.push_back({ used.x + used.w, free.y, free.x + free.w - used.x - used.w, free.h });
+		if (used.y > free.y)
+			split.push_back({ free.x, free.y, free.w, used.y - free.y });
+		if (used.y + used.h < free.y + free.h)
+			split.push_back({ free.x, used.y + used.h, free.w, free.y + free.h - used.y - used.h });
+	}
+
+	m_freeRects.resize(kept);
+	m_freeRects.insert(m_freeRects.end(), split.begin(), split.end());
+}
+
+void LAtlasPacker::pruneFreeRects()
+{
+	auto contains = [](const SDL_Rect& outer, const SDL_Rect& inner) {
+		return inner.x >= outer.x && inner.y >= outer.y &&
+			inner.x + inner.w <= outer.x + outer.w && inner.y + inner.h <= outer.y + outer.h;
+	};
+
+	for (size_t i = 0; i < m_freeRects.size(); ++i) {
+		for (size_t j = i + 1; j < m_freeRects.size(); ++j) {
+			/* Rectangle i adds nothing */
+			if (contains(m_freeRects[j], m_freeRects[i])) {
+				m_freeRects.erase(m_freeRects.begin() + i);
+				--i;
+				break;
+			}
+			/* Rectangle j adds nothing */
+			if (contains(m_freeRects[i], m_freeRects[j])) {
+				m_freeRects.erase(m_freeRects.begin() + j);
+				--j;
+			}
+		}
+	}
+}
\ No newline at end of file
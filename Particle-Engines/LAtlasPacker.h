@@ -0,0 +1,32 @@
+#pragma once
+#include "SDL2/SDL.h"
+
+#include <vector>
+
+/* Places rectangles into a fixed area by keeping a list of maximal free rectangles */
+class LAtlasPacker
+{
+public:
+	LAtlasPacker(int width = 0, int height = 0);
+
+	/* Forget placed rectangles and start over with given area */
+	void reset(int width, int height);
+
+	/* Find spot for rectangle of given size, false if it doesn't fit anymore */
+	bool insert(int width, int height, SDL_Rect& placed);
+
+	/* Get fraction of area taken by placed rectangles */
+	float occupancy() const;
+
+private:
+	/* Cut placed rectangle out of every free one it overlaps */
+	void splitFreeRects(const SDL_Rect& used);
+
+	/* Drop free rectangles lying inside another one */
+	void pruneFreeRects();
+
+	int m_width, m_height;
+	long long m_usedArea;
+
+	std::vector<SDL_Rect> m_freeRects;
+};
\ No newline at end of file
@@ -0,0 +1,194 @@
+#include "LTextureAtlas.h"
+#include "LAtlasPacker.h"
+
+#include "SDL2/SDL_image.h"
+
+#include <stdio.h>
+#include <algorithm>
+#include <fstream>
+
+
+SDL_Surface* LTextureAtlas::bake(const std::vector<std::string>& paths, std::vector<SDL_Rect>& clips)
+{
+	/* Load every image */
+	std::vector<SDL_Surface*> images;
+	for (const std::string& path : paths) {
+		SDL_Surface* image = IMG_Load(path.c_str());
+		if (image == NULL) {
+			printf("Unable to load image %s! SDL_image_Error: %s\n", path.c_str(), IMG_GetError());
+			for (SDL_Surface* loaded : images)
+				SDL_FreeSurface(loaded);
+			return nullptr;
+		}
+		images.push_back(image);
+	}
+
+	/* Packing goes better from the largest image down */
+	std::vector<size_t> order(images.size());
+	for (size_t i = 0; i < order.size(); ++i)
+		order[i] = i;
+	std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+		int sideA = SDL_max(images[a]->w, images[a]->h), sideB = SDL_max(images[b]->w, images[b]->h);
+		if (sideA != sideB)
+			return sideA > sideB;
+		return images[a]->w * images[a]->h > images[b]->w * images[b]->h;
+	});
+
+	/* Find the smallest square everything fits in */
+	clips.assign(images.size(), { 0, 0, 0, 0 });
+	LAtlasPacker packer;
+	int size = 64;
+	for (; size <= MAX_SIZE; size *= 2) {
+		packer.reset(size, size);
+
+		bool fits = true;
+		for (size_t i : order) {
+			SDL_Rect padded;
+			if (!packer.insert(images[i]->w + PADDING, images[i]->h + PADDING, padded)) {
+				fits = false;
+				break;
+			}
+			clips[i] = { padded.x, padded.y, images[i]->w, images[i]->h };
+		}
+
+		if (fits)
+			break;
+	}
+
+	SDL_Surface* atlas = nullptr;
+	if (size > MAX_SIZE)
+		printf("Images don't fit into %dx%d atlas!\n", MAX_SIZE, MAX_SIZE);
+	else {
+		/* Empty space is color key, same as around the images */
+		atlas = SDL_CreateRGBSurfaceWithFormat(0, size, size, 32, SDL_PIXELFORMAT_RGB888);
+		if (atlas == NULL)
+			printf("Unable to create atlas surface! SDL_Error: %s\n", SDL_GetError());
+		else {
+			SDL_FillRect(atlas, NULL, SDL_MapRGB(atlas->format, 0, 0xFF, 0xFF));
+
+			/* Copy pixels over as they are */
+			for (size_t i = 0; i < images.size(); ++i) {
+				SDL_SetSurfaceBlendMode(images[i], SDL_BLENDMODE_NONE);
+				SDL_SetColorKey(images[i], SDL_FALSE, 0);
+				SDL_BlitSurface(images[i], NULL, atlas, &clips[i]);
+				clips[i].w = images[i]->w;
+				clips[i].h = images[i]->h;
+			}
+		}
+	}
+
+	/* Clean up */
+	for (SDL_Surface* image : images)
+		SDL_FreeSurface(image);
+
+	return atlas;
+}
+
+bool LTextureAtlas::save(SDL_Surface* atlas, const std::vector<std::string>& paths, const std::vector<SDL_Rect>& clips,
+	const std::string& imagePath, const std::string& manifestPath)
+{
+	if (SDL_SaveBMP(atlas, imagePath.c_str()) < 0) {
+		printf("Unable to save atlas image %s! SDL_Error: %s\n", imagePath.c_str(), SDL_GetError());
+		return false;
+	}
+
+	std::ofstream manifest(manifestPath);
+	if (manifest.fail()) {
+		printf("Unable to write atlas manifest %s!\n", manifestPath.c_str());
+		return false;
+	}
+
+	/* One image per line, path last so it may contain spaces */
+	manifest << "# x y w h path\n";
+	for (size_t i = 0; i < paths.size(); ++i)
+		manifest << clips[i].x << ' ' << clips[i].y << ' ' << clips[i].w << ' ' << clips[i].h << ' ' << paths[i] << '\n';
+
+	return !manifest.fail();
+}
+
+bool LTextureAtlas::loadFromFile(const std::string& imagePath, const std::string& manifestPath)
+{
+	/* Get rid of preexisting atlas */
+	free();
+
+	std::ifstream manifest(manifestPath);
+	if (manifest.fail()) {
+		printf("Unable to open atlas manifest %s!\n", manifestPath.c_str());
+		return false;
+	}
+
+	std::string line;
+	while (std::getline(manifest, line)) {
+		if (line.empty() || line[0] == '#')
+			continue;
+
+		SDL_Rect clip;
+		int pathStart = 0;
+		if (sscanf(line.c_str(), "%d %d %d %d %n", &clip.x, &clip.y, &clip.w, &clip.h, &pathStart) < 4 ||
+			pathStart == 0) {
+			printf("Broken line in atlas manifest %s: %s\n", manifestPath.c_str(), line.c_str());
+			free();
+			return false;
+		}
+
+		m_clips[line.substr(pathStart)] = clip;
+	}
+
+	if (!m_texture.loadFromFile(imagePath)) {
+		free();
+		return false;
+	}
+
+	return true;
+}
+
+bool LTextureAtlas::loadFromImages(const std::vector<std::string>& paths)
+{
+	/* Get rid of preexisting atlas */
+	free();
+
+	std::vector<SDL_Rect> clips;
+	SDL_Surface* atlas = bake(paths, clips);
+	if (atlas == NULL)
+		return false;
+
+	/* Space left between images is cyan */
+	SDL_SetColorKey(atlas, SDL_TRUE, SDL_MapRGB(atlas->format, 0, 0xFF, 0xFF));
+	bool success = m_texture.loadFromSurface(atlas);
+	SDL_FreeSurface(atlas);
+
+	if (success) {
+		for (size_t i = 0; i < paths.size(); ++i)
+			m_clips[paths[i]] = clips[i];
+	}
+
+	return success;
+}
+
+void LTextureAtlas::free()
+{
+	m_texture.free();
+	m_clips.clear();
+}
+
+bool LTextureAtlas::getSubTexture(const std::string& path, LSubTexture& subTexture)
+{
+	auto clip = m_clips.find(path);
+	if (clip == m_clips.end()) {
+		printf("Image %s isn't in atlas!\n", path.c_str());
+		return false;
+	}
+
+	subTexture = LSubTexture(m_texture, clip->second);
+	return true;
+}
+
+LTexture& LTextureAtlas::getTexture()
+{
+	return m_texture;
+}
+
+int LTextureAtlas::size() const
+{
+	return static_cast<int>(m_clips.size());
+}
\ No newline at end of file
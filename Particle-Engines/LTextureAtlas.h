@@ -0,0 +1,50 @@
+#pragma once
+#include "SDL2/SDL.h"
+
+#include "LTexture.h"
+#include "LSubTexture.h"
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+/* Images packed into one texture, with a manifest of the part each one went to */
+class LTextureAtlas
+{
+public:
+	/* Largest atlas side tried when packing */
+	static const int MAX_SIZE = 2048;
+	/* Empty pixels kept between images */
+	static const int PADDING = 1;
+
+	/* Pack images into one color keyed surface, clips come in the same order as paths */
+	static SDL_Surface* bake(const std::vector<std::string>& paths, std::vector<SDL_Rect>& clips);
+
+	/* Save baked surface as image and clips as text manifest */
+	static bool save(SDL_Surface* atlas, const std::vector<std::string>& paths, const std::vector<SDL_Rect>& clips,
+		const std::string& imagePath, const std::string& manifestPath);
+
+	/* Load baked atlas image and its manifest */
+	bool loadFromFile(const std::string& imagePath, const std::string& manifestPath);
+
+	/* Pack images at runtime and load the result */
+	bool loadFromImages(const std::vector<std::string>& paths);
+
+	/* Deallocate memory */
+	void free();
+
+	/* Get part of atlas image came from, false if it isn't in atlas */
+	bool getSubTexture(const std::string& path, LSubTexture& subTexture);
+
+	/* Get the whole atlas */
+	LTexture& getTexture();
+
+	/* Get amount of images in atlas */
+	int size() const;
+
+private:
+	LTexture m_texture;
+
+	/* Part of atlas by image path */
+	std::unordered_map<std::string, SDL_Rect> m_clips;
+};
\ No newline at end of file
@@ -0,0 +1,144 @@
+#include "ParticleSystem.h"
+
+/* Textures */
+LSubTexture redTexture;
+LSubTexture greenTexture;
+LSubTexture blueTexture;
+LSubTexture shimmerTexture;
+
+/* Particle type to texture lookup */
+static LSubTexture* particleTextures[TOTAL_PARTICLE_TYPES] = { &redTexture, &greenTexture, &blueTexture };
+
+ParticleSystem::ParticleSystem(int capacity)
+{
+	setCapacity(capacity);
+}
+
+void ParticleSystem::setCapacity(int capacity)
+{
+	if (capacity < 0)
+		capacity = 0;
+
+	/* Reallocate the arrays */
+	m_posX.assign(capacity, 0);
+	m_posY.assign(capacity, 0);
+	m_frame.assign(capacity, 0);
+	m_lifetime.assign(capacity, PARTICLE_LIFETIME);
+	m_texture.assign(capacity, 0);
+	m_alive.assign(capacity, 0);
+
+	/* Every slot starts free */
+	m_freeSlots.reserve(capacity);
+	clear();
+}
+
+int ParticleSystem::emit(int x, int y, int count)
+{
+	int spawned = 0;
+
+	/* Take slots from the free list */
+	while (spawned < count && !m_freeSlots.empty()) {
+		int i = m_freeSlots.back();
+		m_freeSlots.pop_back();
+
+		/* Set offsets */
+		m_posX[i] = x - 5 + (rand() % 25);
+		m_posY[i] = y - 5 + (rand() % 25);
+
+		/* Initialize animation */
+		m_frame[i] = rand() % 5;
+		m_lifetime[i] = PARTICLE_LIFETIME;
+
+		/* Set type */
+		m_texture[i] = static_cast<Uint8>(rand() % TOTAL_PARTICLE_TYPES);
+
+		m_alive[i] = 1;
+		++spawned;
+	}
+
+	return spawned;
+}
+
+int ParticleSystem::refill(int x, int y)
+{
+	return emit(x, y, static_cast<int>(m_freeSlots.size()));
+}
+
+void ParticleSystem::update()
+{
+	const int count = capacity();
+
+	for (int i = 0; i < count; ++i) {
+		if (!m_alive[i])
+			continue;
+
+		/* Animate */
+		++m_frame[i];
+
+		/* Recycle dead particle */
+		if (m_frame[i] > m_lifetime[i]) {
+			m_alive[i] = 0;
+			m_freeSlots.push_back(i);
+		}
+	}
+}
+
+void ParticleSystem::render(int camX, int camY)
+{
+	const int count = capacity();
+
+	for (int i = 0; i < count; ++i) {
+		if (!m_alive[i])
+			continue;
+
+		/* Show image */
+		particleTextures[m_texture[i]]->render(m_posX[i] - camX, m_posY[i] - camY);
+
+		/* Show shimmer */
+		if (m_frame[i] % 2 == 0)
+			shimmerTexture.render(m_posX[i] - camX, m_posY[i] - camY);
+	}
+}
+
+void ParticleSystem::render(LSpriteBatch& batch, int camX, int camY)
+{
+	const int count = capacity();
+
+	/* Same order as drawing one by one, particles are translucent and overlap, parts of one atlas don't flush */
+	for (int i = 0; i < count; ++i) {
+		if (!m_alive[i])
+			continue;
+
+		batch.begin(*particleTextures[m_texture[i]]);
+		batch.draw(m_posX[i] - camX, m_posY[i] - camY);
+
+		if (m_frame[i] % 2 == 0) {
+			batch.begin(shimmerTexture);
+			batch.draw(m_posX[i] - camX, m_posY[i] - camY);
+		}
+	}
+
+	batch.flush();
+}
+
+void ParticleSystem::clear()
+{
+	const int count = capacity();
+
+	/* Push slots in reverse so that they get reused from the front */
+	m_freeSlots.clear();
+	for (int i = count - 1; i >= 0; --i) {
+		m_alive[i] = 0;
+		m_freeSlots.push_back(i);
+	}
+}
+
+int ParticleSystem::capacity() const
+{
+	return static_cast<int>(m_alive.size());
+}
+
+int ParticleSystem::alive() const
+{
+	return capacity() - static_cast<int>(m_freeSlots.size());
+}
\ No newline at end of file
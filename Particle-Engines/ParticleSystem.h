@@ -0,0 +1,75 @@
+#pragma once
+#include "SDL2/SDL.h"
+#include "LTexture.h"
+#include "LSubTexture.h"
+#include "LSpriteBatch.h"
+
+#include <vector>
+
+/* Default amount of particles per emitter */
+const int TOTAL_PARTICLES = 20;
+
+/* Amount of particle colors */
+const int TOTAL_PARTICLE_TYPES = 3;
+
+/* Particle images, parts of one atlas or whole textures */
+extern LSubTexture redTexture;
+extern LSubTexture greenTexture;
+extern LSubTexture blueTexture;
+extern LSubTexture shimmerTexture;
+
+/* Particle pool stored as structure of arrays */
+class ParticleSystem
+{
+public:
+	/* Number of frames a particle lives for */
+	static const int PARTICLE_LIFETIME = 10;
+
+public:
+	/* Allocate pool for given amount of particles */
+	ParticleSystem(int capacity = TOTAL_PARTICLES);
+
+	/* Resize the pool, this kills every particle */
+	void setCapacity(int capacity);
+
+	/* Spawn up to count particles around given point, returns how many were spawned */
+	int emit(int x, int y, int count);
+
+	/* Fill every free slot with a particle around given point */
+	int refill(int x, int y);
+
+	/* Advance animation and recycle dead particles */
+	void update();
+
+	/* Show the particles */
+	void render(int camX = 0, int camY = 0);
+	/* Show the particles through batch in the same order, one draw call when they share an atlas */
+	void render(LSpriteBatch& batch, int camX = 0, int camY = 0);
+
+	/* Kill every particle */
+	void clear();
+
+	/* Get amount of slots */
+	int capacity() const;
+	/* Get amount of living particles */
+	int alive() const;
+
+private:
+	/* Offsets */
+	std::vector<int> m_posX, m_posY;
+
+	/* Current frame of animation */
+	std::vector<int> m_frame;
+
+	/* Frame after which particle dies */
+	std::vector<int> m_lifetime;
+
+	/* Type of particle, index into particle textures */
+	std::vector<Uint8> m_texture;
+
+	/* Is slot in use */
+	std::vector<Uint8> m_alive;
+
+	/* Indices of dead slots ready for reuse */
+	std::vector<int> m_freeSlots;
+};
\ No newline at end of file
@@ -3,9 +3,14 @@
 
 #include "LTexture.h"
 #include "Dot.h"
+#include "ParticleSystem.h"
+#include "LSpriteBatch.h"
+#include "LSubTexture.h"
+#include "LTextureAtlas.h"
 
 #include <stdio.h>
 #include <string>
+#include <vector>
 
 
 /* Initialize the program */
@@ -15,6 +20,13 @@ bool loadMedia();
 /* Clean up */
 void close();
 
+/* Pack sprite images into atlas image and manifest */
+bool bakeAtlas();
+/* Point sprites at parts of atlas */
+bool bindSprites(LTextureAtlas& atlas);
+/* Measure particle update throughput and rendering cost with separate textures and atlas */
+bool runBenchmark();
+
 
 /* Screen dimensions */
 const int SCREEN_WIDTH = 640;
@@ -24,9 +36,35 @@ const int SCREEN_HEIGHT = 480;
 SDL_Window* window = nullptr;
 SDL_Renderer* renderer = nullptr;
 
+/* Sprite images and the parts of atlas they end up as */
+const int TOTAL_SPRITES = 5;
+const std::vector<std::string> SPRITE_IMAGES = { "Images/dot.bmp", "Images/red.bmp", "Images/green.bmp",
+	"Images/blue.bmp", "Images/shimmer.bmp" };
+LSubTexture* const SPRITES[TOTAL_SPRITES] = { &dotTexture, &redTexture, &greenTexture, &blueTexture,
+	&shimmerTexture };
+
+/* Baked atlas files */
+const std::string ATLAS_IMAGE = "Images/sprites.bmp";
+const std::string ATLAS_MANIFEST = "Images/sprites.atlas";
+
+/* Every sprite in one texture */
+LTextureAtlas spriteAtlas;
+
 
 int main(int argc, char* args[])
 {
+	/* Pack sprites ahead of time, no window needed */
+	if (argc > 1 && std::string(args[1]) == "--bake")
+		return bakeAtlas() ? 0 : -1;
+
+	/* Run headless benchmark instead of the demo */
+	bool benchmark = (argc > 1) && (std::string(args[1]) == "--bench");
+	if (benchmark) {
+		SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+		SDL_SetHint(SDL_HINT_RENDER_DRIVER, "software");
+		SDL_SetHint(SDL_HINT_RENDER_VSYNC, "0");
+	}
+
 	/* Initialize */
 	if (!init()) {
 		printf("Failed to initialize!\n");
@@ -41,6 +79,12 @@ int main(int argc, char* args[])
 		return -1;
 	}
 
+	if (benchmark) {
+		bool passed = runBenchmark();
+		close();
+		return passed ? 0 : -1;
+	}
+
 
 	bool quit = false;
 	SDL_Event e;
@@ -48,11 +92,19 @@ int main(int argc, char* args[])
 	/* Dot that will be moving around the screen */
 	Dot dot;
 
+	/* Batch for particles, toggled with B key */
+	LSpriteBatch batch;
+	bool useBatch = false;
+
 	while (!quit) {
 		while (SDL_PollEvent(&e)) {
 			if (e.type == SDL_QUIT)
 				quit = true;
 
+			/* Toggle batched particle rendering */
+			if (e.type == SDL_KEYDOWN && e.key.repeat == 0 && e.key.keysym.sym == SDLK_b)
+				useBatch = !useBatch;
+
 			/* Handle dot events */
 			dot.handleEvent(e);
 		}
@@ -65,7 +117,7 @@ int main(int argc, char* args[])
 		SDL_RenderClear(renderer);
 
 		/* Render objects */
-		dot.render();
+		dot.render(0, 0, useBatch ? &batch : nullptr);
 
 		/* Update screen */
 		SDL_RenderPresent(renderer);
@@ -121,39 +173,27 @@ bool loadMedia()
 {
 	bool success = true;
 
-	/* Load particle textures */
-	if (!redTexture.loadFromFile("Images/red.bmp")) {
-		printf("Couldn't load red particle texture!\n");
-		success = false;
-	}
-	if (!greenTexture.loadFromFile("Images/green.bmp")) {
-		printf("Couldn't load green particle texture!\n");
-		success = false;
-	}
-	if (!blueTexture.loadFromFile("Images/blue.bmp")) {
-		printf("Couldn't load blue particle texture!\n");
-		success = false;
+	/* Load baked sprite atlas, or pack the images now if it's not there */
+	if (!spriteAtlas.loadFromFile(ATLAS_IMAGE, ATLAS_MANIFEST)) {
+		printf("Packing sprites at startup instead, run with --bake to do it ahead of time\n");
+		if (!spriteAtlas.loadFromImages(SPRITE_IMAGES)) {
+			printf("Couldn't pack sprite atlas!\n");
+			success = false;
+		}
 	}
-	if (!shimmerTexture.loadFromFile("Images/shimmer.bmp")) {
-		printf("Couldn't load shimmer particle texture!\n");
+
+	if (success && !bindSprites(spriteAtlas)) {
+		printf("Couldn't find sprites in atlas!\n");
 		success = false;
 	}
 
-	/* Set particle textures transparency */
-	redTexture.setAlpha(192);
-	greenTexture.setAlpha(192);
-	blueTexture.setAlpha(192);
-	shimmerTexture.setAlpha(192);
-
 	return success;
 }
 
 void close()
 {
 	/* Free textures */
-	redTexture.free();
-	greenTexture.free();
-	blueTexture.free();
+	spriteAtlas.free();
 
 	/* Destroy windows */
 	if (window) {
@@ -170,4 +210,176 @@ void close()
 	/* Quit the SDL library */
 	IMG_Quit();
 	SDL_Quit();
+}
+
+bool bakeAtlas()
+{
+	std::vector<SDL_Rect> clips;
+	SDL_Surface* atlas = LTextureAtlas::bake(SPRITE_IMAGES, clips);
+	if (atlas == NULL)
+		return false;
+
+	bool success = LTextureAtlas::save(atlas, SPRITE_IMAGES, clips, ATLAS_IMAGE, ATLAS_MANIFEST);
+	if (success)
+		printf("Packed %d sprites into %dx%d %s\n", TOTAL_SPRITES, atlas->w, atlas->h, ATLAS_IMAGE.c_str());
+
+	SDL_FreeSurface(atlas);
+	return success;
+}
+
+bool bindSprites(LTextureAtlas& atlas)
+{
+	bool success = true;
+	for (int i = 0; i < TOTAL_SPRITES; ++i) {
+		if (!atlas.getSubTexture(SPRITE_IMAGES[i], *SPRITES[i]))
+			success = false;
+	}
+
+	/* Set particle textures transparency */
+	redTexture.setAlpha(192);
+	greenTexture.setAlpha(192);
+	blueTexture.setAlpha(192);
+	shimmerTexture.setAlpha(192);
+
+	return success;
+}
+
+bool runBenchmark()
+{
+	/* Particle counts to test */
+	const int counts[] = { 1000, 10000, 100000 };
+	/* Simulated and rendered frames per count */
+	const int UPDATE_FRAMES = 1000;
+	const int RENDER_FRAMES = 10;
+
+	const double frequency = static_cast<double>(SDL_GetPerformanceFrequency());
+	bool passed = true;
+
+	/* Same sprites as separate textures, like every image used to be loaded */
+	LTexture separateTextures[TOTAL_SPRITES];
+	LSubTexture separateSprites[TOTAL_SPRITES], atlasSprites[TOTAL_SPRITES];
+	for (int i = 0; i < TOTAL_SPRITES; ++i) {
+		if (!separateTextures[i].loadFromFile(SPRITE_IMAGES[i]))
+			return false;
+		separateSprites[i] = LSubTexture(separateTextures[i]);
+		separateSprites[i].setColor(0xFF, 0xFF, 0xFF);
+		separateSprites[i].setAlpha(SPRITES[i]->getColor().a);
+		atlasSprites[i] = *SPRITES[i];
+	}
+
+	/* Dot with its particles, drawn one by one or batched */
+	LSpriteBatch batch;
+	auto drawScene = [&](ParticleSystem& particles, bool batched) {
+		SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
+		SDL_RenderClear(renderer);
+
+		if (batched) {
+			batch.begin(dotTexture);
+			batch.draw(SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2);
+			particles.render(batch);
+		}
+		else {
+			dotTexture.render(SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2);
+			particles.render();
+		}
+	};
+
+	for (int count : counts) {
+		ParticleSystem particles(count);
+		particles.refill(SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2);
+
+		/* Time emitting and updating only */
+		long long updated = 0;
+		Uint64 start = SDL_GetPerformanceCounter();
+		for (int frame = 0; frame < UPDATE_FRAMES; ++frame) {
+			particles.refill(SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2);
+			updated += particles.alive();
+			particles.update();
+		}
+		double updateMs = (SDL_GetPerformanceCounter() - start) * 1000.0 / frequency;
+		printf("%6d particles: %10.0f particles updated/ms\n", count, updated / updateMs);
+
+		/* Frame of particles that doesn't change, to compare pixels of both layouts */
+		srand(count);
+		ParticleSystem still(count);
+		still.refill(SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2);
+		std::vector<Uint32> pixels[2][2];
+
+		for (int atlas = 0; atlas < 2; ++atlas) {
+			for (int i = 0; i < TOTAL_SPRITES; ++i)
+				*SPRITES[i] = atlas ? atlasSprites[i] : separateSprites[i];
+
+			/* Time full frames through the renderer, one draw per sprite and then batched */
+			for (int batched = 0; batched < 2; ++batched) {
+				LTexture::drawCalls = 0;
+				LTexture::textureSwitches = 0;
+				start = SDL_GetPerformanceCounter();
+				for (int frame = 0; frame < RENDER_FRAMES; ++frame) {
+					particles.refill(SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2);
+					drawScene(particles, batched);
+					particles.update();
+
+					SDL_RenderPresent(renderer);
+				}
+				double renderMs = (SDL_GetPerformanceCounter() - start) * 1000.0 / frequency / RENDER_FRAMES;
+
+				printf("    %-8s %-9s %8.3f ms/frame, %6d draw calls/frame, %6d texture switches/frame\n",
+					atlas ? "atlas" : "separate", batched ? "batched:" : "unbatched:", renderMs,
+					LTexture::drawCalls / RENDER_FRAMES, LTexture::textureSwitches / RENDER_FRAMES);
+
+				/* Whole atlas goes out in a single call */
+				if (atlas && batched && LTexture::drawCalls != RENDER_FRAMES) {
+					printf("Atlas frame took more than one draw call!\n");
+					passed = false;
+				}
+
+				drawScene(still, batched);
+				pixels[atlas][batched].resize(SCREEN_WIDTH * SCREEN_HEIGHT);
+				SDL_RenderReadPixels(renderer, NULL, SDL_PIXELFORMAT_ARGB8888, pixels[atlas][batched].data(),
+					SCREEN_WIDTH * 4);
+			}
+		}
+
+		/* Count pixels of two frames differing by more than blending rounding */
+		auto countDifferent = [](const std::vector<Uint32>& first, const std::vector<Uint32>& second) {
+			int different = 0;
+			for (int i = 0; i < SCREEN_WIDTH * SCREEN_HEIGHT; ++i) {
+				for (int shift = 0; shift < 32; shift += 8) {
+					int a = (first[i] >> shift) & 0xFF, b = (second[i] >> shift) & 0xFF;
+					if (SDL_abs(a - b) > 2) {
+						++different;
+						break;
+					}
+				}
+			}
+			return different;
+		};
+
+		/* Atlas has to look the same as separate textures */
+		for (int batched = 0; batched < 2; ++batched) {
+			int different = countDifferent(pixels[0][batched], pixels[1][batched]);
+			if (different > 0) {
+				printf("    %d pixels differ between separate and atlas %s frame!\n", different,
+					batched ? "batched" : "unbatched");
+				passed = false;
+			}
+		}
+
+		/* Batching has to keep drawing order, overlapping translucent particles show it */
+		for (int atlas = 0; atlas < 2; ++atlas) {
+			int different = countDifferent(pixels[atlas][0], pixels[atlas][1]);
+			if (different > 0) {
+				printf("    %d pixels differ between unbatched and batched %s frame!\n", different,
+					atlas ? "atlas" : "separate");
+				passed = false;
+			}
+		}
+	}
+
+	/* Back to atlas */
+	for (int i = 0; i < TOTAL_SPRITES; ++i)
+		*SPRITES[i] = atlasSprites[i];
+
+	printf("Atlas benchmark %s\n", passed ? "passed" : "FAILED");
+	return passed;
 }
\ No newline at end of file
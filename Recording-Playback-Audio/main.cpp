@@ -7,6 +7,8 @@
 #include <stdio.h>
 #include <string>
 #include <sstream>
+#include <vector>
+#include <utility>
 
 
 /* Initialize the program */
@@ -44,7 +46,7 @@ const int RECORDING_BUFFER_SECONDS = MAX_RECORDING_TIME + 1;
 
 /* Text textures */
 LTexture promptText;
-LTexture deviceText[MAX_RECORDING_DEVICES];
+std::vector<LTexture> deviceText;
 
 
 /* The various recording actions */
@@ -291,7 +293,7 @@ int main(int argc, char* args[])
 
 		/* Render text */
 		promptText.render((SCREEN_WIDTH - promptText.width()) / 2 , 0);
-		for (int i = 0; i < recordingDeviceCount; i++) {
+		for (int i = 0; i < static_cast<int>(deviceText.size()); i++) {
 			deviceText[i].render((SCREEN_WIDTH - deviceText[i].width()) / 2,
 				promptText.height() + i * deviceText[i].height());
 		}
@@ -393,8 +395,10 @@ bool loadMedia()
 				text.str("");
 				text << i << ": " << SDL_GetAudioDeviceName(i, SDL_TRUE);
 
-				/* Set texture from name */
-				deviceText[i].loadFromRenderedText(text.str(), textColor);
+				/* Set texture from name, moving it into the list */
+				LTexture name;
+				name.loadFromRenderedText(text.str(), textColor);
+				deviceText.push_back(std::move(name));
 			}
 		}
 	}
@@ -406,8 +410,7 @@ void close()
 {
 	/* Free textures */
 	promptText.free();
-	for (int i = 0; i < MAX_RECORDING_DEVICES; ++i)
-		deviceText[i].free();
+	deviceText.clear();
 
 	/* Close the font */
 	TTF_CloseFont(font);
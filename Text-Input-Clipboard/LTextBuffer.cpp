@@ -0,0 +1,446 @@
+#include "LTextBuffer.h"
+
+#include <string.h>
+#include <algorithm>
+#include <iterator>
+
+
+LTextBuffer::LTextBuffer() : m_atlas(nullptr), m_cursorLine(0), m_cursorColumn(0), m_firstLine(0), m_scrollX(0),
+	m_queueOffset(0), m_layouts(0)
+{
+	/* Always at least one line */
+	m_lines.push_back({ "", {}, 0 });
+}
+
+void LTextBuffer::setAtlas(LGlyphAtlas* atlas)
+{
+	m_atlas = atlas;
+
+	/* Everything has to be measured again */
+	for (Line& line : m_lines)
+		invalidate(line, 0);
+}
+
+void LTextBuffer::setText(const std::string& text)
+{
+	/* Drop old text */
+	m_lines.clear();
+	m_lines.push_back({ "", {}, 0 });
+	m_queue.clear();
+	m_queueOffset = 0;
+
+	m_cursorLine = 0;
+	m_cursorColumn = 0;
+	m_firstLine = 0;
+	m_scrollX = 0;
+
+	insert(text);
+}
+
+std::string LTextBuffer::getText()
+{
+	flush();
+
+	size_t length = m_lines.size() - 1;
+	for (const Line& line : m_lines)
+		length += line.text.size();
+
+	/* Join lines */
+	std::string text;
+	text.reserve(length);
+	for (size_t i = 0; i < m_lines.size(); ++i) {
+		if (i > 0)
+			text += '\n';
+		text += m_lines[i].text;
+	}
+
+	return text;
+}
+
+void LTextBuffer::insert(const std::string& text)
+{
+	/* Long text without new lines all ends up on cursor line, make room for it up front so the line isn't moved while growing */
+	if (!queued() && text.size() > QUEUE_THRESHOLD && memchr(text.data(), '\n', text.size()) == nullptr) {
+		Line& current = m_lines[m_cursorLine];
+		current.text.reserve(current.text.size() + text.size());
+		current.offsets.reserve(current.text.size() + text.size() + 1);
+	}
+
+	/* Keep order with text already waiting */
+	if (queued() || text.size() > QUEUE_THRESHOLD) {
+		/* Forget the part that's in already */
+		m_queue.erase(0, m_queueOffset);
+		m_queueOffset = 0;
+		m_queue += text;
+	}
+	else
+		insertNow(text.data(), text.size());
+}
+
+void LTextBuffer::backspace()
+{
+	flush();
+
+	Line& current = m_lines[m_cursorLine];
+	if (m_cursorColumn > 0) {
+		current.text.erase(m_cursorColumn - 1, 1);
+		invalidate(current, m_cursorColumn - 1);
+		--m_cursorColumn;
+	}
+	/* Join with previous line */
+	else if (m_cursorLine > 0) {
+		Line& previous = m_lines[m_cursorLine - 1];
+		m_cursorColumn = static_cast<int>(previous.text.size());
+		previous.text += current.text;
+		invalidate(previous, m_cursorColumn);
+
+		m_lines.erase(m_lines.begin() + m_cursorLine);
+		--m_cursorLine;
+	}
+}
+
+void LTextBuffer::deleteForward()
+{
+	flush();
+
+	Line& current = m_lines[m_cursorLine];
+	if (m_cursorColumn < static_cast<int>(current.text.size())) {
+		current.text.erase(m_cursorColumn, 1);
+		invalidate(current, m_cursorColumn);
+	}
+	/* Join with next line */
+	else if (m_cursorLine + 1 < lineCount()) {
+		invalidate(current, current.text.size());
+		current.text += m_lines[m_cursorLine + 1].text;
+
+		m_lines.erase(m_lines.begin() + m_cursorLine + 1);
+	}
+}
+
+void LTextBuffer::moveLeft()
+{
+	flush();
+
+	if (m_cursorColumn > 0)
+		--m_cursorColumn;
+	else if (m_cursorLine > 0) {
+		--m_cursorLine;
+		m_cursorColumn = static_cast<int>(m_lines[m_cursorLine].text.size());
+	}
+}
+
+void LTextBuffer::moveRight()
+{
+	flush();
+
+	if (m_cursorColumn < static_cast<int>(m_lines[m_cursorLine].text.size()))
+		++m_cursorColumn;
+	else if (m_cursorLine + 1 < lineCount()) {
+		++m_cursorLine;
+		m_cursorColumn = 0;
+	}
+}
+
+void LTextBuffer::moveUp()
+{
+	flush();
+
+	if (m_cursorLine > 0) {
+		--m_cursorLine;
+		clampCursor();
+	}
+}
+
+void LTextBuffer::moveDown()
+{
+	flush();
+
+	if (m_cursorLine + 1 < lineCount()) {
+		++m_cursorLine;
+		clampCursor();
+	}
+}
+
+void LTextBuffer::moveHome()
+{
+	flush();
+	m_cursorColumn = 0;
+}
+
+void LTextBuffer::moveEnd()
+{
+	flush();
+	m_cursorColumn = static_cast<int>(m_lines[m_cursorLine].text.size());
+}
+
+void LTextBuffer::handleEvent(const SDL_Event& e)
+{
+	/* Special key input */
+	if (e.type == SDL_KEYDOWN) {
+		bool control = SDL_GetModState() & KMOD_CTRL;
+
+		switch (e.key.keysym.sym) {
+		case SDLK_BACKSPACE: backspace(); break;
+		case SDLK_DELETE: deleteForward(); break;
+		case SDLK_LEFT: moveLeft(); break;
+		case SDLK_RIGHT: moveRight(); break;
+		case SDLK_UP: moveUp(); break;
+		case SDLK_DOWN: moveDown(); break;
+		case SDLK_HOME: moveHome(); break;
+		case SDLK_END: moveEnd(); break;
+		case SDLK_RETURN: insert("\n"); break;
+
+		/* Handle copy */
+		case SDLK_c:
+			if (control)
+				SDL_SetClipboardText(getText().c_str());
+			break;
+
+		/* Handle paste, long text gets moved in over the next frames */
+		case SDLK_v:
+			if (control) {
+				char* clipboard = SDL_GetClipboardText();
+				if (clipboard != nullptr) {
+					insert(clipboard);
+					SDL_free(clipboard);
+				}
+			}
+			break;
+		}
+	}
+
+	/* Text input that isn't copy or paste */
+	else if (e.type == SDL_TEXTINPUT) {
+		if (!(SDL_GetModState() & KMOD_CTRL && (e.text.text[0] == 'c' || e.text.text[0] == 'C' ||
+			e.text.text[0] == 'v' || e.text.text[0] == 'V')))
+			insert(e.text.text);
+	}
+}
+
+bool LTextBuffer::update()
+{
+	if (!queued())
+		return false;
+
+	size_t remaining = m_queue.size() - m_queueOffset;
+	size_t count = SDL_min(remaining, INSERT_BYTES_PER_UPDATE);
+	const char* start = &m_queue[m_queueOffset];
+
+	if (count < remaining) {
+		/* Prefer cutting after a new line, so lines aren't split between updates */
+		size_t cut = count;
+		while (cut > 0 && start[cut - 1] != '\n')
+			--cut;
+
+		if (cut > 0)
+			count = cut;
+		/* Keep \r\n together */
+		else if (start[count - 1] == '\r')
+			--count;
+	}
+
+	insertNow(start, count);
+	m_queueOffset += count;
+
+	/* Release memory of finished queue */
+	if (m_queueOffset == m_queue.size()) {
+		std::string().swap(m_queue);
+		m_queueOffset = 0;
+	}
+
+	return queued();
+}
+
+void LTextBuffer::flush()
+{
+	if (!queued())
+		return;
+
+	insertNow(&m_queue[m_queueOffset], m_queue.size() - m_queueOffset);
+	std::string().swap(m_queue);
+	m_queueOffset = 0;
+}
+
+bool LTextBuffer::queued() const
+{
+	return m_queueOffset < m_queue.size();
+}
+
+void LTextBuffer::render(const SDL_Rect& area, SDL_Color color)
+{
+	if (m_atlas == nullptr || m_atlas->lineHeight() <= 0)
+		return;
+
+	int lineHeight = m_atlas->lineHeight();
+	int shownLines = SDL_max(1, area.h / lineHeight);
+
+	/* Scroll so cursor stays in view */
+	if (m_cursorLine < m_firstLine)
+		m_firstLine = m_cursorLine;
+	else if (m_cursorLine >= m_firstLine + shownLines)
+		m_firstLine = m_cursorLine - shownLines + 1;
+	m_firstLine = SDL_min(m_firstLine, lineCount() - 1);
+
+	Line& current = m_lines[m_cursorLine];
+	layout(current);
+	int cursorX = current.offsets[m_cursorColumn];
+	if (cursorX < m_scrollX)
+		m_scrollX = cursorX;
+	else if (cursorX >= m_scrollX + area.w)
+		m_scrollX = cursorX - area.w + 1;
+
+	SDL_RenderSetClipRect(renderer, &area);
+
+	int lastLine = SDL_min(lineCount(), m_firstLine + shownLines);
+	for (int i = m_firstLine; i < lastLine; ++i) {
+		Line& line = m_lines[i];
+		layout(line);
+
+		/* Center lines that fit, scroll the rest */
+		int width = line.offsets.back();
+		int x = width <= area.w ? area.x + (area.w - width) / 2 : area.x - m_scrollX;
+		int y = area.y + (i - m_firstLine) * lineHeight;
+
+		/* Skip characters outside of area */
+		const int* offsets = line.offsets.data();
+		const int* end = offsets + line.text.size();
+		const int* first = std::upper_bound(offsets, end, area.x - x);
+		if (first != offsets)
+			--first;
+		const int* last = std::lower_bound(first, end, area.x + area.w - x);
+
+		m_atlas->render(x, y, line.text.data() + (first - offsets), first, last - first, color);
+
+		/* Draw cursor */
+		if (i == m_cursorLine) {
+			SDL_Rect cursor = { x + offsets[m_cursorColumn], y, 2, lineHeight };
+			SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
+			SDL_RenderFillRect(renderer, &cursor);
+		}
+	}
+
+	SDL_RenderSetClipRect(renderer, nullptr);
+}
+
+int LTextBuffer::lineCount() const
+{
+	return static_cast<int>(m_lines.size());
+}
+
+const std::string& LTextBuffer::line(int index) const
+{
+	return m_lines[index].text;
+}
+
+int LTextBuffer::lineWidth(int index)
+{
+	Line& line = m_lines[index];
+	layout(line);
+	return line.offsets.back();
+}
+
+int LTextBuffer::cursorLine() const
+{
+	return m_cursorLine;
+}
+
+int LTextBuffer::cursorColumn() const
+{
+	return m_cursorColumn;
+}
+
+int LTextBuffer::layouts() const
+{
+	return m_layouts;
+}
+
+void LTextBuffer::insertNow(const char* text, size_t length)
+{
+	Line& current = m_lines[m_cursorLine];
+	const char* end = text + length;
+	const char* newLine = static_cast<const char*>(memchr(text, '\n', length));
+
+	/* Text stays on cursor line, only characters from cursor on need measuring */
+	if (newLine == nullptr) {
+		current.text.insert(m_cursorColumn, text, length);
+		invalidate(current, m_cursorColumn);
+		m_cursorColumn += static_cast<int>(length);
+		return;
+	}
+
+	/* Text after cursor ends up behind the inserted lines */
+	std::string tail = current.text.substr(m_cursorColumn);
+	current.text.erase(m_cursorColumn);
+
+	/* Segments between new lines, without \r of \r\n */
+	auto segment = [](const char* start, const char* stop) {
+		if (stop > start && stop[-1] == '\r')
+			--stop;
+		return std::string(start, stop);
+	};
+
+	current.text += segment(text, newLine);
+	invalidate(current, m_cursorColumn);
+
+	std::vector<Line> added;
+	const char* start = newLine + 1;
+	while ((newLine = static_cast<const char*>(memchr(start, '\n', end - start))) != nullptr) {
+		added.push_back({ segment(start, newLine), {}, 0 });
+		start = newLine + 1;
+	}
+
+	/* Last segment joins the tail */
+	Line last = { std::string(start, end), {}, 0 };
+	m_cursorColumn = static_cast<int>(last.text.size());
+	last.text += tail;
+	added.push_back(std::move(last));
+
+	m_lines.insert(m_lines.begin() + m_cursorLine + 1, std::make_move_iterator(added.begin()),
+		std::make_move_iterator(added.end()));
+	m_cursorLine += static_cast<int>(added.size());
+}
+
+void LTextBuffer::invalidate(Line& line, size_t from)
+{
+	line.dirtyFrom = SDL_min(line.dirtyFrom, from);
+}
+
+void LTextBuffer::layout(Line& line)
+{
+	if (line.dirtyFrom == std::string::npos)
+		return;
+
+	size_t count = line.text.size();
+	line.offsets.resize(count + 1);
+
+	/* Nothing to measure with, keep it dirty */
+	if (m_atlas == nullptr) {
+		std::fill(line.offsets.begin(), line.offsets.end(), 0);
+		line.dirtyFrom = 0;
+		return;
+	}
+
+	/* Continue from the end of last unchanged character, so text added at cursor costs only what comes after it */
+	size_t first = SDL_min(line.dirtyFrom, count);
+	int pen = 0;
+	if (first > 0)
+		pen = line.offsets[first - 1] + m_atlas->advance(static_cast<Uint8>(line.text[first - 1]));
+
+	for (size_t i = first; i < count; ++i) {
+		Uint8 character = static_cast<Uint8>(line.text[i]);
+		if (i > 0)
+			pen += m_atlas->kerning(static_cast<Uint8>(line.text[i - 1]), character);
+
+		line.offsets[i] = pen;
+		pen += m_atlas->advance(character);
+	}
+	line.offsets[count] = pen;
+
+	line.dirtyFrom = std::string::npos;
+	++m_layouts;
+}
+
+void LTextBuffer::clampCursor()
+{
+	m_cursorColumn = SDL_min(m_cursorColumn, static_cast<int>(m_lines[m_cursorLine].text.size()));
+}
\ No newline at end of file
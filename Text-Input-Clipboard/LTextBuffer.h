@@ -0,0 +1,108 @@
+#pragma once
+#include "SDL2/SDL.h"
+
+#include "LGlyphAtlas.h"
+
+#include <string>
+#include <vector>
+
+/* Global renderer */
+extern SDL_Renderer* renderer;
+
+/* Editable multi line text, laying out only lines that changed and are shown */
+class LTextBuffer
+{
+public:
+	/* Bytes of queued text moved into the buffer per update */
+	static const size_t INSERT_BYTES_PER_UPDATE = 64 * 1024;
+	/* Text longer than this gets queued instead of inserted at once */
+	static const size_t QUEUE_THRESHOLD = 4 * 1024;
+
+	LTextBuffer();
+
+	/* Set atlas glyphs get measured and drawn with */
+	void setAtlas(LGlyphAtlas* atlas);
+
+	/* Replace whole text, cursor goes to its end */
+	void setText(const std::string& text);
+	/* Get whole text, lines joined with new lines */
+	std::string getText();
+
+	/* Insert text at cursor, long text is queued and moved in over several updates */
+	void insert(const std::string& text);
+	/* Remove character before or after cursor */
+	void backspace();
+	void deleteForward();
+
+	/* Move cursor */
+	void moveLeft();
+	void moveRight();
+	void moveUp();
+	void moveDown();
+	void moveHome();
+	void moveEnd();
+
+	/* Handle editing keys and text input, copy and paste included */
+	void handleEvent(const SDL_Event& e);
+
+	/* Move part of queued text in, true if some is still left */
+	bool update();
+	/* Move all of queued text in */
+	void flush();
+	/* Check if there is queued text */
+	bool queued() const;
+
+	/* Render lines fitting into area, cursor included */
+	void render(const SDL_Rect& area, SDL_Color color);
+
+	/* Get amount of lines */
+	int lineCount() const;
+	/* Get text of line */
+	const std::string& line(int index) const;
+	/* Get width of line, laying it out if needed */
+	int lineWidth(int index);
+
+	/* Get cursor position */
+	int cursorLine() const;
+	int cursorColumn() const;
+
+	/* Get amount of line layouts done so far */
+	int layouts() const;
+
+private:
+	struct Line
+	{
+		std::string text;
+		/* Position of each character and the end of line */
+		std::vector<int> offsets;
+		/* First character whose position changed since last layout, npos if none did */
+		size_t dirtyFrom;
+	};
+
+	/* Insert text at cursor straight away */
+	void insertNow(const char* text, size_t length);
+
+	/* Mark characters of line from given one on as needing layout */
+	static void invalidate(Line& line, size_t from);
+
+	/* Position characters of line that changed, the ones before them keep their offsets */
+	void layout(Line& line);
+
+	/* Keep cursor column inside its line */
+	void clampCursor();
+
+	LGlyphAtlas* m_atlas;
+	std::vector<Line> m_lines;
+
+	int m_cursorLine, m_cursorColumn;
+
+	/* First shown line and horizontal scroll of lines wider than area */
+	int m_firstLine;
+	int m_scrollX;
+
+	/* Text waiting to be inserted and how much of it is in already */
+	std::string m_queue;
+	size_t m_queueOffset;
+
+	int m_layouts;
+};
\ No newline at end of file
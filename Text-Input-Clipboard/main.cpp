@@ -3,10 +3,14 @@
 #include "SDL2/SDL_ttf.h"
 
 #include "LTexture.h"
+#include "LGlyphAtlas.h"
+#include "LTextBuffer.h"
 
 #include <stdio.h>
+#include <string.h>
 #include <string>
 #include <sstream>
+#include <random>
 
 
 /* Initialize the program */
@@ -15,6 +19,8 @@ bool init();
 bool loadMedia();
 /* Clean up */
 void close();
+/* Compare typing and pasting through the text buffer with rendering whole text each time */
+bool runBenchmark();
 
 
 /* Screen dimensions */
@@ -30,11 +36,23 @@ TTF_Font* font = nullptr;
 
 /* Text textures */
 LTexture promptText;
-LTexture writeText;
+
+/* Glyphs input text is drawn with */
+LGlyphAtlas textAtlas;
+/* Edited text */
+LTextBuffer inputText;
 
 
 int main(int argc, char* args[])
 {
+	/* Benchmark mode, render offscreen without waiting for VSync */
+	bool benchmark = argc > 1 && strcmp(args[1], "--bench") == 0;
+	if (benchmark) {
+		SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+		SDL_SetHint(SDL_HINT_RENDER_DRIVER, "software");
+		SDL_SetHint(SDL_HINT_RENDER_VSYNC, "0");
+	}
+
 	/* Initialize */
 	if (!init()) {
 		printf("Failed to initialize!\n");
@@ -49,6 +67,11 @@ int main(int argc, char* args[])
 		return -1;
 	}
 
+	if (benchmark) {
+		bool passed = runBenchmark();
+		close();
+		return passed ? 0 : -1;
+	}
 
 	bool quit = false;
 	SDL_Event e;
@@ -57,69 +80,23 @@ int main(int argc, char* args[])
 	SDL_Color textColor = { 0, 0, 0, 0xFF };
 
 	/* Current input text */
-	std::string inputText = "Some Text";
-	if (!writeText.loadFromRenderedText(inputText.c_str(), textColor))
-		printf("Couldn't load input text!\n");
+	inputText.setText("Some Text");
 
 	/* Enable text input */
 	SDL_StartTextInput();
 
 	while (!quit) {
-		/* Rerender flag */
-		bool renderText = false;
-
 		while (SDL_PollEvent(&e)) {
 			if (e.type == SDL_QUIT)
 				quit = true;
 
-			/* Special key input */
-			else if (e.type == SDL_KEYDOWN) {
-				/* Handle backspace */
-				if (e.key.keysym.sym == SDLK_BACKSPACE && inputText.size() > 0) {
-					/* Lop off character */
-					inputText.pop_back();
-					renderText = true;
-				}
-				/* Handle copy */
-				else if (e.key.keysym.sym == SDLK_c && SDL_GetModState() & KMOD_CTRL)
-					SDL_SetClipboardText(inputText.c_str());
-				/* Handle paste */
-				else if (e.key.keysym.sym == SDLK_v && SDL_GetModState() & KMOD_CTRL) {
-					/* Copy text from temp buffer */
-					char* tempText = SDL_GetClipboardText();
-					inputText = tempText;
-					SDL_free(tempText);
-
-					renderText = true;
-				}
-			}
-
-			/* Special key input event */
-			else if (e.type == SDL_TEXTINPUT) {
-				/* Not copy or pasting */
-				if (!(SDL_GetModState() & KMOD_CTRL && (e.text.text[0] == 'c' || e.text.text[0] == 'C' ||
-					e.text.text[0] == 'v' || e.text.text[0] == 'V'))) {
-					/* Append character */
-					inputText += e.text.text;
-					renderText = true;
-				}
-			}
-		}
-
-		/* Render text if needed */
-		if (renderText) {
-			/* Text is not empty */
-			if (inputText != "") {
-				/* Load text */
-				writeText.loadFromRenderedText(inputText.c_str(), textColor);
-			}
-			/* Text is empty */
-			else {
-				/* Load space texture */
-				writeText.loadFromRenderedText(" ", textColor);
-			}
+			/* Editing, copy and paste */
+			else
+				inputText.handleEvent(e);
 		}
 
+		/* Move in part of pasted text */
+		inputText.update();
 
 		/* Clear screen */
 		SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
@@ -127,7 +104,8 @@ int main(int argc, char* args[])
 
 		/* Render text */
 		promptText.render((SCREEN_WIDTH - promptText.width()) / 2 , 0);
-		writeText.render((SCREEN_WIDTH - writeText.width()) / 2, promptText.height());
+		SDL_Rect textArea = { 0, promptText.height(), SCREEN_WIDTH, SCREEN_HEIGHT - promptText.height() };
+		inputText.render(textArea, textColor);
 
 		/* Update screen */
 		SDL_RenderPresent(renderer);
@@ -205,6 +183,13 @@ bool loadMedia()
 			printf("Couldn't render prompt text!\n");
 			success = false;
 		}
+
+		/* Create atlas input text is drawn from */
+		if (!textAtlas.create(font)) {
+			printf("Couldn't create glyph atlas!\n");
+			success = false;
+		}
+		inputText.setAtlas(&textAtlas);
 	}
 
 	return success;
@@ -214,7 +199,7 @@ void close()
 {
 	/* Free textures */
 	promptText.free();
-	writeText.free();
+	textAtlas.free();
 
 	/* Close the font */
 	TTF_CloseFont(font);
@@ -230,4 +215,204 @@ void close()
 	TTF_Quit();
 	IMG_Quit();
 	SDL_Quit();
-} 
\ No newline at end of file
+} 
+
+bool runBenchmark()
+{
+	SDL_Color textColor = { 0, 0, 0, 0xFF };
+	SDL_Rect textArea = { 0, promptText.height(), SCREEN_WIDTH, SCREEN_HEIGHT - promptText.height() };
+	Uint64 frequency = SDL_GetPerformanceFrequency();
+	std::mt19937 random(13);
+	bool passed = true;
+
+	/* Draw one frame with text buffer */
+	auto drawFrame = [&]() {
+		SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
+		SDL_RenderClear(renderer);
+		inputText.render(textArea, textColor);
+		SDL_RenderPresent(renderer);
+	};
+
+	/* Type a line one key at a time, rendering whole text into a texture after each key like before */
+	const int KEYSTROKES = 300;
+	std::string typed;
+	LTexture typedTexture;
+	Uint64 start = SDL_GetPerformanceCounter();
+	for (int i = 0; i < KEYSTROKES; ++i) {
+		typed += static_cast<char>('a' + i % 26);
+		typedTexture.loadFromRenderedText(typed.c_str(), textColor);
+
+		SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
+		SDL_RenderClear(renderer);
+		typedTexture.render((SCREEN_WIDTH - typedTexture.width()) / 2, textArea.y);
+		SDL_RenderPresent(renderer);
+	}
+	double textureMs = (SDL_GetPerformanceCounter() - start) * 1000.0 / frequency / KEYSTROKES;
+	typedTexture.free();
+
+	/* Same keys through text buffer */
+	inputText.setText("");
+	int layouts = inputText.layouts();
+	start = SDL_GetPerformanceCounter();
+	for (int i = 0; i < KEYSTROKES; ++i) {
+		inputText.insert(std::string(1, static_cast<char>('a' + i % 26)));
+		drawFrame();
+	}
+	double bufferMs = (SDL_GetPerformanceCounter() - start) * 1000.0 / frequency / KEYSTROKES;
+
+	printf("typing %d keys: whole text texture %.4f ms/key, text buffer %.4f ms/key (%.2f layouts/key)\n",
+		KEYSTROKES, textureMs, bufferMs, static_cast<double>(inputText.layouts() - layouts) / KEYSTROKES);
+
+	/* Paste few megabytes of lines, with some \r\n mixed in */
+	std::string clipboard;
+	std::string expected;
+	while (clipboard.size() < 4 * 1024 * 1024) {
+		int length = random() % 120;
+		for (int i = 0; i < length; ++i)
+			clipboard += static_cast<char>(' ' + random() % 95);
+		expected += clipboard.substr(clipboard.size() - length);
+
+		if (random() % 4 == 0)
+			clipboard += '\r';
+		clipboard += '\n';
+		expected += '\n';
+	}
+
+	inputText.setText("");
+	inputText.insert(clipboard);
+
+	int frames = 0;
+	double worstMs = 0.0;
+	while (inputText.queued()) {
+		start = SDL_GetPerformanceCounter();
+		inputText.update();
+		drawFrame();
+		worstMs = SDL_max(worstMs, (SDL_GetPerformanceCounter() - start) * 1000.0 / frequency);
+		++frames;
+	}
+
+	/* The whole paste at once, for comparison */
+	inputText.setText("");
+	inputText.insert(clipboard);
+	start = SDL_GetPerformanceCounter();
+	inputText.flush();
+	drawFrame();
+	double wholeMs = (SDL_GetPerformanceCounter() - start) * 1000.0 / frequency;
+
+	printf("pasting %zu bytes, %d lines: %d frames, worst %.3f ms, at once %.3f ms\n", clipboard.size(),
+		inputText.lineCount(), frames, worstMs, wholeMs);
+
+	if (inputText.getText() != expected) {
+		printf("Pasted text doesn't match!\n");
+		passed = false;
+	}
+
+	/* Paste few megabytes without any new line, every part lands on the same line behind the cursor */
+	std::string longLine;
+	while (longLine.size() < 4 * 1024 * 1024)
+		longLine += static_cast<char>(' ' + random() % 95);
+
+	inputText.setText("");
+	inputText.insert(longLine);
+
+	int longFrames = 0;
+	double longWorstMs = 0.0;
+	while (inputText.queued()) {
+		start = SDL_GetPerformanceCounter();
+		inputText.update();
+		drawFrame();
+		longWorstMs = SDL_max(longWorstMs, (SDL_GetPerformanceCounter() - start) * 1000.0 / frequency);
+		++longFrames;
+	}
+
+	printf("pasting %zu bytes on one line: %d frames, worst %.3f ms\n", longLine.size(), longFrames, longWorstMs);
+
+	/* Only characters added each frame get measured, measuring the whole line again would blow the budget as it grows */
+	const double FRAME_BUDGET_MS = 1000.0 / 60;
+	if (longWorstMs > FRAME_BUDGET_MS) {
+		printf("Pasting one long line takes longer than a frame!\n");
+		passed = false;
+	}
+
+	if (inputText.getText() != longLine || inputText.lineWidth(0) != textAtlas.textWidth(longLine)) {
+		printf("Pasted line doesn't match!\n");
+		passed = false;
+	}
+
+	/* Random edits, checked against plain string */
+	const int EDITS = 20000;
+	std::string model = "Some Text";
+	size_t cursor = model.size();
+	inputText.setText(model);
+	drawFrame();
+
+	int relayouts = 0;
+	for (int i = 0; i < EDITS && passed; ++i) {
+		int action = random() % 10;
+		bool sameLine = inputText.cursorColumn() > 0;
+		layouts = inputText.layouts();
+
+		if (action < 4) {
+			char character = static_cast<char>(' ' + random() % 95);
+			inputText.insert(std::string(1, character));
+			model.insert(cursor++, 1, character);
+		}
+		else if (action == 4) {
+			inputText.insert("\n");
+			model.insert(cursor++, 1, '\n');
+		}
+		else if (action == 5) {
+			inputText.backspace();
+			if (cursor > 0)
+				model.erase(--cursor, 1);
+		}
+		else if (action == 6) {
+			inputText.deleteForward();
+			if (cursor < model.size())
+				model.erase(cursor, 1);
+		}
+		else {
+			/* Moving around, take cursor from text buffer */
+			switch (action) {
+			case 7: random() % 2 ? inputText.moveLeft() : inputText.moveRight(); break;
+			case 8: random() % 2 ? inputText.moveUp() : inputText.moveDown(); break;
+			default: random() % 2 ? inputText.moveHome() : inputText.moveEnd(); break;
+			}
+
+			cursor = 0;
+			for (int line = 0; line < inputText.cursorLine(); ++line)
+				cursor += inputText.line(line).size() + 1;
+			cursor += inputText.cursorColumn();
+		}
+		drawFrame();
+
+		/* Editing inside a line should only lay that line out again */
+		bool typing = action < 4 || (action == 5 && sameLine);
+		if (typing && inputText.layouts() - layouts != 1)
+			++relayouts;
+
+		if (i % 1000 == 0 && inputText.getText() != model) {
+			printf("Text doesn't match after %d edits!\n", i);
+			passed = false;
+		}
+	}
+
+	if (inputText.getText() != model) {
+		printf("Text doesn't match after edits!\n");
+		passed = false;
+	}
+
+	/* Cached layouts have to match measuring from scratch */
+	int wrongWidths = 0;
+	for (int i = 0; i < inputText.lineCount(); ++i) {
+		if (inputText.lineWidth(i) != textAtlas.textWidth(inputText.line(i)))
+			++wrongWidths;
+	}
+
+	printf("%d random edits: %d lines, %d edits laid out other than 1 line, %d wrong line widths\n", EDITS,
+		inputText.lineCount(), relayouts, wrongWidths);
+
+	passed = passed && relayouts == 0 && wrongWidths == 0;
+	printf("Text buffer benchmark %s\n", passed ? "passed" : "FAILED");
+	return passed;
+}
\ No newline at end of file
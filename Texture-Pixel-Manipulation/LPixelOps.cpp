@@ -0,0 +1,442 @@
+#include "LPixelOps.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define LPIXELOPS_X86 1
+#include <immintrin.h>
+#endif
+
+/* GCC and Clang only emit AVX2 in functions marked for it, MSVC always does */
+#if defined(__GNUC__) || defined(__clang__)
+#define LPIXELOPS_AVX2 __attribute__((target("avx2")))
+#else
+#define LPIXELOPS_AVX2
+#endif
+
+
+PixelKernel LPixelOps::s_kernel = LPixelOps::bestKernel();
+
+/* Scalar kernels, the reference every vector kernel has to match bit for bit */
+
+static size_t colorKeyToAlphaScalar(Uint32* pixels, size_t count, Uint32 colorKey, Uint32 transparent)
+{
+	size_t replaced = 0;
+	for (size_t i = 0; i < count; ++i) {
+		if (pixels[i] == colorKey) {
+			pixels[i] = transparent;
+			++replaced;
+		}
+	}
+	return replaced;
+}
+
+static size_t countColorKeyScalar(const Uint32* pixels, size_t count, Uint32 colorKey)
+{
+	size_t keyed = 0;
+	for (size_t i = 0; i < count; ++i)
+		keyed += pixels[i] == colorKey;
+	return keyed;
+}
+
+/* Exact round(color * alpha / 255) without division */
+static inline Uint32 multiplyAlpha(Uint32 color, Uint32 alpha)
+{
+	Uint32 product = color * alpha + 128;
+	return (product + (product >> 8)) >> 8;
+}
+
+static void premultiplyAlphaScalar(Uint32* pixels, size_t count, int alphaShift)
+{
+	for (size_t i = 0; i < count; ++i) {
+		Uint32 pixel = pixels[i];
+		Uint32 alpha = (pixel >> alphaShift) & 0xFF;
+
+		Uint32 result = alpha << alphaShift;
+		for (int shift = 0; shift < 32; shift += 8) {
+			if (shift != alphaShift)
+				result |= multiplyAlpha((pixel >> shift) & 0xFF, alpha) << shift;
+		}
+		pixels[i] = result;
+	}
+}
+
+static void swizzleScalar(Uint32* pixels, size_t count, const int order[4])
+{
+	for (size_t i = 0; i < count; ++i) {
+		Uint32 pixel = pixels[i];
+		pixels[i] = (((pixel >> (order[0] * 8)) & 0xFF)) | (((pixel >> (order[1] * 8)) & 0xFF) << 8) |
+			(((pixel >> (order[2] * 8)) & 0xFF) << 16) | (((pixel >> (order[3] * 8)) & 0xFF) << 24);
+	}
+}
+
+#if defined(LPIXELOPS_X86)
+/* SSE2 kernels, 4 pixels at a time, leftovers go through the scalar ones */
+
+/* Add up the four 32 bit lanes */
+static inline size_t sumLanes(__m128i lanes)
+{
+	lanes = _mm_add_epi32(lanes, _mm_shuffle_epi32(lanes, _MM_SHUFFLE(1, 0, 3, 2)));
+	lanes = _mm_add_epi32(lanes, _mm_shuffle_epi32(lanes, _MM_SHUFFLE(2, 3, 0, 1)));
+	return static_cast<Uint32>(_mm_cvtsi128_si32(lanes));
+}
+
+/* Pixels counted before lane counters get summed, so the sum can't overflow */
+static const size_t COUNT_BLOCK = 1 << 24;
+
+static size_t colorKeyToAlphaSSE2(Uint32* pixels, size_t count, Uint32 colorKey, Uint32 transparent)
+{
+	const __m128i key = _mm_set1_epi32(static_cast<int>(colorKey));
+	const __m128i replacement = _mm_set1_epi32(static_cast<int>(transparent));
+
+	size_t replaced = 0, i = 0;
+	while (count - i >= 4) {
+		/* Matching lanes count down by one each */
+		__m128i matches = _mm_setzero_si128();
+		size_t end = i + SDL_min((count - i) & ~static_cast<size_t>(3), COUNT_BLOCK);
+		for (; i < end; i += 4) {
+			__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&pixels[i]));
+			__m128i equal = _mm_cmpeq_epi32(block, key);
+			block = _mm_or_si128(_mm_and_si128(equal, replacement), _mm_andnot_si128(equal, block));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(&pixels[i]), block);
+			matches = _mm_sub_epi32(matches, equal);
+		}
+		replaced += sumLanes(matches);
+	}
+
+	return replaced + colorKeyToAlphaScalar(&pixels[i], count - i, colorKey, transparent);
+}
+
+static size_t countColorKeySSE2(const Uint32* pixels, size_t count, Uint32 colorKey)
+{
+	const __m128i key = _mm_set1_epi32(static_cast<int>(colorKey));
+
+	size_t keyed = 0, i = 0;
+	while (count - i >= 4) {
+		__m128i matches = _mm_setzero_si128();
+		size_t end = i + SDL_min((count - i) & ~static_cast<size_t>(3), COUNT_BLOCK);
+		for (; i < end; i += 4) {
+			__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&pixels[i]));
+			matches = _mm_sub_epi32(matches, _mm_cmpeq_epi32(block, key));
+		}
+		keyed += sumLanes(matches);
+	}
+
+	return keyed + countColorKeyScalar(&pixels[i], count - i, colorKey);
+}
+
+/* Premultiply two pixels widened to 16 bit lanes, alpha being lane ALPHA of each pixel */
+template <int ALPHA>
+static inline __m128i multiplyAlphaSSE2(__m128i colors, __m128i alphaLanes)
+{
+	/* Spread alpha over all four lanes of its pixel */
+	__m128i alpha = _mm_shufflelo_epi16(colors, _MM_SHUFFLE(ALPHA, ALPHA, ALPHA, ALPHA));
+	alpha = _mm_shufflehi_epi16(alpha, _MM_SHUFFLE(ALPHA, ALPHA, ALPHA, ALPHA));
+
+	/* Same rounding as the scalar kernel */
+	__m128i product = _mm_add_epi16(_mm_mullo_epi16(colors, alpha), _mm_set1_epi16(128));
+	product = _mm_srli_epi16(_mm_add_epi16(product, _mm_srli_epi16(product, 8)), 8);
+
+	/* Alpha itself stays */
+	return _mm_or_si128(_mm_and_si128(alphaLanes, colors), _mm_andnot_si128(alphaLanes, product));
+}
+
+template <int ALPHA>
+static void premultiplyAlphaSSE2(Uint32* pixels, size_t count)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i alphaLanes = _mm_set_epi16(ALPHA == 3 ? -1 : 0, ALPHA == 2 ? -1 : 0, ALPHA == 1 ? -1 : 0,
+		ALPHA == 0 ? -1 : 0, ALPHA == 3 ? -1 : 0, ALPHA == 2 ? -1 : 0, ALPHA == 1 ? -1 : 0, ALPHA == 0 ? -1 : 0);
+
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&pixels[i]));
+		__m128i low = multiplyAlphaSSE2<ALPHA>(_mm_unpacklo_epi8(block, zero), alphaLanes);
+		__m128i high = multiplyAlphaSSE2<ALPHA>(_mm_unpackhi_epi8(block, zero), alphaLanes);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(&pixels[i]), _mm_packus_epi16(low, high));
+	}
+
+	premultiplyAlphaScalar(&pixels[i], count - i, ALPHA * 8);
+}
+
+static void swizzleSSE2(Uint32* pixels, size_t count, const int order[4])
+{
+	/* No byte shuffle in SSE2, so move each byte with a shift pair */
+	const __m128i byteMask = _mm_set1_epi32(0xFF);
+	__m128i right[4], left[4];
+	for (int byte = 0; byte < 4; ++byte) {
+		right[byte] = _mm_cvtsi32_si128(order[byte] * 8);
+		left[byte] = _mm_cvtsi32_si128(byte * 8);
+	}
+
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&pixels[i]));
+		__m128i result = _mm_setzero_si128();
+		for (int byte = 0; byte < 4; ++byte) {
+			__m128i channel = _mm_and_si128(_mm_srl_epi32(block, right[byte]), byteMask);
+			result = _mm_or_si128(result, _mm_sll_epi32(channel, left[byte]));
+		}
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(&pixels[i]), result);
+	}
+
+	swizzleScalar(&pixels[i], count - i, order);
+}
+
+/* AVX2 kernels, 8 pixels at a time */
+
+LPIXELOPS_AVX2 static inline size_t sumLanesAVX2(__m256i lanes)
+{
+	__m128i half = _mm_add_epi32(_mm256_castsi256_si128(lanes), _mm256_extracti128_si256(lanes, 1));
+	half = _mm_add_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(1, 0, 3, 2)));
+	half = _mm_add_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(2, 3, 0, 1)));
+	return static_cast<Uint32>(_mm_cvtsi128_si32(half));
+}
+
+LPIXELOPS_AVX2 static size_t colorKeyToAlphaAVX2(Uint32* pixels, size_t count, Uint32 colorKey,
+	Uint32 transparent)
+{
+	const __m256i key = _mm256_set1_epi32(static_cast<int>(colorKey));
+	const __m256i replacement = _mm256_set1_epi32(static_cast<int>(transparent));
+
+	size_t replaced = 0, i = 0;
+	while (count - i >= 8) {
+		__m256i matches = _mm256_setzero_si256();
+		size_t end = i + SDL_min((count - i) & ~static_cast<size_t>(7), COUNT_BLOCK);
+		for (; i < end; i += 8) {
+			__m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&pixels[i]));
+			__m256i equal = _mm256_cmpeq_epi32(block, key);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(&pixels[i]), _mm256_blendv_epi8(block, replacement, equal));
+			matches = _mm256_sub_epi32(matches, equal);
+		}
+		replaced += sumLanesAVX2(matches);
+	}
+
+	return replaced + colorKeyToAlphaScalar(&pixels[i], count - i, colorKey, transparent);
+}
+
+LPIXELOPS_AVX2 static size_t countColorKeyAVX2(const Uint32* pixels, size_t count, Uint32 colorKey)
+{
+	const __m256i key = _mm256_set1_epi32(static_cast<int>(colorKey));
+
+	size_t keyed = 0, i = 0;
+	while (count - i >= 8) {
+		__m256i matches = _mm256_setzero_si256();
+		size_t end = i + SDL_min((count - i) & ~static_cast<size_t>(7), COUNT_BLOCK);
+		for (; i < end; i += 8) {
+			__m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&pixels[i]));
+			matches = _mm256_sub_epi32(matches, _mm256_cmpeq_epi32(block, key));
+		}
+		keyed += sumLanesAVX2(matches);
+	}
+
+	return keyed + countColorKeyScalar(&pixels[i], count - i, colorKey);
+}
+
+LPIXELOPS_AVX2 static void premultiplyAlphaAVX2(Uint32* pixels, size_t count, int alphaShift)
+{
+	const int alphaByte = alphaShift / 8;
+
+	/* Byte shuffle spreading alpha of each pixel over 16 bit lanes of the widened pixel */
+	Sint8 spread[16], lanes[16];
+	for (int pixel = 0; pixel < 2; ++pixel) {
+		for (int channel = 0; channel < 4; ++channel) {
+			int lane = (pixel * 4 + channel) * 2;
+			spread[lane] = static_cast<Sint8>(pixel * 8 + alphaByte * 2);
+			spread[lane + 1] = -1;
+			lanes[lane] = lanes[lane + 1] = (channel == alphaByte) ? -1 : 0;
+		}
+	}
+	const __m256i spreadAlpha = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(spread)));
+	const __m256i alphaLanes = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(lanes)));
+	const __m256i rounding = _mm256_set1_epi16(128);
+	const __m256i zero = _mm256_setzero_si256();
+
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8) {
+		__m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&pixels[i]));
+
+		/* Widen within each 128 bit half, packing restores the order */
+		__m256i halves[2] = { _mm256_unpacklo_epi8(block, zero), _mm256_unpackhi_epi8(block, zero) };
+		for (__m256i& colors : halves) {
+			__m256i alpha = _mm256_shuffle_epi8(colors, spreadAlpha);
+			__m256i product = _mm256_add_epi16(_mm256_mullo_epi16(colors, alpha), rounding);
+			product = _mm256_srli_epi16(_mm256_add_epi16(product, _mm256_srli_epi16(product, 8)), 8);
+			colors = _mm256_blendv_epi8(product, colors, alphaLanes);
+		}
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(&pixels[i]), _mm256_packus_epi16(halves[0], halves[1]));
+	}
+
+	premultiplyAlphaScalar(&pixels[i], count - i, alphaShift);
+}
+
+LPIXELOPS_AVX2 static void swizzleAVX2(Uint32* pixels, size_t count, const int order[4])
+{
+	Sint8 shuffle[16];
+	for (int pixel = 0; pixel < 4; ++pixel) {
+		for (int byte = 0; byte < 4; ++byte)
+			shuffle[pixel * 4 + byte] = static_cast<Sint8>(pixel * 4 + order[byte]);
+	}
+	const __m256i bytes = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(shuffle)));
+
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8) {
+		__m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&pixels[i]));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(&pixels[i]), _mm256_shuffle_epi8(block, bytes));
+	}
+
+	swizzleScalar(&pixels[i], count - i, order);
+}
+#endif
+
+
+PixelKernel LPixelOps::bestKernel()
+{
+#if defined(LPIXELOPS_X86)
+	if (SDL_HasAVX2())
+		return PixelKernel::AVX2;
+	if (SDL_HasSSE2())
+		return PixelKernel::SSE2;
+#endif
+	return PixelKernel::SCALAR;
+}
+
+void LPixelOps::setKernel(PixelKernel kernel)
+{
+	/* Never pick instructions the CPU lacks */
+	PixelKernel best = bestKernel();
+	s_kernel = (static_cast<int>(kernel) <= static_cast<int>(best)) ? kernel : best;
+}
+
+PixelKernel LPixelOps::getKernel()
+{
+	return s_kernel;
+}
+
+const char* LPixelOps::kernelName(PixelKernel kernel)
+{
+	switch (kernel) {
+	case PixelKernel::SSE2:
+		return "SSE2";
+	case PixelKernel::AVX2:
+		return "AVX2";
+	default:
+		return "scalar";
+	}
+}
+
+size_t LPixelOps::colorKeyToAlpha(Uint32* pixels, size_t count, Uint32 colorKey, Uint32 transparent)
+{
+#if defined(LPIXELOPS_X86)
+	if (s_kernel == PixelKernel::AVX2)
+		return colorKeyToAlphaAVX2(pixels, count, colorKey, transparent);
+	if (s_kernel == PixelKernel::SSE2)
+		return colorKeyToAlphaSSE2(pixels, count, colorKey, transparent);
+#endif
+	return colorKeyToAlphaScalar(pixels, count, colorKey, transparent);
+}
+
+size_t LPixelOps::countColorKey(const Uint32* pixels, size_t count, Uint32 colorKey)
+{
+#if defined(LPIXELOPS_X86)
+	if (s_kernel == PixelKernel::AVX2)
+		return countColorKeyAVX2(pixels, count, colorKey);
+	if (s_kernel == PixelKernel::SSE2)
+		return countColorKeySSE2(pixels, count, colorKey);
+#endif
+	return countColorKeyScalar(pixels, count, colorKey);
+}
+
+bool LPixelOps::premultiplyAlpha(Uint32* pixels, size_t count, int alphaShift)
+{
+	/* Kernels work on whole bytes, any other shift would split alpha between two of them */
+	if (alphaShift != 0 && alphaShift != 8 && alphaShift != 16 && alphaShift != 24) {
+		printf("Alpha shift %d isn't 0, 8, 16 or 24!\n", alphaShift);
+		return false;
+	}
+
+#if defined(LPIXELOPS_X86)
+	if (s_kernel == PixelKernel::AVX2) {
+		premultiplyAlphaAVX2(pixels, count, alphaShift);
+		return true;
+	}
+	if (s_kernel == PixelKernel::SSE2) {
+		/* Shuffles need alpha position at compile time */
+		switch (alphaShift) {
+		case 0:
+			premultiplyAlphaSSE2<0>(pixels, count);
+			return true;
+		case 8:
+			premultiplyAlphaSSE2<1>(pixels, count);
+			return true;
+		case 16:
+			premultiplyAlphaSSE2<2>(pixels, count);
+			return true;
+		default:
+			premultiplyAlphaSSE2<3>(pixels, count);
+			return true;
+		}
+	}
+#endif
+	premultiplyAlphaScalar(pixels, count, alphaShift);
+	return true;
+}
+
+void LPixelOps::swizzle(Uint32* pixels, size_t count, const int order[4])
+{
+#if defined(LPIXELOPS_X86)
+	if (s_kernel == PixelKernel::AVX2) {
+		swizzleAVX2(pixels, count, order);
+		return;
+	}
+	if (s_kernel == PixelKernel::SSE2) {
+		swizzleSSE2(pixels, count, order);
+		return;
+	}
+#endif
+	swizzleScalar(pixels, count, order);
+}
+
+bool LPixelOps::convertFormat(Uint32* pixels, size_t count, Uint32 fromFormat, Uint32 toFormat)
+{
+	SDL_PixelFormat* from = SDL_AllocFormat(fromFormat);
+	SDL_PixelFormat* to = SDL_AllocFormat(toFormat);
+
+	bool success = from && to && from->BytesPerPixel == 4 && to->BytesPerPixel == 4;
+	if (!success)
+		printf("Can only convert between 32 bit pixel formats!\n");
+	else {
+		/* Byte of each channel in both formats, the one without a channel is the unused byte */
+		const Uint32 fromMasks[4] = { from->Rmask, from->Gmask, from->Bmask, from->Amask };
+		const Uint32 toMasks[4] = { to->Rmask, to->Gmask, to->Bmask, to->Amask };
+
+		int order[4] = { -1, -1, -1, -1 };
+		bool used[4] = { false, false, false, false };
+		for (int channel = 0; channel < 4; ++channel) {
+			for (int toByte = 0; toByte < 4; ++toByte) {
+				for (int fromByte = 0; fromByte < 4; ++fromByte) {
+					if (toMasks[channel] == (0xFFu << (toByte * 8)) && fromMasks[channel] == (0xFFu << (fromByte * 8))) {
+						order[toByte] = fromByte;
+						used[fromByte] = true;
+					}
+				}
+			}
+		}
+
+		/* Bytes left over go to the bytes left over */
+		for (int toByte = 0; toByte < 4; ++toByte) {
+			for (int fromByte = 0; order[toByte] < 0 && fromByte < 4; ++fromByte) {
+				if (!used[fromByte]) {
+					order[toByte] = fromByte;
+					used[fromByte] = true;
+				}
+			}
+		}
+
+		swizzle(pixels, count, order);
+	}
+
+	if (from)
+		SDL_FreeFormat(from);
+	if (to)
+		SDL_FreeFormat(to);
+	return success;
+}
\ No newline at end of file
@@ -0,0 +1,46 @@
+#pragma once
+#include "SDL2/SDL.h"
+
+#include <stddef.h>
+
+/* Instruction sets the pixel kernels are written for */
+enum class PixelKernel
+{
+	SCALAR,
+	SSE2,
+	AVX2
+};
+
+/* Bulk operations on 32 bit surface pixels, vectorized where the CPU allows it */
+class LPixelOps
+{
+public:
+	/* Get best kernel set the CPU supports */
+	static PixelKernel bestKernel();
+
+	/* Pick kernel set used from now on, falls back to the best supported one */
+	static void setKernel(PixelKernel kernel);
+	static PixelKernel getKernel();
+
+	/* Get name of kernel set */
+	static const char* kernelName(PixelKernel kernel);
+
+	/* Replace pixels equal to color key with transparent one, returns amount replaced */
+	static size_t colorKeyToAlpha(Uint32* pixels, size_t count, Uint32 colorKey, Uint32 transparent);
+
+	/* Count pixels equal to color key */
+	static size_t countColorKey(const Uint32* pixels, size_t count, Uint32 colorKey);
+
+	/* Multiply color channels by the alpha channel at given bit shift, rounding to nearest.
+	Alpha has to be a whole byte, so shift is 0, 8, 16 or 24, false and pixels untouched otherwise */
+	static bool premultiplyAlpha(Uint32* pixels, size_t count, int alphaShift);
+
+	/* Reorder bytes of every pixel, byte i of result is byte order[i] of source */
+	static void swizzle(Uint32* pixels, size_t count, const int order[4]);
+
+	/* Convert pixels between two 32 bit formats, false if either isn't one */
+	static bool convertFormat(Uint32* pixels, size_t count, Uint32 fromFormat, Uint32 toFormat);
+
+private:
+	static PixelKernel s_kernel;
+};
\ No newline at end of file
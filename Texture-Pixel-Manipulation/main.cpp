@@ -2,11 +2,12 @@
 #include "SDL2/SDL_image.h"
 
 #include "LTexture.h"
-#include "Dot.h"
+#include "LPixelOps.h"
 
 #include <stdio.h>
 #include <string>
 #include <fstream>
+#include <vector>
 
 
 /* Initialize the program */
@@ -16,6 +17,9 @@ bool loadMedia();
 /* Clean up */
 void close();
 
+/* Check pixel kernels against the scalar ones and measure them, false if any output differs */
+bool runBenchmark();
+
 
 /* Screen dimensions */
 const int SCREEN_WIDTH = 640;
@@ -31,6 +35,10 @@ LTexture guyTexture;
 
 int main(int argc, char* args[])
 {
+	/* Pixel kernels need no window */
+	if ((argc > 1) && (std::string(args[1]) == "--bench"))
+		return runBenchmark() ? 0 : -1;
+
 	/* Initialize */
 	if (!init()) {
 		printf("Failed to initialize!\n");
@@ -131,10 +139,7 @@ bool loadMedia()
 		Uint32 transparent = SDL_MapRGBA(SDL_GetWindowSurface(window)->format, 0xFF, 0xFF, 0xFF, 0x00);
 
 		/* Color key pixels */
-		for (int i = 0; i < pixelCount; ++i) {
-			if (pixels[i] == colorKey)
-				pixels[i] = transparent;
-		}
+		LPixelOps::colorKeyToAlpha(pixels, pixelCount, colorKey, transparent);
 
 		/* Create texture from manually color keyed pixels */
 		if (!guyTexture.loadFromPixels())
@@ -164,4 +169,91 @@ void close()
 	/* Quit the SDL library */
 	IMG_Quit();
 	SDL_Quit();
+}
+
+/* Run kernel on a fresh copy of the source several times, returns MPix/s */
+template <typename Kernel>
+static double measureKernel(const std::vector<Uint32>& source, std::vector<Uint32>& output, size_t& result,
+	Kernel kernel)
+{
+	const int RUNS = 5;
+
+	double seconds = 0.0;
+	for (int run = 0; run < RUNS; ++run) {
+		output = source;
+
+		Uint64 start = SDL_GetPerformanceCounter();
+		result = kernel(output.data(), output.size());
+		seconds += static_cast<double>(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+	}
+
+	return output.size() * RUNS / seconds / 1000000.0;
+}
+
+bool runBenchmark()
+{
+	/* Odd size leaves a tail for the scalar loops */
+	const size_t PIXELS = 2048 * 2048 - 3;
+
+	SDL_PixelFormat* format = SDL_AllocFormat(SDL_PIXELFORMAT_ARGB8888);
+	const Uint32 colorKey = SDL_MapRGBA(format, 0xFF, 0x00, 0xFF, 0xFF);
+	const Uint32 transparent = SDL_MapRGBA(format, 0xFF, 0xFF, 0xFF, 0x00);
+	SDL_FreeFormat(format);
+
+	/* Random atlas with a third of it color keyed */
+	srand(0);
+	std::vector<Uint32> source(PIXELS);
+	for (Uint32& pixel : source)
+		pixel = (rand() % 3 == 0) ? colorKey : (static_cast<Uint32>(rand()) << 16) ^ static_cast<Uint32>(rand());
+
+	/* Premultiplying runs once for each byte alpha can be in */
+	const char* names[] = { "color key to alpha", "color key detection", "premultiply alpha << 0",
+		"premultiply alpha << 8", "premultiply alpha << 16", "premultiply alpha << 24", "ARGB to ABGR swizzle" };
+	const int OPERATIONS = sizeof(names) / sizeof(names[0]);
+
+	bool passed = true;
+	const PixelKernel best = LPixelOps::bestKernel();
+	for (int op = 0; op < OPERATIONS; ++op) {
+		std::vector<Uint32> expected, output;
+		size_t expectedResult = 0;
+
+		for (int kernel = 0; kernel <= static_cast<int>(best); ++kernel) {
+			LPixelOps::setKernel(static_cast<PixelKernel>(kernel));
+
+			size_t result = 0;
+			double mpix = measureKernel(source, output, result, [op, colorKey, transparent](Uint32* pixels, size_t count) {
+				switch (op) {
+				case 0:
+					return LPixelOps::colorKeyToAlpha(pixels, count, colorKey, transparent);
+				case 1:
+					return LPixelOps::countColorKey(pixels, count, colorKey);
+				case 2:
+				case 3:
+				case 4:
+				case 5:
+					LPixelOps::premultiplyAlpha(pixels, count, (op - 2) * 8);
+					return static_cast<size_t>(0);
+				default:
+					LPixelOps::convertFormat(pixels, count, SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_ABGR8888);
+					return static_cast<size_t>(0);
+				}
+			});
+
+			/* Scalar kernel runs first and sets what the others must produce */
+			bool exact = true;
+			if (kernel == 0) {
+				expected = output;
+				expectedResult = result;
+			}
+			else
+				exact = output == expected && result == expectedResult;
+			passed &= exact;
+
+			printf("%-24s %-6s %10.1f MPix/s %s\n", names[op], LPixelOps::kernelName(static_cast<PixelKernel>(kernel)),
+				mpix, exact ? "bit-exact" : "MISMATCH");
+		}
+	}
+
+	LPixelOps::setKernel(best);
+	return passed;
 }
\ No newline at end of file
@@ -0,0 +1,411 @@
+#include "ChunkManager.h"
+
+#include <algorithm>
+#include <unordered_set>
+
+ChunkManager::ChunkManager() : m_columns(0), m_rows(0), m_chunkSize(0), m_chunkColumns(0), m_chunkRows(0),
+	m_prefetch(0), m_maxChunks(0), m_peakChunks(0), m_loadedChunks(0), m_thread(nullptr), m_lock(nullptr), m_wake(nullptr),
+	m_done(nullptr), m_loading(-1), m_quit(false), m_file(nullptr)
+{
+	SDL_zero(m_header);
+}
+
+ChunkManager::~ChunkManager()
+{
+	/* Stop loading */
+	close();
+}
+
+bool ChunkManager::open(const std::string& path, size_t memoryBudget, int chunkSize, int prefetch)
+{
+	/* Close preexisting map */
+	close();
+
+	m_file = SDL_RWFromFile(path.c_str(), "rb");
+	if (m_file == NULL) {
+		printf("Couldn't open tile map %s! SDL_Error: %s\n", path.c_str(), SDL_GetError());
+		return false;
+	}
+
+	/* Read header and check that the tiles are all there */
+	Uint8 data[sizeof(TileMapHeader)];
+	bool valid = SDL_RWread(m_file, data, sizeof(data), 1) == 1 && readTileMapHeader(data, sizeof(data), m_header);
+	Sint64 size = SDL_RWsize(m_file);
+	if (valid) {
+		Uint64 tileCount = static_cast<Uint64>(m_header.columns) * m_header.rows;
+		valid = size >= 0 && m_header.tilesOffset + tileCount <= static_cast<Uint64>(size);
+	}
+	if (!valid) {
+		printf("Invalid tile map %s!\n", path.c_str());
+		close();
+		return false;
+	}
+
+	m_columns = static_cast<int>(m_header.columns);
+	m_rows = static_cast<int>(m_header.rows);
+
+	/* Chunk layout */
+	if (chunkSize <= 0)
+		chunkSize = (m_header.chunkSize > 0) ? static_cast<int>(m_header.chunkSize) : DEFAULT_CHUNK_SIZE;
+	m_chunkSize = chunkSize;
+	m_chunkColumns = (m_columns + chunkSize - 1) / chunkSize;
+	m_chunkRows = (m_rows + chunkSize - 1) / chunkSize;
+	m_prefetch = SDL_max(prefetch, 0);
+
+	/* Budget decides how many chunks can stay resident */
+	m_maxChunks = static_cast<int>(SDL_max(memoryBudget / (static_cast<size_t>(chunkSize) * chunkSize), 1));
+
+	/* Uniform chunks from the index don't have to be read */
+	Uint64 chunkCount = static_cast<Uint64>(m_chunkColumns) * m_chunkRows;
+	if (m_header.chunkSize == static_cast<Uint32>(chunkSize) && m_header.chunkIndexOffset > 0 &&
+		m_header.chunkIndexOffset + chunkCount * sizeof(TileChunkInfo) <= static_cast<Uint64>(size)) {
+		m_chunkIndex.resize(static_cast<size_t>(chunkCount));
+		SDL_RWseek(m_file, static_cast<Sint64>(m_header.chunkIndexOffset), RW_SEEK_SET);
+		if (SDL_RWread(m_file, m_chunkIndex.data(), sizeof(TileChunkInfo), m_chunkIndex.size()) != m_chunkIndex.size())
+			m_chunkIndex.clear();
+	}
+
+	/* Start the loader */
+	m_lock = SDL_CreateMutex();
+	m_wake = SDL_CreateCond();
+	m_done = SDL_CreateCond();
+	m_quit = false;
+	m_thread = SDL_CreateThread(loaderThread, "ChunkLoader", this);
+	if (m_thread == NULL) {
+		printf("Couldn't create chunk loader thread! SDL_Error: %s\n", SDL_GetError());
+		close();
+		return false;
+	}
+
+	return true;
+}
+
+void ChunkManager::close()
+{
+	/* Stop the loader */
+	if (m_thread != NULL) {
+		SDL_LockMutex(m_lock);
+		m_quit = true;
+		SDL_CondSignal(m_wake);
+		SDL_UnlockMutex(m_lock);
+
+		SDL_WaitThread(m_thread, NULL);
+		m_thread = nullptr;
+	}
+
+	if (m_done != NULL) {
+		SDL_DestroyCond(m_done);
+		m_done = nullptr;
+	}
+	if (m_wake != NULL) {
+		SDL_DestroyCond(m_wake);
+		m_wake = nullptr;
+	}
+	if (m_lock != NULL) {
+		SDL_DestroyMutex(m_lock);
+		m_lock = nullptr;
+	}
+
+	if (m_file != NULL) {
+		SDL_RWclose(m_file);
+		m_file = nullptr;
+	}
+
+	/* Release chunks */
+	m_chunks.clear();
+	m_requests.clear();
+	m_loaded.clear();
+	m_chunkIndex.clear();
+	m_loading = -1;
+
+	m_columns = m_rows = 0;
+	m_chunkSize = m_chunkColumns = m_chunkRows = 0;
+	m_maxChunks = 0;
+	m_peakChunks = 0;
+	m_loadedChunks = 0;
+}
+
+void ChunkManager::update(const SDL_Rect& camera)
+{
+	if (m_thread == NULL)
+		return;
+
+	collectLoaded();
+
+	/* Chunks covering the camera plus prefetch border */
+	const int chunkWidth = m_chunkSize * TILE_WIDTH, chunkHeight = m_chunkSize * TILE_HEIGHT;
+	int firstColumn, lastColumn, firstRow, lastRow;
+	SDL_Rect area = { camera.x - m_prefetch * chunkWidth, camera.y - m_prefetch * chunkHeight,
+		camera.w + 2 * m_prefetch * chunkWidth, camera.h + 2 * m_prefetch * chunkHeight };
+	std::vector<Sint64> needed;
+	if (cellRange(area, m_columns, m_rows, firstColumn, lastColumn, firstRow, lastRow)) {
+		for (int row = firstRow / m_chunkSize; row <= lastRow / m_chunkSize; ++row) {
+			for (int column = firstColumn / m_chunkSize; column <= lastColumn / m_chunkSize; ++column)
+				needed.push_back(static_cast<Sint64>(row) * m_chunkColumns + column);
+		}
+	}
+
+	/* Nearest first, and only as many as the budget allows */
+	const int centerX = camera.x + camera.w / 2, centerY = camera.y + camera.h / 2;
+	std::sort(needed.begin(), needed.end(), [&](Sint64 a, Sint64 b) {
+		return chunkDistance(a, centerX, centerY) < chunkDistance(b, centerX, centerY);
+	});
+	if (static_cast<int>(needed.size()) > m_maxChunks)
+		needed.resize(m_maxChunks);
+
+	/* Replace stale requests with the missing chunks */
+	SDL_LockMutex(m_lock);
+	m_requests.clear();
+	for (Sint64 key : needed) {
+		if (key != m_loading && m_chunks.find(key) == m_chunks.end())
+			m_requests.push_back(key);
+	}
+	int incoming = static_cast<int>(m_requests.size()) + ((m_loading != -1) ? 1 : 0);
+	if (!m_requests.empty())
+		SDL_CondSignal(m_wake);
+	SDL_UnlockMutex(m_lock);
+
+	/* Evict farthest chunks that aren't needed to make room for the incoming ones */
+	if (static_cast<int>(m_chunks.size()) + incoming > m_maxChunks) {
+		std::unordered_set<Sint64> keep(needed.begin(), needed.end());
+
+		std::vector<Sint64> evictable;
+		for (const auto& chunk : m_chunks) {
+			if (keep.find(chunk.first) == keep.end())
+				evictable.push_back(chunk.first);
+		}
+		std::sort(evictable.begin(), evictable.end(), [&](Sint64 a, Sint64 b) {
+			return chunkDistance(a, centerX, centerY) > chunkDistance(b, centerX, centerY);
+		});
+
+		for (size_t i = 0; i < evictable.size() && static_cast<int>(m_chunks.size()) + incoming > m_maxChunks; ++i)
+			m_chunks.erase(evictable[i]);
+	}
+}
+
+void ChunkManager::waitForLoads()
+{
+	if (m_thread == NULL)
+		return;
+
+	SDL_LockMutex(m_lock);
+	while (!m_requests.empty() || m_loading != -1)
+		SDL_CondWait(m_done, m_lock);
+	SDL_UnlockMutex(m_lock);
+
+	collectLoaded();
+}
+
+bool ChunkManager::touchesWall(const SDL_Rect& box) const
+{
+	int firstColumn, lastColumn, firstRow, lastRow;
+	if (!cellRange(box, m_columns, m_rows, firstColumn, lastColumn, firstRow, lastRow))
+		return false;
+
+	for (int row = firstRow; row <= lastRow; ++row) {
+		for (int column = firstColumn; column <= lastColumn; ++column) {
+			/* Don't walk into unloaded chunks */
+			const Uint8* tiles = findChunk(column / m_chunkSize, row / m_chunkSize);
+			if (tiles == nullptr)
+				return true;
+
+			if (isWall(static_cast<Tiles>(tiles[(row % m_chunkSize) * m_chunkSize + column % m_chunkSize])))
+				return true;
+		}
+	}
+
+	/* No wall tiles were touched */
+	return false;
+}
+
+void ChunkManager::render(const SDL_Rect& camera, LSpriteBatch* batch) const
+{
+	int firstColumn, lastColumn, firstRow, lastRow;
+	if (!cellRange(camera, m_columns, m_rows, firstColumn, lastColumn, firstRow, lastRow))
+		return;
+
+	if (batch != nullptr)
+		batch->begin(tileTexture);
+
+	/* Go chunk by chunk so every chunk is looked up once */
+	for (int chunkRow = firstRow / m_chunkSize; chunkRow <= lastRow / m_chunkSize; ++chunkRow) {
+		for (int chunkColumn = firstColumn / m_chunkSize; chunkColumn <= lastColumn / m_chunkSize; ++chunkColumn) {
+			const Uint8* tiles = findChunk(chunkColumn, chunkRow);
+			if (tiles == nullptr)
+				continue;
+
+			/* Visible part of the chunk */
+			int rowStart = SDL_max(firstRow, chunkRow * m_chunkSize);
+			int rowEnd = SDL_min(lastRow, chunkRow * m_chunkSize + m_chunkSize - 1);
+			int columnStart = SDL_max(firstColumn, chunkColumn * m_chunkSize);
+			int columnEnd = SDL_min(lastColumn, chunkColumn * m_chunkSize + m_chunkSize - 1);
+
+			for (int row = rowStart; row <= rowEnd; ++row) {
+				const Uint8* line = &tiles[(row - chunkRow * m_chunkSize) * m_chunkSize];
+				int y = row * TILE_HEIGHT - camera.y;
+
+				for (int column = columnStart; column <= columnEnd; ++column) {
+					int x = column * TILE_WIDTH - camera.x;
+					Uint8 tile = line[column - chunkColumn * m_chunkSize];
+
+					/* Show the tile */
+					if (batch != nullptr)
+						batch->draw(x, y, &tileClips[tile]);
+					else
+						tileTexture.render(x, y, &tileClips[tile]);
+				}
+			}
+		}
+	}
+
+	if (batch != nullptr)
+		batch->flush();
+}
+
+int ChunkManager::width() const
+{
+	return m_columns * TILE_WIDTH;
+}
+
+int ChunkManager::height() const
+{
+	return m_rows * TILE_HEIGHT;
+}
+
+int ChunkManager::residentChunks() const
+{
+	return static_cast<int>(m_chunks.size());
+}
+
+int ChunkManager::peakResidentChunks() const
+{
+	return m_peakChunks;
+}
+
+int ChunkManager::maxResidentChunks() const
+{
+	return m_maxChunks;
+}
+
+int ChunkManager::loadedChunks() const
+{
+	return m_loadedChunks;
+}
+
+int ChunkManager::missingChunks(const SDL_Rect& camera) const
+{
+	int firstColumn, lastColumn, firstRow, lastRow;
+	if (!cellRange(camera, m_columns, m_rows, firstColumn, lastColumn, firstRow, lastRow))
+		return 0;
+
+	int missing = 0;
+	for (int chunkRow = firstRow / m_chunkSize; chunkRow <= lastRow / m_chunkSize; ++chunkRow) {
+		for (int chunkColumn = firstColumn / m_chunkSize; chunkColumn <= lastColumn / m_chunkSize; ++chunkColumn) {
+			if (findChunk(chunkColumn, chunkRow) == nullptr)
+				++missing;
+		}
+	}
+
+	return missing;
+}
+
+int ChunkManager::loaderThread(void* data)
+{
+	static_cast<ChunkManager*>(data)->loadChunks();
+	return 0;
+}
+
+void ChunkManager::loadChunks()
+{
+	SDL_LockMutex(m_lock);
+	while (!m_quit) {
+		/* Sleep until there is something to load */
+		if (m_requests.empty()) {
+			SDL_CondWait(m_wake, m_lock);
+			continue;
+		}
+
+		/* Take the nearest request */
+		Sint64 key = m_requests.front();
+		m_requests.pop_front();
+		m_loading = key;
+		SDL_UnlockMutex(m_lock);
+
+		/* Read without holding the lock */
+		std::vector<Uint8> tiles;
+		readChunk(key, tiles);
+
+		SDL_LockMutex(m_lock);
+		m_loaded.emplace_back(key, std::move(tiles));
+		m_loading = -1;
+		SDL_CondSignal(m_done);
+	}
+	SDL_UnlockMutex(m_lock);
+}
+
+void ChunkManager::readChunk(Sint64 key, std::vector<Uint8>& tiles)
+{
+	const int chunkColumn = static_cast<int>(key % m_chunkColumns);
+	const int chunkRow = static_cast<int>(key / m_chunkColumns);
+
+	/* Uniform chunks are filled without touching the file */
+	Uint8 fill = static_cast<Uint8>(Tiles::RED);
+	if (!m_chunkIndex.empty() && m_chunkIndex[static_cast<size_t>(key)].uniformType < TOTAL_TILE_SPRITES)
+		fill = m_chunkIndex[static_cast<size_t>(key)].uniformType;
+	tiles.assign(static_cast<size_t>(m_chunkSize) * m_chunkSize, fill);
+	if (!m_chunkIndex.empty() && m_chunkIndex[static_cast<size_t>(key)].uniformType != TILE_CHUNK_MIXED)
+		return;
+
+	/* Read the chunk row by row, parts outside of the map stay filled */
+	const int firstColumn = chunkColumn * m_chunkSize, firstRow = chunkRow * m_chunkSize;
+	const int columns = SDL_min(m_chunkSize, m_columns - firstColumn);
+	const int rows = SDL_min(m_chunkSize, m_rows - firstRow);
+	for (int row = 0; row < rows; ++row) {
+		Uint64 offset = m_header.tilesOffset + static_cast<Uint64>(firstRow + row) * m_columns + firstColumn;
+		Uint8* line = &tiles[static_cast<size_t>(row) * m_chunkSize];
+
+		if (SDL_RWseek(m_file, static_cast<Sint64>(offset), RW_SEEK_SET) < 0 ||
+			SDL_RWread(m_file, line, 1, columns) != static_cast<size_t>(columns)) {
+			printf("Error reading tile chunk %d, %d!\n", chunkColumn, chunkRow);
+			return;
+		}
+
+		/* Unknown tile types would index past the clips */
+		for (int column = 0; column < columns; ++column) {
+			if (line[column] >= TOTAL_TILE_SPRITES)
+				line[column] = fill;
+		}
+	}
+}
+
+void ChunkManager::collectLoaded()
+{
+	SDL_LockMutex(m_lock);
+	for (auto& chunk : m_loaded) {
+		/* Chunks over the budget are dropped, update requests them again if they are still needed */
+		if (static_cast<int>(m_chunks.size()) < m_maxChunks && m_chunks.find(chunk.first) == m_chunks.end()) {
+			m_chunks.emplace(chunk.first, std::move(chunk.second));
+			++m_loadedChunks;
+		}
+	}
+	m_loaded.clear();
+	SDL_UnlockMutex(m_lock);
+
+	m_peakChunks = SDL_max(m_peakChunks, static_cast<int>(m_chunks.size()));
+}
+
+const Uint8* ChunkManager::findChunk(int chunkColumn, int chunkRow) const
+{
+	auto chunk = m_chunks.find(static_cast<Sint64>(chunkRow) * m_chunkColumns + chunkColumn);
+	return (chunk != m_chunks.end()) ? chunk->second.data() : nullptr;
+}
+
+Sint64 ChunkManager::chunkDistance(Sint64 key, int x, int y) const
+{
+	const Sint64 chunkWidth = static_cast<Sint64>(m_chunkSize) * TILE_WIDTH;
+	const Sint64 chunkHeight = static_cast<Sint64>(m_chunkSize) * TILE_HEIGHT;
+
+	Sint64 dx = (key % m_chunkColumns) * chunkWidth + chunkWidth / 2 - x;
+	Sint64 dy = (key / m_chunkColumns) * chunkHeight + chunkHeight / 2 - y;
+	return dx * dx + dy * dy;
+}
\ No newline at end of file
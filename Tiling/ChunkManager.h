@@ -0,0 +1,113 @@
+#pragma once
+#include "SDL2/SDL.h"
+#include "SDL2/SDL_thread.h"
+
+#include "TileMap.h"
+#include "TileWorld.h"
+
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/* Streams chunks of a binary tile map around the camera through a loader thread */
+class ChunkManager : public TileWorld
+{
+public:
+	/* Chunk side used when neither caller nor map pick one */
+	static const int DEFAULT_CHUNK_SIZE = 32;
+
+public:
+	ChunkManager();
+	~ChunkManager();
+
+	/* Manager owns a thread, so it can't be copied */
+	ChunkManager(const ChunkManager&) = delete;
+	ChunkManager& operator=(const ChunkManager&) = delete;
+
+	/* Open binary map and start the loader, chunk size of 0 uses the one of map's chunk index */
+	bool open(const std::string& path, size_t memoryBudget, int chunkSize = 0, int prefetch = 1);
+
+	/* Stop the loader and release every chunk */
+	void close();
+
+	/* Take loaded chunks, request the ones around camera and evict distant ones */
+	void update(const SDL_Rect& camera);
+
+	/* Block until every requested chunk is loaded */
+	void waitForLoads();
+
+	/* Check collision box against the walls, chunks that aren't loaded yet block too */
+	bool touchesWall(const SDL_Rect& box) const override;
+
+	/* Show the loaded tiles inside the camera */
+	void render(const SDL_Rect& camera, LSpriteBatch* batch = nullptr) const override;
+
+	/* Get level dimensions in pixels */
+	int width() const override;
+	int height() const override;
+
+	/* Get chunk statistics */
+	int residentChunks() const;
+	int peakResidentChunks() const;
+	int maxResidentChunks() const;
+	/* Get amount of chunks loaded since open, evicted ones that came back included */
+	int loadedChunks() const;
+
+	/* Get amount of chunks inside camera that aren't resident, they show up as holes */
+	int missingChunks(const SDL_Rect& camera) const;
+
+private:
+	/* Loader thread entry */
+	static int loaderThread(void* data);
+
+	/* Load requested chunks until closed */
+	void loadChunks();
+
+	/* Read tiles of one chunk from the map file */
+	void readChunk(Sint64 key, std::vector<Uint8>& tiles);
+
+	/* Move chunks finished by the loader into resident ones */
+	void collectLoaded();
+
+	/* Get tiles of resident chunk, NULL if it isn't loaded */
+	const Uint8* findChunk(int chunkColumn, int chunkRow) const;
+
+	/* Get squared distance between chunk center and given point */
+	Sint64 chunkDistance(Sint64 key, int x, int y) const;
+
+private:
+	/* Map layout */
+	TileMapHeader m_header;
+	int m_columns, m_rows;
+
+	/* Chunk layout */
+	int m_chunkSize;
+	int m_chunkColumns, m_chunkRows;
+	int m_prefetch;
+	int m_maxChunks;
+
+	/* Chunk index of the map if it matches our chunk size */
+	std::vector<TileChunkInfo> m_chunkIndex;
+
+	/* Resident chunks, main thread only */
+	std::unordered_map<Sint64, std::vector<Uint8>> m_chunks;
+	int m_peakChunks;
+	int m_loadedChunks;
+
+	/* Loader thread */
+	SDL_Thread* m_thread;
+
+	/* State shared with the loader, guarded by the lock */
+	SDL_mutex* m_lock;
+	SDL_cond* m_wake;
+	SDL_cond* m_done;
+	std::deque<Sint64> m_requests;
+	std::vector<std::pair<Sint64, std::vector<Uint8>>> m_loaded;
+	Sint64 m_loading;
+	bool m_quit;
+
+	/* Map file, loader thread only */
+	SDL_RWops* m_file;
+};
\ No newline at end of file
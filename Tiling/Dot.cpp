@@ -67,13 +67,13 @@ void Dot::handleEvent(SDL_Event& event)
 	}
 }
 
-void Dot::move(Tile* tiles[])
+void Dot::move(const TileWorld& world)
 {
 	/* Move the dot left or right */
 	m_box.x += m_velX;
 
 	/* If the dot is too far to the left or right */
-	if ((m_box.x < 0) || (m_box.x + DOT_WIDTH > LEVEL_WIDTH) || touchesWall(m_box, tiles)) {
+	if ((m_box.x < 0) || (m_box.x + DOT_WIDTH > world.width()) || world.touchesWall(m_box)) {
 		/* Move back */
 		m_box.x -= m_velX;
 	}
@@ -82,13 +82,13 @@ void Dot::move(Tile* tiles[])
 	m_box.y += m_velY;
 
 	/* If the dot is too far up or down */
-	if ((m_box.y < 0) || (m_box.y + DOT_HEIGHT > LEVEL_HEIGHT) || touchesWall(m_box, tiles)) {
+	if ((m_box.y < 0) || (m_box.y + DOT_HEIGHT > world.height()) || world.touchesWall(m_box)) {
 		/* Move back */
 		m_box.y -= m_velY;
 	}
 }
 
-void Dot::setCamera(SDL_Rect& camera)
+void Dot::setCamera(SDL_Rect& camera, const TileWorld& world)
 {
 	/* Center camera over the dot */
 	camera.x = (m_box.x + DOT_WIDTH / 2) - SCREEN_WIDTH / 2;
@@ -99,10 +99,10 @@ void Dot::setCamera(SDL_Rect& camera)
 		camera.x = 0;
 	if (camera.y < 0)
 		camera.y = 0;
-	if (camera.x > LEVEL_WIDTH - camera.w)
-		camera.x = LEVEL_WIDTH - camera.w;
-	if (camera.y > LEVEL_HEIGHT - camera.h)
-		camera.y = LEVEL_HEIGHT - camera.h;
+	if (camera.x > world.width() - camera.w)
+		camera.x = world.width() - camera.w;
+	if (camera.y > world.height() - camera.h)
+		camera.y = world.height() - camera.h;
 }
 
 void Dot::render(const SDL_Rect& camera)
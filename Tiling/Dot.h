@@ -4,6 +4,7 @@
 #include "LTexture.h"
 #include "Particle.h"
 #include "Tile.h"
+#include "TileWorld.h"
 
 #include <vector>
 
@@ -35,10 +36,10 @@ public:
 	void handleEvent(SDL_Event& event);
 
 	/* Move and check collisions with tiles */
-	void move(Tile *tiles[]);
+	void move(const TileWorld& world);
 
-	/* Center camera over the dot */
-	void setCamera(SDL_Rect& camera);
+	/* Center camera over the dot, keeping it inside the world */
+	void setCamera(SDL_Rect& camera, const TileWorld& world);
 
 	/* Show the dot on screen */
 	void render(const SDL_Rect& camera);
@@ -20,6 +20,15 @@ void Tile::render(SDL_Rect& camera)
 	}
 }
 
+void Tile::render(SDL_Rect& camera, LSpriteBatch& batch)
+{
+	/* If tile is on screen */
+	if (checkCollision(camera, m_box)) {
+		/* Queue the tile */
+		batch.draw(m_box.x - camera.x, m_box.y - camera.y, &tileClips[static_cast<int>(m_type)]);
+	}
+}
+
 Tiles Tile::getType()
 {
 	return m_type;
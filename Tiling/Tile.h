@@ -3,6 +3,7 @@
 #include "SDL2/SDL_image.h"
 
 #include "LTexture.h"
+#include "LSpriteBatch.h"
 
 
 /* Tile constants */
@@ -41,6 +42,8 @@ public:
 
 	/* Show the tile */
 	void render(SDL_Rect& camera);
+	/* Queue the tile into batch of tile texture */
+	void render(SDL_Rect& camera, LSpriteBatch& batch);
 
 	/* Get tile type */
 	Tiles getType();
@@ -0,0 +1,186 @@
+#include "TileChunkCache.h"
+
+TileChunkCache::TileChunkCache() : m_map(nullptr), m_chunkSize(DEFAULT_CHUNK_SIZE), m_chunkColumns(0),
+	m_chunkRows(0), m_maxTextures(DEFAULT_MAX_TEXTURES), m_targetsUnsupported(false), m_frame(0), m_bakedChunks(0)
+{
+}
+
+TileChunkCache::~TileChunkCache()
+{
+	/* Deallocate */
+	free();
+}
+
+void TileChunkCache::setMap(TileMap* map, int chunkSize, int maxTextures)
+{
+	/* Textures of previous map are useless now */
+	free();
+
+	m_map = map;
+	m_chunkSize = SDL_max(chunkSize, 1);
+	m_maxTextures = SDL_max(maxTextures, 1);
+	m_chunkColumns = (map->columns() + m_chunkSize - 1) / m_chunkSize;
+	m_chunkRows = (map->rows() + m_chunkSize - 1) / m_chunkSize;
+}
+
+void TileChunkCache::free()
+{
+	for (auto& entry : m_chunks)
+		delete entry.second.texture;
+	m_chunks.clear();
+}
+
+void TileChunkCache::setType(int column, int row, Tiles type)
+{
+	m_map->setType(column, row, type);
+	invalidate(column, row);
+}
+
+void TileChunkCache::invalidate(int column, int row)
+{
+	/* Chunks that were never baked have nothing to invalidate */
+	auto chunk = m_chunks.find((row / m_chunkSize) * m_chunkColumns + column / m_chunkSize);
+	if (chunk != m_chunks.end())
+		chunk->second.dirty = true;
+}
+
+void TileChunkCache::invalidateAll()
+{
+	for (auto& entry : m_chunks)
+		entry.second.dirty = true;
+}
+
+bool TileChunkCache::touchesWall(const SDL_Rect& box) const
+{
+	return m_map->touchesWall(box);
+}
+
+void TileChunkCache::render(const SDL_Rect& camera, LSpriteBatch* batch) const
+{
+	++m_frame;
+
+	/* Visible chunks follow from the visible cells */
+	int firstColumn, lastColumn, firstRow, lastRow;
+	if (m_map == nullptr || !cellRange(camera, m_map->columns(), m_map->rows(), firstColumn, lastColumn,
+		firstRow, lastRow))
+		return;
+
+	/* Nothing to bake into, don't try again every frame */
+	if (m_targetsUnsupported) {
+		m_map->render(camera, batch);
+		return;
+	}
+
+	/* Every chunk of the view has to stay resident, so limit can't be lower */
+	int visibleChunks = (lastRow / m_chunkSize - firstRow / m_chunkSize + 1) *
+		(lastColumn / m_chunkSize - firstColumn / m_chunkSize + 1);
+	m_maxTextures = SDL_max(m_maxTextures, visibleChunks);
+
+	for (int chunkRow = firstRow / m_chunkSize; chunkRow <= lastRow / m_chunkSize; ++chunkRow) {
+		for (int chunkColumn = firstColumn / m_chunkSize; chunkColumn <= lastColumn / m_chunkSize; ++chunkColumn) {
+			int number = chunkRow * m_chunkColumns + chunkColumn;
+
+			/* Make room before a new chunk comes in */
+			if (m_chunks.find(number) == m_chunks.end()) {
+				if (static_cast<int>(m_chunks.size()) >= m_maxTextures)
+					evict();
+				m_chunks[number] = { nullptr, true, 0 };
+			}
+
+			/* Without render targets, show the tiles themselves */
+			ChunkTexture& chunk = m_chunks[number];
+			if (m_targetsUnsupported || (chunk.dirty && !bake(chunkColumn, chunkRow, chunk, batch))) {
+				m_targetsUnsupported = true;
+				renderTiles(chunkColumn, chunkRow, camera, batch);
+				continue;
+			}
+
+			chunk.lastShown = m_frame;
+			chunk.texture->render(chunkColumn * m_chunkSize * TILE_WIDTH - camera.x,
+				chunkRow * m_chunkSize * TILE_HEIGHT - camera.y);
+		}
+	}
+
+	/* Textures that can't be baked are of no use */
+	if (m_targetsUnsupported) {
+		for (auto& entry : m_chunks)
+			delete entry.second.texture;
+		m_chunks.clear();
+	}
+}
+
+bool TileChunkCache::bake(int chunkColumn, int chunkRow, ChunkTexture& chunk, LSpriteBatch* batch) const
+{
+	/* Chunks at the map edge may be cut off */
+	SDL_Rect area = { chunkColumn * m_chunkSize * TILE_WIDTH, chunkRow * m_chunkSize * TILE_HEIGHT,
+		SDL_min(m_chunkSize, m_map->columns() - chunkColumn * m_chunkSize) * TILE_WIDTH,
+		SDL_min(m_chunkSize, m_map->rows() - chunkRow * m_chunkSize) * TILE_HEIGHT };
+
+	/* Reuse texture of invalidated chunk */
+	if (chunk.texture == nullptr)
+		chunk.texture = new LTexture();
+	if (chunk.texture->width() != area.w || chunk.texture->height() != area.h) {
+		if (!chunk.texture->createBlank(area.w, area.h, SDL_TEXTUREACCESS_TARGET))
+			return false;
+		chunk.texture->setBlendMode(SDL_BLENDMODE_BLEND);
+	}
+
+	/* Render the tiles into the texture, the chunk area acting as camera */
+	SDL_Texture* previousTarget = SDL_GetRenderTarget(renderer);
+	chunk.texture->setAsRenderTarget();
+
+	SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+	SDL_RenderClear(renderer);
+	m_map->render(area, batch);
+
+	SDL_SetRenderTarget(renderer, previousTarget);
+
+	chunk.dirty = false;
+	++m_bakedChunks;
+	return true;
+}
+
+void TileChunkCache::renderTiles(int chunkColumn, int chunkRow, const SDL_Rect& camera, LSpriteBatch* batch) const
+{
+	/* Clip to the chunk, so chunks shown before it this frame aren't drawn over */
+	SDL_Rect clip = { chunkColumn * m_chunkSize * TILE_WIDTH - camera.x, chunkRow * m_chunkSize * TILE_HEIGHT - camera.y,
+		m_chunkSize * TILE_WIDTH, m_chunkSize * TILE_HEIGHT };
+	SDL_RenderSetClipRect(renderer, &clip);
+	m_map->render(camera, batch);
+	SDL_RenderSetClipRect(renderer, NULL);
+}
+
+void TileChunkCache::evict() const
+{
+	auto oldest = m_chunks.end();
+	for (auto chunk = m_chunks.begin(); chunk != m_chunks.end(); ++chunk) {
+		if (chunk->second.lastShown != m_frame && (oldest == m_chunks.end() ||
+			chunk->second.lastShown < oldest->second.lastShown))
+			oldest = chunk;
+	}
+
+	if (oldest != m_chunks.end()) {
+		delete oldest->second.texture;
+		m_chunks.erase(oldest);
+	}
+}
+
+int TileChunkCache::width() const
+{
+	return m_map->width();
+}
+
+int TileChunkCache::height() const
+{
+	return m_map->height();
+}
+
+int TileChunkCache::residentTextures() const
+{
+	return static_cast<int>(m_chunks.size());
+}
+
+int TileChunkCache::bakedChunks() const
+{
+	return m_bakedChunks;
+}
\ No newline at end of file
@@ -0,0 +1,87 @@
+#pragma once
+#include "SDL2/SDL.h"
+
+#include "LTexture.h"
+#include "TileMap.h"
+#include "TileWorld.h"
+
+#include <unordered_map>
+
+/* Shows a tile map through chunk textures the tiles are prerendered into, one copy per visible chunk */
+class TileChunkCache : public TileWorld
+{
+public:
+	/* Chunk side in tiles and amount of chunk textures kept by default */
+	static const int DEFAULT_CHUNK_SIZE = 8;
+	static const int DEFAULT_MAX_TEXTURES = 32;
+
+public:
+	TileChunkCache();
+	~TileChunkCache();
+
+	/* Cache owns textures, so it can't be copied */
+	TileChunkCache(const TileChunkCache&) = delete;
+	TileChunkCache& operator=(const TileChunkCache&) = delete;
+
+	/* Show given map from now on, chunks are baked when they first become visible.
+	Texture limit grows to the amount of chunks one view shows, those can't be evicted */
+	void setMap(TileMap* map, int chunkSize = DEFAULT_CHUNK_SIZE, int maxTextures = DEFAULT_MAX_TEXTURES);
+
+	/* Release every chunk texture */
+	void free();
+
+	/* Change type of tile and rebake its chunk */
+	void setType(int column, int row, Tiles type);
+
+	/* Rebake chunk holding given cell next time it's shown */
+	void invalidate(int column, int row);
+	/* Rebake every chunk, needed when render targets get reset */
+	void invalidateAll();
+
+	/* Check collision box against the walls of the map */
+	bool touchesWall(const SDL_Rect& box) const override;
+
+	/* Show chunks inside the camera, baking dirty ones through the batch if one is given */
+	void render(const SDL_Rect& camera, LSpriteBatch* batch = nullptr) const override;
+
+	/* Get level dimensions in pixels */
+	int width() const override;
+	int height() const override;
+
+	/* Get chunk statistics */
+	int residentTextures() const;
+	int bakedChunks() const;
+
+private:
+	/* Prerendered chunk */
+	struct ChunkTexture
+	{
+		LTexture* texture;
+		bool dirty;
+		Uint32 lastShown;
+	};
+
+	/* Render tiles of chunk into its texture */
+	bool bake(int chunkColumn, int chunkRow, ChunkTexture& chunk, LSpriteBatch* batch) const;
+
+	/* Show tiles of chunk straight from the map, for when it couldn't be baked */
+	void renderTiles(int chunkColumn, int chunkRow, const SDL_Rect& camera, LSpriteBatch* batch) const;
+
+	/* Free texture of the chunk shown longest ago, unless every chunk is shown this frame */
+	void evict() const;
+
+	TileMap* m_map;
+
+	/* Chunk layout */
+	int m_chunkSize;
+	int m_chunkColumns, m_chunkRows;
+	mutable int m_maxTextures;
+
+	/* Render targets failed once, tiles get shown straight from the map from then on */
+	mutable bool m_targetsUnsupported;
+
+	/* Baked chunks by chunk number, filled while rendering */
+	mutable std::unordered_map<int, ChunkTexture> m_chunks;
+	mutable Uint32 m_frame;
+	mutable int m_bakedChunks;
+};
\ No newline at end of file
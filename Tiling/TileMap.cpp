@@ -0,0 +1,394 @@
+#include "TileMap.h"
+
+#include <fstream>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/* Map whole file copy-on-write, so tiles can be edited without touching the file */
+static void* mapFile(const std::string& path, size_t& size)
+{
+	void* memory = nullptr;
+	size = 0;
+
+#if defined(_WIN32)
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+		return nullptr;
+
+	LARGE_INTEGER fileSize;
+	if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0) {
+		HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+		if (mapping != NULL) {
+			memory = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+			if (memory != nullptr)
+				size = static_cast<size_t>(fileSize.QuadPart);
+
+			/* The view keeps the mapping alive */
+			CloseHandle(mapping);
+		}
+	}
+	CloseHandle(file);
+#else
+	int file = open(path.c_str(), O_RDONLY);
+	if (file < 0)
+		return nullptr;
+
+	struct stat info;
+	if (fstat(file, &info) == 0 && info.st_size > 0) {
+		memory = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+		if (memory == MAP_FAILED)
+			memory = nullptr;
+		else
+			size = static_cast<size_t>(info.st_size);
+	}
+
+	/* The mapping stays valid after closing */
+	close(file);
+#endif
+
+	return memory;
+}
+
+/* Release file mapping */
+static void unmapFile(void* memory, size_t size)
+{
+#if defined(_WIN32)
+	(void)size;
+	UnmapViewOfFile(memory);
+#else
+	munmap(memory, size);
+#endif
+}
+
+TileMap::TileMap() : m_tiles(nullptr), m_columns(0), m_rows(0), m_mapping(nullptr), m_mappingSize(0),
+	m_chunkSize(0)
+{
+}
+
+TileMap::~TileMap()
+{
+	/* Deallocate */
+	free();
+}
+
+void TileMap::create(int columns, int rows, Tiles type)
+{
+	/* Destroy preexisting grid */
+	free();
+
+	if (columns < 0 || rows < 0)
+		columns = rows = 0;
+
+	m_columns = columns;
+	m_rows = rows;
+	m_storage.assign(static_cast<size_t>(columns) * rows, static_cast<Uint8>(type));
+	m_tiles = m_storage.data();
+}
+
+bool TileMap::loadFromText(const std::string& path, int columns, int rows)
+{
+	/* Open the map */
+	std::ifstream map(path);
+	if (map.fail()) {
+		printf("Couldn't open tile map %s!\n", path.c_str());
+		return false;
+	}
+
+	/* Allocate the grid */
+	create(columns, rows);
+
+	/* Initialize the tiles */
+	const int total = columns * rows;
+	for (int i = 0; i < total; ++i) {
+		/* Determines the type of tile */
+		int tileType = -1;
+		/* Read type from map file */
+		map >> tileType;
+
+		/* If there was a problem */
+		if (map.fail()) {
+			printf("Error loading map: Unexcepted end of file!\n");
+			free();
+			return false;
+		}
+
+		/* If we don't recognize tile type */
+		if ((tileType < 0) || (tileType >= TOTAL_TILE_SPRITES)) {
+			printf("Error loading map: Invalid tile type at %d!\n", i);
+			free();
+			return false;
+		}
+
+		m_tiles[i] = static_cast<Uint8>(tileType);
+	}
+
+	return true;
+}
+
+bool TileMap::loadFromBinary(const std::string& path)
+{
+	/* Destroy preexisting grid */
+	free();
+
+	size_t size = 0;
+	Uint8* file = static_cast<Uint8*>(mapFile(path, size));
+	if (file == nullptr) {
+		printf("Couldn't map tile map %s!\n", path.c_str());
+		return false;
+	}
+
+	/* Read header */
+	TileMapHeader header;
+	bool valid = readTileMapHeader(file, size, header);
+
+	/* Check that tiles and chunk index fit in the file */
+	Uint64 tileCount = 0, chunkCount = 0;
+	if (valid) {
+		tileCount = static_cast<Uint64>(header.columns) * header.rows;
+		valid = header.tilesOffset <= size && tileCount <= size - header.tilesOffset;
+	}
+	if (valid && header.chunkSize > 0) {
+		/* In 64 bits, so huge chunk sizes can't wrap the count around to nothing */
+		const Uint64 chunkSize = header.chunkSize;
+		chunkCount = ((header.columns + chunkSize - 1) / chunkSize) * ((header.rows + chunkSize - 1) / chunkSize);
+		valid = header.chunkIndexOffset <= size &&
+			chunkCount * sizeof(TileChunkInfo) <= size - header.chunkIndexOffset;
+	}
+
+	/* Reject unknown tile types, they would index past the clips */
+	const Uint8* tiles = file + (valid ? header.tilesOffset : 0);
+	for (Uint64 i = 0; valid && i < tileCount; ++i) {
+		if (tiles[i] >= TOTAL_TILE_SPRITES) {
+			printf("Error loading map: Invalid tile type at %llu!\n", static_cast<unsigned long long>(i));
+			valid = false;
+		}
+	}
+
+	if (!valid) {
+		printf("Invalid tile map %s!\n", path.c_str());
+		unmapFile(file, size);
+		return false;
+	}
+
+	/* Tiles stay in the mapping */
+	m_mapping = file;
+	m_mappingSize = size;
+	m_tiles = file + header.tilesOffset;
+	m_columns = static_cast<int>(header.columns);
+	m_rows = static_cast<int>(header.rows);
+
+	/* Copy chunk index out of the file */
+	m_chunkSize = static_cast<int>(header.chunkSize);
+	m_chunkIndex.resize(static_cast<size_t>(chunkCount));
+	if (chunkCount > 0)
+		SDL_memcpy(m_chunkIndex.data(), file + header.chunkIndexOffset, chunkCount * sizeof(TileChunkInfo));
+	for (TileChunkInfo& chunk : m_chunkIndex)
+		chunk.wallTiles = SDL_SwapLE32(chunk.wallTiles);
+
+	return true;
+}
+
+bool TileMap::saveBinary(const std::string& path, int chunkSize) const
+{
+	/* Chunk bigger than the map covers the same as one of its size, and loading rejects bigger ones */
+	chunkSize = SDL_min(SDL_max(chunkSize, 0), SDL_max(m_columns, m_rows));
+
+	/* Build chunk index */
+	std::vector<TileChunkInfo> chunks;
+	if (chunkSize > 0) {
+		const int chunkColumns = (m_columns + chunkSize - 1) / chunkSize;
+		const int chunkRows = (m_rows + chunkSize - 1) / chunkSize;
+		chunks.resize(static_cast<size_t>(chunkColumns) * chunkRows);
+
+		for (int chunkRow = 0; chunkRow < chunkRows; ++chunkRow) {
+			for (int chunkColumn = 0; chunkColumn < chunkColumns; ++chunkColumn) {
+				TileChunkInfo& chunk = chunks[static_cast<size_t>(chunkRow) * chunkColumns + chunkColumn];
+				SDL_zero(chunk);
+
+				const int firstColumn = chunkColumn * chunkSize, firstRow = chunkRow * chunkSize;
+				const int lastColumn = SDL_min(firstColumn + chunkSize, m_columns);
+				const int lastRow = SDL_min(firstRow + chunkSize, m_rows);
+
+				Uint8 type = m_tiles[static_cast<size_t>(firstRow) * m_columns + firstColumn];
+				chunk.uniformType = type;
+				for (int row = firstRow; row < lastRow; ++row) {
+					for (int column = firstColumn; column < lastColumn; ++column) {
+						Uint8 tile = m_tiles[static_cast<size_t>(row) * m_columns + column];
+						if (isWall(static_cast<Tiles>(tile)))
+							++chunk.wallTiles;
+						if (tile != type)
+							chunk.uniformType = TILE_CHUNK_MIXED;
+					}
+				}
+				chunk.wallTiles = SDL_SwapLE32(chunk.wallTiles);
+			}
+		}
+	}
+
+	/* Header, then chunk index, then tiles */
+	TileMapHeader header;
+	SDL_zero(header);
+	SDL_memcpy(header.magic, "TMAP", 4);
+	header.version = SDL_SwapLE32(TILE_MAP_VERSION);
+	header.columns = SDL_SwapLE32(static_cast<Uint32>(m_columns));
+	header.rows = SDL_SwapLE32(static_cast<Uint32>(m_rows));
+	header.chunkSize = SDL_SwapLE32(static_cast<Uint32>(chunkSize));
+	header.chunkIndexOffset = SDL_SwapLE64(chunks.empty() ? 0 : sizeof(header));
+	header.tilesOffset = SDL_SwapLE64(sizeof(header) + chunks.size() * sizeof(TileChunkInfo));
+
+	std::ofstream file(path, std::ios::binary);
+	if (file.fail()) {
+		printf("Couldn't create tile map %s!\n", path.c_str());
+		return false;
+	}
+
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	if (!chunks.empty())
+		file.write(reinterpret_cast<const char*>(chunks.data()), chunks.size() * sizeof(TileChunkInfo));
+	if (m_tiles != nullptr)
+		file.write(reinterpret_cast<const char*>(m_tiles), static_cast<size_t>(m_columns) * m_rows);
+
+	return !file.fail();
+}
+
+void TileMap::free()
+{
+	/* Release mapped file */
+	if (m_mapping != nullptr) {
+		unmapFile(m_mapping, m_mappingSize);
+		m_mapping = nullptr;
+		m_mappingSize = 0;
+	}
+
+	/* Release owned tiles */
+	m_storage.clear();
+	m_storage.shrink_to_fit();
+	m_chunkIndex.clear();
+
+	m_tiles = nullptr;
+	m_columns = 0;
+	m_rows = 0;
+	m_chunkSize = 0;
+}
+
+void TileMap::setType(int column, int row, Tiles type)
+{
+	m_tiles[static_cast<size_t>(row) * m_columns + column] = static_cast<Uint8>(type);
+}
+
+Tiles TileMap::getType(int column, int row) const
+{
+	return static_cast<Tiles>(m_tiles[static_cast<size_t>(row) * m_columns + column]);
+}
+
+bool TileMap::touchesWall(const SDL_Rect& box) const
+{
+	int firstColumn, lastColumn, firstRow, lastRow;
+	if (!cellRange(box, m_columns, m_rows, firstColumn, lastColumn, firstRow, lastRow))
+		return false;
+
+	/* Only check the overlapped tiles */
+	for (int row = firstRow; row <= lastRow; ++row) {
+		const Uint8* tile = &m_tiles[static_cast<size_t>(row) * m_columns];
+		for (int column = firstColumn; column <= lastColumn; ++column) {
+			if (isWall(static_cast<Tiles>(tile[column])))
+				return true;
+		}
+	}
+
+	/* No wall tiles were touched */
+	return false;
+}
+
+void TileMap::render(const SDL_Rect& camera, LSpriteBatch* batch) const
+{
+	/* Visible cells follow directly from the camera */
+	int firstColumn, lastColumn, firstRow, lastRow;
+	if (!cellRange(camera, m_columns, m_rows, firstColumn, lastColumn, firstRow, lastRow))
+		return;
+
+	if (batch != nullptr)
+		batch->begin(tileTexture);
+
+	for (int row = firstRow; row <= lastRow; ++row) {
+		const Uint8* tile = &m_tiles[static_cast<size_t>(row) * m_columns];
+		int y = row * TILE_HEIGHT - camera.y;
+
+		for (int column = firstColumn; column <= lastColumn; ++column) {
+			int x = column * TILE_WIDTH - camera.x;
+
+			/* Show the tile */
+			if (batch != nullptr)
+				batch->draw(x, y, &tileClips[tile[column]]);
+			else
+				tileTexture.render(x, y, &tileClips[tile[column]]);
+		}
+	}
+
+	if (batch != nullptr)
+		batch->flush();
+}
+
+int TileMap::columns() const
+{
+	return m_columns;
+}
+
+int TileMap::rows() const
+{
+	return m_rows;
+}
+
+int TileMap::width() const
+{
+	return m_columns * TILE_WIDTH;
+}
+
+int TileMap::height() const
+{
+	return m_rows * TILE_HEIGHT;
+}
+
+const std::vector<TileChunkInfo>& TileMap::getChunkIndex() const
+{
+	return m_chunkIndex;
+}
+
+int TileMap::chunkSize() const
+{
+	return m_chunkSize;
+}
+
+
+bool isWall(Tiles type)
+{
+	return (type >= Tiles::CENTER) && (type <= Tiles::TOPLEFT);
+}
+
+bool readTileMapHeader(const void* data, size_t size, TileMapHeader& header)
+{
+	if (size < sizeof(header))
+		return false;
+
+	SDL_memcpy(&header, data, sizeof(header));
+	header.version = SDL_SwapLE32(header.version);
+	header.columns = SDL_SwapLE32(header.columns);
+	header.rows = SDL_SwapLE32(header.rows);
+	header.chunkSize = SDL_SwapLE32(header.chunkSize);
+	header.chunkIndexOffset = SDL_SwapLE64(header.chunkIndexOffset);
+	header.tilesOffset = SDL_SwapLE64(header.tilesOffset);
+
+	/* Map has to fit in int pixels, and chunks in the map */
+	return SDL_memcmp(header.magic, "TMAP", 4) == 0 && header.version == TILE_MAP_VERSION &&
+		header.columns <= static_cast<Uint32>(SDL_MAX_SINT32 / TILE_WIDTH) &&
+		header.rows <= static_cast<Uint32>(SDL_MAX_SINT32 / TILE_HEIGHT) &&
+		header.chunkSize <= SDL_max(header.columns, header.rows);
+}
\ No newline at end of file
@@ -0,0 +1,118 @@
+#pragma once
+#include "SDL2/SDL.h"
+
+#include "Tile.h"
+#include "LSpriteBatch.h"
+#include "TileWorld.h"
+
+#include <string>
+#include <vector>
+
+/* Header of binary tile map file, all fields little endian */
+struct TileMapHeader
+{
+	/* Always "TMAP" */
+	char magic[4];
+	Uint32 version;
+
+	/* Grid dimensions in tiles */
+	Uint32 columns, rows;
+
+	/* Side of a chunk in tiles, 0 if there is no chunk index */
+	Uint32 chunkSize;
+	Uint32 reserved;
+
+	/* Byte offsets of the chunk index and the Uint8 tile array */
+	Uint64 chunkIndexOffset;
+	Uint64 tilesOffset;
+};
+
+/* Chunk index entry, chunks are stored row by row */
+struct TileChunkInfo
+{
+	/* Amount of wall tiles in the chunk */
+	Uint32 wallTiles;
+
+	/* Type of every tile if they are all the same, otherwise TILE_CHUNK_MIXED */
+	Uint8 uniformType;
+	Uint8 reserved[3];
+};
+
+/* Binary map format constants */
+const Uint32 TILE_MAP_VERSION = 1;
+const Uint8 TILE_CHUNK_MIXED = 0xFF;
+
+/* Level tiles stored in a uniform grid, indexed by tile column and row */
+class TileMap : public TileWorld
+{
+public:
+	TileMap();
+	~TileMap();
+
+	/* Map may point into a file mapping, so it can't be copied */
+	TileMap(const TileMap&) = delete;
+	TileMap& operator=(const TileMap&) = delete;
+
+	/* Allocate grid of given size in tiles, every tile gets given type */
+	void create(int columns, int rows, Tiles type = Tiles::RED);
+
+	/* Parse text map of whitespace separated tile types */
+	bool loadFromText(const std::string& path, int columns, int rows);
+
+	/* Map binary map file straight into memory */
+	bool loadFromBinary(const std::string& path);
+
+	/* Write binary map, with chunk index if chunk size isn't 0 */
+	bool saveBinary(const std::string& path, int chunkSize = 0) const;
+
+	/* Deallocate the grid */
+	void free();
+
+	/* Set type of tile at given cell */
+	void setType(int column, int row, Tiles type);
+	/* Get type of tile at given cell */
+	Tiles getType(int column, int row) const;
+
+	/* Check collision box against the tiles it overlaps */
+	bool touchesWall(const SDL_Rect& box) const override;
+
+	/* Show the tiles inside the camera, through the batch if one is given */
+	void render(const SDL_Rect& camera, LSpriteBatch* batch = nullptr) const override;
+
+	/* Get grid dimensions in tiles */
+	int columns() const;
+	int rows() const;
+
+	/* Get level dimensions in pixels */
+	int width() const override;
+	int height() const override;
+
+	/* Get chunk index of loaded binary map, empty if there is none */
+	const std::vector<TileChunkInfo>& getChunkIndex() const;
+	/* Get side of indexed chunks in tiles */
+	int chunkSize() const;
+
+private:
+	/* Tile types, row by row, points either into storage or into file mapping */
+	Uint8* m_tiles;
+
+	/* Grid dimensions */
+	int m_columns, m_rows;
+
+	/* Tiles owned by the map */
+	std::vector<Uint8> m_storage;
+
+	/* Memory mapped binary map */
+	void* m_mapping;
+	size_t m_mappingSize;
+
+	/* Chunk index of binary map */
+	std::vector<TileChunkInfo> m_chunkIndex;
+	int m_chunkSize;
+};
+
+/* Check if tile type is a wall */
+bool isWall(Tiles type);
+
+/* Read and check binary map header from start of the file */
+bool readTileMapHeader(const void* data, size_t size, TileMapHeader& header);
\ No newline at end of file
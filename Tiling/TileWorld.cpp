@@ -0,0 +1,30 @@
+#include "TileWorld.h"
+#include "Tile.h"
+
+/* Divide rounding towards negative infinity */
+static int floorDiv(int a, int b)
+{
+	return (a >= 0) ? a / b : -((-a + b - 1) / b);
+}
+
+bool TileWorld::cellRange(const SDL_Rect& box, int columns, int rows, int& firstColumn, int& lastColumn,
+	int& firstRow, int& lastRow)
+{
+	/* Range of cells overlapped by the box, edges that only touch don't count */
+	firstColumn = floorDiv(box.x, TILE_WIDTH);
+	lastColumn = floorDiv(box.x + box.w - 1, TILE_WIDTH);
+	firstRow = floorDiv(box.y, TILE_HEIGHT);
+	lastRow = floorDiv(box.y + box.h - 1, TILE_HEIGHT);
+
+	/* Outside of the grid there are no tiles */
+	if (firstColumn < 0)
+		firstColumn = 0;
+	if (firstRow < 0)
+		firstRow = 0;
+	if (lastColumn >= columns)
+		lastColumn = columns - 1;
+	if (lastRow >= rows)
+		lastRow = rows - 1;
+
+	return (firstColumn <= lastColumn) && (firstRow <= lastRow);
+}
\ No newline at end of file
@@ -0,0 +1,26 @@
+#pragma once
+#include "SDL2/SDL.h"
+
+#include "LSpriteBatch.h"
+
+/* Level made of tiles that the dot moves through */
+class TileWorld
+{
+public:
+	virtual ~TileWorld() {}
+
+	/* Check collision box against the wall tiles */
+	virtual bool touchesWall(const SDL_Rect& box) const = 0;
+
+	/* Show the tiles inside the camera, through the batch if one is given */
+	virtual void render(const SDL_Rect& camera, LSpriteBatch* batch = nullptr) const = 0;
+
+	/* Get level dimensions in pixels */
+	virtual int width() const = 0;
+	virtual int height() const = 0;
+
+protected:
+	/* Get range of tile cells overlapped by the box, clamped to grid of given size */
+	static bool cellRange(const SDL_Rect& box, int columns, int rows, int& firstColumn, int& lastColumn,
+		int& firstRow, int& lastRow);
+};
\ No newline at end of file
@@ -3,21 +3,35 @@
 
 #include "LTexture.h"
 #include "Dot.h"
+#include "LSpriteBatch.h"
+#include "TileMap.h"
+#include "ChunkManager.h"
+#include "TileChunkCache.h"
 
 #include <stdio.h>
 #include <string>
 #include <fstream>
+#include <vector>
 
 
 /* Initialize the program */
 bool init();
 /* Load all the needed media */
-bool loadMedia(Tile* tiles[]);
+bool loadMedia(TileMap& map);
 /* Clean up */
-void close(Tile* tiles[]);
+void close();
 
-/* Set tiles from tile map */
-bool setTiles(Tile* tiles[]);
+/* Set clips of tile sprites */
+void setTileClips();
+
+/* Convert text tile map into binary one */
+int convertMap(int argc, char* args[]);
+
+/* Render tile set by testing every tile against the camera */
+void renderTiles(Tile* tiles[], SDL_Rect& camera, LSpriteBatch* batch);
+
+/* Measure map loading, streaming, tile rendering, prerendering and collision cost, false if a check fails */
+bool runBenchmark(const TileMap& map);
 
 
 /* Screen dimensions */
@@ -28,6 +42,9 @@ const int SCREEN_HEIGHT = 480;
 const int LEVEL_WIDTH = 1280;
 const int LEVEL_HEIGHT = 960;
 
+/* Memory for resident chunks of streamed maps */
+const size_t STREAM_MEMORY_BUDGET = 1024 * 1024;
+
 /* Global window and renderer */
 SDL_Window* window = nullptr;
 SDL_Renderer* renderer = nullptr;
@@ -45,23 +62,57 @@ SDL_Rect tileClips[TOTAL_TILE_SPRITES];
 
 int main(int argc, char* args[])
 {
-	/* The level tiles */
-	Tile* tileSet[TOTAL_TILES];
+	/* Level tiles */
+	TileMap tileMap;
+	/* Streamed map chunks */
+	ChunkManager chunks;
+	/* Level prerendered into chunk textures */
+	TileChunkCache prerendered;
+
+	/* Convert map and quit */
+	if ((argc > 1) && (std::string(args[1]) == "--convert"))
+		return convertMap(argc, args);
+
+	/* Run headless benchmark instead of the demo */
+	bool benchmark = (argc > 1) && (std::string(args[1]) == "--bench");
+	if (benchmark) {
+		SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+		SDL_SetHint(SDL_HINT_RENDER_DRIVER, "software");
+		SDL_SetHint(SDL_HINT_RENDER_VSYNC, "0");
+	}
 
 	/* Initialize */
 	if (!init()) {
 		printf("Failed to initialize!\n");
-		close(tileSet);
+		close();
 		return -1;
 	}
 
 	/* Load media */
-	if (!loadMedia(tileSet)) {
+	if (!loadMedia(tileMap)) {
 		printf("Failed to load media!\n");
-		close(tileSet);
+		close();
 		return -1;
 	}
 
+	if (benchmark) {
+		bool passed = runBenchmark(tileMap);
+		close();
+		return passed ? 0 : -1;
+	}
+
+	/* Play the prerendered level or stream the given map */
+	prerendered.setMap(&tileMap);
+	TileWorld* world = &prerendered;
+	if ((argc > 2) && (std::string(args[1]) == "--stream")) {
+		if (!chunks.open(args[2], STREAM_MEMORY_BUDGET)) {
+			printf("Failed to open streamed map!\n");
+			close();
+			return -1;
+		}
+		world = &chunks;
+	}
+
 
 	bool quit = false;
 	SDL_Event e;
@@ -71,26 +122,63 @@ int main(int argc, char* args[])
 	/* Camera that follows dot */
 	SDL_Rect camera = { 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT };
 
+	/* Batch for tiles, toggled with B key */
+	LSpriteBatch batch;
+	bool useBatch = false;
+	/* Chunk textures, toggled with P key */
+	bool usePrerender = true;
+
+	/* Wait for the chunks around the start */
+	chunks.update(camera);
+	chunks.waitForLoads();
+
 	while (!quit) {
 		while (SDL_PollEvent(&e)) {
 			if (e.type == SDL_QUIT)
 				quit = true;
 
+			/* Toggle batched tile rendering */
+			if (e.type == SDL_KEYDOWN && e.key.repeat == 0 && e.key.keysym.sym == SDLK_b)
+				useBatch = !useBatch;
+
+			/* Toggle prerendered chunks */
+			if (e.type == SDL_KEYDOWN && e.key.repeat == 0 && e.key.keysym.sym == SDLK_p)
+				usePrerender = !usePrerender;
+
+			/* Cycle type of clicked level tile, only its chunk gets rebaked */
+			if (e.type == SDL_MOUSEBUTTONDOWN && world == &prerendered) {
+				int column = (e.button.x + camera.x) / TILE_WIDTH;
+				int row = (e.button.y + camera.y) / TILE_HEIGHT;
+				if (column < tileMap.columns() && row < tileMap.rows()) {
+					int type = (static_cast<int>(tileMap.getType(column, row)) + 1) % TOTAL_TILE_SPRITES;
+					prerendered.setType(column, row, static_cast<Tiles>(type));
+				}
+			}
+
+			/* Chunk textures are lost with the render targets */
+			if (e.type == SDL_RENDER_TARGETS_RESET)
+				prerendered.invalidateAll();
+
 			/* Handle dot events */
 			dot.handleEvent(e);
 		}
 
+		/* Stream chunks around the camera */
+		chunks.update(camera);
+
 		/* Move the dot */
-		dot.move(tileSet);
-		dot.setCamera(camera);
+		dot.move(*world);
+		dot.setCamera(camera, *world);
 
 		/* Clear screen */
 		SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
 		SDL_RenderClear(renderer);
 
 		/* Render level */
-		for (int i = 0; i < TOTAL_TILES; ++i)
-			tileSet[i]->render(camera);
+		if (world == &prerendered && !usePrerender)
+			tileMap.render(camera, useBatch ? &batch : nullptr);
+		else
+			world->render(camera, useBatch ? &batch : nullptr);
 
 		/* Render objects */
 		dot.render(camera);
@@ -100,7 +188,9 @@ int main(int argc, char* args[])
 	}
 
 	/* Clean up */
-	close(tileSet);
+	chunks.close();
+	prerendered.free();
+	close();
 	return 0;
 }
 
@@ -145,7 +235,7 @@ bool init()
 	return success;
 }
 
-bool loadMedia(Tile* tiles[])
+bool loadMedia(TileMap& map)
 {
 	bool success = true;
 
@@ -178,16 +268,18 @@ bool loadMedia(Tile* tiles[])
 		success = false;
 	}
 
-	/* Load tile map */
-	if (!setTiles(tiles)) {
+	/* Load tile map, binary if it's there */
+	if (!map.loadFromBinary("Images/lazy.tmap") &&
+		!map.loadFromText("Images/lazy.map", LEVEL_WIDTH / TILE_WIDTH, LEVEL_HEIGHT / TILE_HEIGHT)) {
 		printf("Couldn't set the tiles!\n");
 		success = false;
 	}
+	setTileClips();
 
 	return success;
 }
 
-void close(Tile* tiles[])
+void close()
 {
 	/* Free particle textures */
 	redTexture.free();
@@ -198,12 +290,6 @@ void close(Tile* tiles[])
 	/* Free tile texture */
 	tileTexture.free();
 
-	/* Free tiles */
-	for (int i = 0; i < TOTAL_TILES; ++i) {
-		delete tiles[i];
-		tiles[i] = nullptr;
-	}
-
 	/* Destroy windows */
 	if (window) {
 		SDL_DestroyWindow(window);
@@ -221,90 +307,527 @@ void close(Tile* tiles[])
 	SDL_Quit();
 }
 
-bool setTiles(Tile* tiles[])
+void setTileClips()
+{
+	tileClips[static_cast<int>(Tiles::RED)] = { 0, 0, TILE_WIDTH, TILE_HEIGHT };
+
+	tileClips[static_cast<int>(Tiles::GREEN)] = { 0, 80, TILE_WIDTH, TILE_HEIGHT };
+
+	tileClips[static_cast<int>(Tiles::BLUE)] = { 0, 160, TILE_WIDTH, TILE_HEIGHT };
+
+	tileClips[static_cast<int>(Tiles::TOPLEFT)] = { 80, 0, TILE_WIDTH, TILE_HEIGHT };
+
+	tileClips[static_cast<int>(Tiles::LEFT)] = { 80, 80, TILE_WIDTH, TILE_HEIGHT };
+
+	tileClips[static_cast<int>(Tiles::BOTTOMLEFT)] = { 80, 160, TILE_WIDTH, TILE_HEIGHT };
+
+	tileClips[static_cast<int>(Tiles::TOP)] = { 160, 0, TILE_WIDTH, TILE_HEIGHT };
+
+	tileClips[static_cast<int>(Tiles::CENTER)] = { 160, 80, TILE_WIDTH, TILE_HEIGHT };
+
+	tileClips[static_cast<int>(Tiles::BOTTOM)] = { 160, 160, TILE_WIDTH, TILE_HEIGHT };
+
+	tileClips[static_cast<int>(Tiles::TOPRIGHT)] = { 240, 0, TILE_WIDTH, TILE_HEIGHT };
+
+	tileClips[static_cast<int>(Tiles::RIGHT)] = { 240, 80, TILE_WIDTH, TILE_HEIGHT };
+
+	tileClips[static_cast<int>(Tiles::BOTTOMRIGHT)] = { 240, 160, TILE_WIDTH, TILE_HEIGHT };
+}
+
+int convertMap(int argc, char* args[])
 {
-	/* Success flag */
-	bool tilesLoaded = true;
+	if (argc < 4) {
+		printf("Usage: %s --convert <text map> <binary map> [columns rows] [chunk size]\n", args[0]);
+		return -1;
+	}
+
+	/* Level dimensions by default */
+	int columns = (argc > 5) ? SDL_atoi(args[4]) : LEVEL_WIDTH / TILE_WIDTH;
+	int rows = (argc > 5) ? SDL_atoi(args[5]) : LEVEL_HEIGHT / TILE_HEIGHT;
+	int chunkSize = (argc > 6) ? SDL_atoi(args[6]) : 0;
 
-	/* Tile offsets */
-	int x = 0, y = 0;
+	TileMap map;
+	if (!map.loadFromText(args[2], columns, rows) || !map.saveBinary(args[3], chunkSize)) {
+		printf("Failed to convert map!\n");
+		return -1;
+	}
 
-	/* Open the map */
-	std::ifstream map("Images/lazy.map");
+	printf("Converted %s (%dx%d tiles) to %s\n", args[2], columns, rows, args[3]);
+	return 0;
+}
 
-	if (map.fail()) {
-		printf("Couldn't open tile map!\n");
-		tilesLoaded = false;
+void renderTiles(Tile* tiles[], SDL_Rect& camera, LSpriteBatch* batch)
+{
+	/* One copy per tile */
+	if (batch == nullptr) {
+		for (int i = 0; i < TOTAL_TILES; ++i)
+			tiles[i]->render(camera);
+		return;
 	}
-	else {
-		/* Initialize the tiles */
-		for (int i = 0; i < TOTAL_TILES; ++i) {
-			/* Determines the type of tile */
-			int tileType = -1;
-			/* Read type from map file */
-			map >> tileType;
-
-			/* If there was a problem */
-			if (map.fail()) {
-				/* Stop loading map */
-				printf("Error loading map: Unexcepted end of file!\n");
-				tilesLoaded = false;
-				break;
+
+	/* Every tile shares one texture, so submit them at once */
+	batch->begin(tileTexture);
+	for (int i = 0; i < TOTAL_TILES; ++i)
+		tiles[i]->render(camera, *batch);
+	batch->flush();
+}
+
+/* Reference scan over every tile of the grid, like touchesWall does over the tile set */
+static bool touchesWallLinear(const SDL_Rect& box, const TileMap& map)
+{
+	for (int row = 0; row < map.rows(); ++row) {
+		for (int column = 0; column < map.columns(); ++column) {
+			SDL_Rect tileBox = { column * TILE_WIDTH, row * TILE_HEIGHT, TILE_WIDTH, TILE_HEIGHT };
+			if (isWall(map.getType(column, row)) && checkCollision(box, tileBox))
+				return true;
+		}
+	}
+
+	return false;
+}
+
+/* Reference render of the grid, testing every tile against the camera like Tile::render */
+static void renderTilesLinear(const SDL_Rect& camera, const TileMap& map)
+{
+	for (int row = 0; row < map.rows(); ++row) {
+		for (int column = 0; column < map.columns(); ++column) {
+			SDL_Rect tileBox = { column * TILE_WIDTH, row * TILE_HEIGHT, TILE_WIDTH, TILE_HEIGHT };
+			if (checkCollision(camera, tileBox))
+				tileTexture.render(tileBox.x - camera.x, tileBox.y - camera.y,
+					&tileClips[static_cast<int>(map.getType(column, row))]);
+		}
+	}
+}
+
+/* Fill map of given size with random tiles */
+static void createRandomMap(TileMap& map, int size)
+{
+	map.create(size, size);
+	for (int row = 0; row < size; ++row) {
+		for (int column = 0; column < size; ++column)
+			map.setType(column, row, static_cast<Tiles>(rand() % TOTAL_TILE_SPRITES));
+	}
+}
+
+/* Check grid queries against the linear scan and measure them on growing maps */
+static bool benchmarkCollision(Tile* tiles[], const TileMap& map)
+{
+	const double frequency = static_cast<double>(SDL_GetPerformanceFrequency());
+
+	/* Compare grid queries against the linear scan over the level */
+	int checked = 0, mismatches = 0;
+	for (int size = 1; size <= 100; size += 33) {
+		for (int y = -TILE_HEIGHT; y < LEVEL_HEIGHT + TILE_HEIGHT; y += 7) {
+			for (int x = -TILE_WIDTH; x < LEVEL_WIDTH + TILE_WIDTH; x += 7) {
+				SDL_Rect box = { x, y, size, size };
+				if (map.touchesWall(box) != touchesWall(box, tiles))
+					++mismatches;
+				++checked;
+			}
+		}
+	}
+	printf("touchesWall: %d boxes checked, %d mismatches against linear scan\n", checked, mismatches);
+
+	/* Query cost for growing maps */
+	const int sizes[] = { 16, 256, 2048 };
+	for (int size : sizes) {
+		TileMap bigMap;
+		createRandomMap(bigMap, size);
+
+		/* Fewer linear queries for big maps so they finish in reasonable time */
+		const int gridQueries = 1000000;
+		const int linearQueries = SDL_max(10, 20000000 / (size * size));
+
+		double ns[2];
+		int hits = 0;
+		for (int linear = 0; linear < 2; ++linear) {
+			const int queries = linear ? linearQueries : gridQueries;
+			srand(size);
+
+			Uint64 start = SDL_GetPerformanceCounter();
+			for (int i = 0; i < queries; ++i) {
+				SDL_Rect box = { (rand() % size) * TILE_WIDTH + rand() % TILE_WIDTH,
+					(rand() % size) * TILE_HEIGHT + rand() % TILE_HEIGHT, Dot::DOT_WIDTH, Dot::DOT_HEIGHT };
+				hits += linear ? touchesWallLinear(box, bigMap) : bigMap.touchesWall(box);
 			}
+			ns[linear] = (SDL_GetPerformanceCounter() - start) * 1000000000.0 / frequency / queries;
+		}
 
-			/* If type is valid */
-			if ((tileType >= 0) && (tileType < TOTAL_TILE_SPRITES))
-				tiles[i] = new Tile(x, y, static_cast<Tiles>(tileType));
-			/* If we don't recognize tile type */
-			else {
-				/* Stop loading map */
-				printf("Error loading map: Invalid tile type at %d!\n", i);
-				tilesLoaded = false;
-				break;
+		printf("%4dx%-4d tiles: %10.1f ns/query grid, %12.1f ns/query linear (%d hits)\n", size, size,
+			ns[0], ns[1], hits);
+	}
+
+	return mismatches == 0;
+}
+
+/* Measure tile rendering of the level and of a 4096x4096 tile map */
+static void benchmarkRendering(Tile* tiles[], const TileMap& map)
+{
+	/* Frames rendered per path */
+	const int FRAMES = 500;
+	const int BIG_MAP_FRAMES = 5;
+	const int BIG_MAP_SIZE = 4096;
+
+	const double frequency = static_cast<double>(SDL_GetPerformanceFrequency());
+
+	TileMap bigMap;
+	createRandomMap(bigMap, BIG_MAP_SIZE);
+
+	/* Tile set tested per tile, then the culled grid, each without and with batching */
+	const char* names[] = { "level per-tile test", "level culled", "4096x4096 per-tile test", "4096x4096 culled" };
+	LSpriteBatch batch;
+	for (int path = 0; path < 4; ++path) {
+		const bool big = path >= 2;
+		const bool culled = path % 2 == 1;
+		const TileMap& level = big ? bigMap : map;
+		const int frames = big ? BIG_MAP_FRAMES : FRAMES;
+
+		for (int batched = 0; batched < 2; ++batched) {
+			/* The big map only has the grid to test against */
+			if (big && !culled && batched)
+				continue;
+
+			SDL_Rect camera = { 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT };
+
+			LTexture::drawCalls = 0;
+			Uint64 start = SDL_GetPerformanceCounter();
+			for (int frame = 0; frame < frames; ++frame) {
+				/* Sweep the camera diagonally through the level */
+				camera.x = (frame * 3) % (level.width() - camera.w);
+				camera.y = (frame * 2) % (level.height() - camera.h);
+
+				SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
+				SDL_RenderClear(renderer);
+
+				if (culled)
+					level.render(camera, batched ? &batch : nullptr);
+				else if (big)
+					renderTilesLinear(camera, level);
+				else
+					renderTiles(tiles, camera, batched ? &batch : nullptr);
+
+				SDL_RenderPresent(renderer);
 			}
+			double ms = (SDL_GetPerformanceCounter() - start) * 1000.0 / frequency;
+
+			printf("%-24s %-10s %10.3f ms/frame, %6d draw calls/frame\n", names[path],
+				batched ? "batched:" : "unbatched:", ms / frames, LTexture::drawCalls / frames);
+		}
+	}
+}
 
-			/* Move to the next tile spot */
-			x += TILE_WIDTH;
+/* Write binary map header with given dimensions and enough zeroed tiles after it for the file size checks */
+static void writeMapHeader(const char* path, Uint32 columns, Uint32 rows, Uint32 chunkSize, size_t tiles)
+{
+	TileMapHeader header;
+	SDL_zero(header);
+	SDL_memcpy(header.magic, "TMAP", 4);
+	header.version = SDL_SwapLE32(TILE_MAP_VERSION);
+	header.columns = SDL_SwapLE32(columns);
+	header.rows = SDL_SwapLE32(rows);
+	header.chunkSize = SDL_SwapLE32(chunkSize);
+	header.chunkIndexOffset = SDL_SwapLE64(sizeof(header));
+	header.tilesOffset = SDL_SwapLE64(sizeof(header));
+
+	std::ofstream file(path, std::ios::binary);
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	std::vector<char> zeros(tiles, 0);
+	file.write(zeros.data(), zeros.size());
+}
 
-			/* If gone too far */
-			if (x >= LEVEL_WIDTH) {
-				/* Move back */
-				x = 0;
+/* Measure startup cost of text and binary maps, and check that malformed ones are rejected */
+static bool benchmarkLoading()
+{
+	const double frequency = static_cast<double>(SDL_GetPerformanceFrequency());
+
+	/* Generate a big map in both formats */
+	const int BIG_MAP_SIZE = 2048;
+	{
+		TileMap bigMap;
+		createRandomMap(bigMap, BIG_MAP_SIZE);
+		bigMap.saveBinary("bench.tmap", 64);
+
+		std::ofstream text("bench.map");
+		for (int row = 0; row < BIG_MAP_SIZE; ++row) {
+			for (int column = 0; column < BIG_MAP_SIZE; ++column)
+				text << (column ? " " : "") << static_cast<int>(bigMap.getType(column, row));
+			text << "\n";
+		}
+	}
 
-				/* Move to the next row */
-				y += TILE_HEIGHT;
+	/* Level and big map, each loaded from text and then mapped */
+	struct MapFiles {
+		const char* name;
+		const char* text;
+		const char* binary;
+		int columns, rows;
+		int loads;
+	} maps[] = {
+		{ "level", "Images/lazy.map", "Images/lazy.tmap", LEVEL_WIDTH / TILE_WIDTH, LEVEL_HEIGHT / TILE_HEIGHT, 1000 },
+		{ "2048x2048", "bench.map", "bench.tmap", BIG_MAP_SIZE, BIG_MAP_SIZE, 3 }
+	};
+
+	for (const MapFiles& files : maps) {
+		double ms[2];
+		for (int binary = 0; binary < 2; ++binary) {
+			TileMap map;
+			bool loaded = true;
+
+			Uint64 start = SDL_GetPerformanceCounter();
+			for (int i = 0; i < files.loads && loaded; ++i) {
+				loaded = binary ? map.loadFromBinary(files.binary) :
+					map.loadFromText(files.text, files.columns, files.rows);
 			}
+			ms[binary] = (SDL_GetPerformanceCounter() - start) * 1000.0 / frequency / files.loads;
+
+			if (!loaded)
+				ms[binary] = -1.0;
 		}
 
-		if (tilesLoaded) {
-			tileClips[static_cast<int>(Tiles::RED)] = { 0, 0, TILE_WIDTH, TILE_HEIGHT };
+		printf("%-10s map load: %10.3f ms text, %10.3f ms binary\n", files.name, ms[0], ms[1]);
+	}
 
-			tileClips[static_cast<int>(Tiles::GREEN)] = { 0, 80, TILE_WIDTH, TILE_HEIGHT };
+	remove("bench.map");
+	remove("bench.tmap");
+
+	/* Chunk size wrapping the chunk count around to nothing, and a row too wide for int pixels */
+	const Uint32 WIDE_MAP = SDL_MAX_SINT32 / TILE_WIDTH + 1;
+	struct Malformed {
+		const char* name;
+		Uint32 columns, rows, chunkSize;
+	} malformed[] = {
+		{ "huge chunk size", 16, 12, 0xFFFFFFFF },
+		{ "too many columns", WIDE_MAP, 1, 0 }
+	};
+
+	bool passed = true;
+	for (const Malformed& map : malformed) {
+		writeMapHeader("malformed.tmap", map.columns, map.rows, map.chunkSize, static_cast<size_t>(map.columns) * map.rows);
+
+		TileMap loaded;
+		if (loaded.loadFromBinary("malformed.tmap")) {
+			printf("Malformed map with %s was loaded!\n", map.name);
+			passed = false;
+		}
+	}
+	remove("malformed.tmap");
 
-			tileClips[static_cast<int>(Tiles::BLUE)] = { 0, 160, TILE_WIDTH, TILE_HEIGHT };
+	return passed;
+}
 
-			tileClips[static_cast<int>(Tiles::TOPLEFT)] = { 80, 0, TILE_WIDTH, TILE_HEIGHT };
+/* Count pixels of two frames differing by more than blending rounding */
+static int countDifferentPixels(const std::vector<Uint32>& first, const std::vector<Uint32>& second)
+{
+	int different = 0;
+	for (size_t i = 0; i < first.size(); ++i) {
+		for (int shift = 0; shift < 32; shift += 8) {
+			int a = (first[i] >> shift) & 0xFF, b = (second[i] >> shift) & 0xFF;
+			if (SDL_abs(a - b) > 2) {
+				++different;
+				break;
+			}
+		}
+	}
 
-			tileClips[static_cast<int>(Tiles::LEFT)] = { 80, 80, TILE_WIDTH, TILE_HEIGHT };
+	return different;
+}
 
-			tileClips[static_cast<int>(Tiles::BOTTOMLEFT)] = { 80, 160, TILE_WIDTH, TILE_HEIGHT };
+/* Compare prerendered chunks against culled tiles, checking output and edit invalidation */
+static bool benchmarkPrerender(const TileMap& map)
+{
+	const int FRAMES = 500;
+	const int BIG_MAP_SIZE = 4096;
 
-			tileClips[static_cast<int>(Tiles::TOP)] = { 160, 0, TILE_WIDTH, TILE_HEIGHT };
+	const double frequency = static_cast<double>(SDL_GetPerformanceFrequency());
 
-			tileClips[static_cast<int>(Tiles::CENTER)] = { 160, 80, TILE_WIDTH, TILE_HEIGHT };
+	/* Editable copy of the level and a big random map */
+	TileMap level, bigMap;
+	level.create(map.columns(), map.rows());
+	for (int row = 0; row < map.rows(); ++row) {
+		for (int column = 0; column < map.columns(); ++column)
+			level.setType(column, row, map.getType(column, row));
+	}
+	createRandomMap(bigMap, BIG_MAP_SIZE);
+
+	bool passed = true;
+	TileMap* maps[] = { &level, &bigMap };
+	const char* names[] = { "level", "4096x4096" };
+	for (int i = 0; i < 2; ++i) {
+		TileMap& tiles = *maps[i];
+		TileChunkCache prerendered;
+		prerendered.setMap(&tiles);
+
+		/* Same camera sweep as the rendering benchmark, culled tiles then chunk textures */
+		double ms[2];
+		int drawCalls[2];
+		for (int cached = 0; cached < 2; ++cached) {
+			const TileWorld& world = cached ? static_cast<const TileWorld&>(prerendered) : tiles;
+			SDL_Rect camera = { 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT };
+
+			LTexture::drawCalls = 0;
+			Uint64 start = SDL_GetPerformanceCounter();
+			for (int frame = 0; frame < FRAMES; ++frame) {
+				camera.x = (frame * 3) % (tiles.width() - camera.w);
+				camera.y = (frame * 2) % (tiles.height() - camera.h);
+
+				SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
+				SDL_RenderClear(renderer);
+				world.render(camera);
+				SDL_RenderPresent(renderer);
+			}
+			ms[cached] = (SDL_GetPerformanceCounter() - start) * 1000.0 / frequency / FRAMES;
+			drawCalls[cached] = LTexture::drawCalls / FRAMES;
+		}
+
+		/* Both paths have to show the same frame, before and after an edit */
+		SDL_Rect camera = { TILE_WIDTH / 2, TILE_HEIGHT / 2, SCREEN_WIDTH, SCREEN_HEIGHT };
+		std::vector<Uint32> frames[2];
+		int differentPixels = 0, rebaked = -1, hiddenRebaked = -1;
+		for (int edited = 0; edited < 2; ++edited) {
+			if (edited) {
+				int baked = prerendered.bakedChunks();
+
+				/* Visible edit rebakes its chunk only */
+				int type = (static_cast<int>(tiles.getType(1, 1)) + 1) % TOTAL_TILE_SPRITES;
+				prerendered.setType(1, 1, static_cast<Tiles>(type));
+				prerendered.render(camera);
+				rebaked = prerendered.bakedChunks() - baked;
+
+				/* Edit out of sight doesn't rebake anything */
+				baked = prerendered.bakedChunks();
+				prerendered.setType(tiles.columns() - 1, tiles.rows() - 1, Tiles::CENTER);
+				prerendered.render(camera);
+				hiddenRebaked = prerendered.bakedChunks() - baked;
+			}
+
+			for (int cached = 0; cached < 2; ++cached) {
+				SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
+				SDL_RenderClear(renderer);
+				if (cached)
+					prerendered.render(camera);
+				else
+					tiles.render(camera);
+
+				frames[cached].resize(SCREEN_WIDTH * SCREEN_HEIGHT);
+				SDL_RenderReadPixels(renderer, NULL, SDL_PIXELFORMAT_ARGB8888, frames[cached].data(),
+					SCREEN_WIDTH * sizeof(Uint32));
+				SDL_RenderPresent(renderer);
+			}
+			differentPixels += countDifferentPixels(frames[0], frames[1]);
+		}
 
-			tileClips[static_cast<int>(Tiles::BOTTOM)] = { 160, 160, TILE_WIDTH, TILE_HEIGHT };
+		bool valid = differentPixels == 0 && rebaked == 1 && hiddenRebaked == 0;
+		passed &= valid;
 
-			tileClips[static_cast<int>(Tiles::TOPRIGHT)] = { 240, 0, TILE_WIDTH, TILE_HEIGHT };
+		printf("%-10s prerendered: %10.3f ms/frame, %4d draw calls/frame; culled: %10.3f ms/frame, %4d draw calls/frame\n",
+			names[i], ms[1], drawCalls[1], ms[0], drawCalls[0]);
+		printf("%-10s prerendered: %d chunks baked, %d different pixels, edit rebaked %d chunk(s), hidden edit %d: %s\n",
+			names[i], prerendered.bakedChunks(), differentPixels, rebaked, hiddenRebaked, valid ? "passed" : "FAILED");
 
-			tileClips[static_cast<int>(Tiles::RIGHT)] = { 240, 80, TILE_WIDTH, TILE_HEIGHT };
+		/* Textures go before the renderer does */
+		prerendered.free();
+	}
+
+	return passed;
+}
+
+/* Stream a big map along a scripted camera path, checking resident chunks and frame times */
+static bool benchmarkStreaming()
+{
+	const int MAP_SIZE = 4096;
+	const int CHUNK_SIZE = 32;
+	const int FRAMES = 2000;
+	const size_t MEMORY_BUDGET = 24 * CHUNK_SIZE * CHUNK_SIZE;
+	const double FRAME_BUDGET_MS = 1000.0 / 60.0;
+	/* Path teleports back to the top every this many frames */
+	const int ZIGZAG_FRAMES = 500;
+	/* Frames after a teleport the loader may take to catch up */
+	const int CATCH_UP_FRAMES = 4;
+
+	const double frequency = static_cast<double>(SDL_GetPerformanceFrequency());
+
+	/* Generate the map */
+	{
+		TileMap bigMap;
+		createRandomMap(bigMap, MAP_SIZE);
+		bigMap.saveBinary("stream.tmap", CHUNK_SIZE);
+	}
+
+	ChunkManager chunks;
+	if (!chunks.open("stream.tmap", MEMORY_BUDGET, CHUNK_SIZE)) {
+		remove("stream.tmap");
+		return false;
+	}
 
-			tileClips[static_cast<int>(Tiles::BOTTOMRIGHT)] = { 240, 160, TILE_WIDTH, TILE_HEIGHT };
+	/* Start with the first chunks in place, like the demo does */
+	SDL_Rect camera = { 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT };
+	chunks.update(camera);
+	chunks.waitForLoads();
+
+	LSpriteBatch batch;
+	double worstMs = 0.0, totalMs = 0.0;
+	int loadsBefore = chunks.loadedChunks();
+	int holeFrames = 0, lateHoleFrames = 0;
+	for (int frame = 0; frame < FRAMES; ++frame) {
+		/* Cross the map diagonally while zigzagging vertically */
+		camera.x = static_cast<int>(static_cast<Sint64>(chunks.width() - camera.w) * frame / FRAMES);
+		camera.y = static_cast<int>(static_cast<Sint64>(chunks.height() - camera.h) * (frame % ZIGZAG_FRAMES) / ZIGZAG_FRAMES);
+
+		Uint64 start = SDL_GetPerformanceCounter();
+
+		chunks.update(camera);
+
+		/* Moving along the path prefetch has to keep up, only right after a teleport may parts be missing */
+		if (chunks.missingChunks(camera) > 0) {
+			++holeFrames;
+			if (frame % ZIGZAG_FRAMES >= CATCH_UP_FRAMES)
+				++lateHoleFrames;
 		}
+
+		SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
+		SDL_RenderClear(renderer);
+		chunks.render(camera, &batch);
+		SDL_RenderPresent(renderer);
+
+		double ms = (SDL_GetPerformanceCounter() - start) * 1000.0 / frequency;
+		worstMs = SDL_max(worstMs, ms);
+		totalMs += ms;
+
+		/* Leave loader some of the idle time waiting for VSync would, without taking a whole frame */
+		SDL_Delay(1);
 	}
 
-	/* Close the file */
-	map.close();
+	int loads = chunks.loadedChunks() - loadsBefore;
+	bool passed = (chunks.peakResidentChunks() <= chunks.maxResidentChunks()) && (worstMs < FRAME_BUDGET_MS) &&
+		(loads > 0) && (lateHoleFrames == 0);
+	printf("streaming %dx%d tiles: peak %d of %d resident chunks, %d loads, worst frame %.3f ms, average %.3f ms\n",
+		MAP_SIZE, MAP_SIZE, chunks.peakResidentChunks(), chunks.maxResidentChunks(), loads, worstMs, totalMs / FRAMES);
+	printf("streaming %dx%d tiles: %d frames with missing chunks, %d of them later than %d frames after a teleport: %s\n",
+		MAP_SIZE, MAP_SIZE, holeFrames, lateHoleFrames, CATCH_UP_FRAMES, passed ? "passed" : "FAILED");
+
+	chunks.close();
+	remove("stream.tmap");
+	return passed;
+}
+
+bool runBenchmark(const TileMap& map)
+{
+	/* Tile set of the level for the reference paths */
+	Tile* tiles[TOTAL_TILES];
+	for (int i = 0; i < TOTAL_TILES; ++i) {
+		int column = i % map.columns(), row = i / map.columns();
+		tiles[i] = new Tile(column * TILE_WIDTH, row * TILE_HEIGHT, map.getType(column, row));
+	}
+
+	bool passed = true;
+	passed &= benchmarkLoading();
+	passed &= benchmarkCollision(tiles, map);
+	benchmarkRendering(tiles, map);
+	passed &= benchmarkPrerender(map);
+	passed &= benchmarkStreaming();
+
+	for (int i = 0; i < TOTAL_TILES; ++i)
+		delete tiles[i];
 
-	return tilesLoaded;
+	return passed;
 }
\ No newline at end of file
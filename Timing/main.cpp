@@ -3,6 +3,7 @@
 #include "SDL2/SDL_ttf.h"
 
 #include "LTexture.h"
+#include "LGlyphAtlas.h"
 
 #include <stdio.h>
 #include <string>
@@ -30,7 +31,8 @@ TTF_Font* font = nullptr;
 
 /* Prompt texture */
 LTexture promptTexture;
-LTexture timeTextTexture;
+/* Glyphs time text is drawn from */
+LGlyphAtlas timeTextAtlas;
 
 int main(int argc, char* args[])
 {
@@ -74,18 +76,14 @@ int main(int argc, char* args[])
 		timeText.str("");
 		timeText << "Miliseconds since start time " << SDL_GetTicks() - startTime;
 
-		/* Render text */
-		if (!timeTextTexture.loadFromRenderedText(timeText.str(), textColor))
-			printf("Unable to render time texture!\n");
-
 		/* Clear screen */
 		SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
 		SDL_RenderClear(renderer);
 		
 		/* Render textures */
 		promptTexture.render((SCREEN_WIDTH - promptTexture.width()) / 2, 0);
-		timeTextTexture.render((SCREEN_WIDTH - promptTexture.width()) / 2,
-			(SCREEN_HEIGHT - promptTexture.height()) / 2);
+		timeTextAtlas.render((SCREEN_WIDTH - promptTexture.width()) / 2,
+			(SCREEN_HEIGHT - promptTexture.height()) / 2, timeText.str(), textColor);
 
 		/* Update screen */
 		SDL_RenderPresent(renderer);
@@ -164,6 +162,12 @@ bool loadMedia()
 			printf("Unable to render prompt texture!\n");
 			success = false;
 		}
+
+		/* Create atlas for time text */
+		if (!timeTextAtlas.create(font)) {
+			printf("Unable to create glyph atlas!\n");
+			success = false;
+		}
 	}
 
 	return success;
@@ -173,7 +177,7 @@ void close()
 {
 	/* Free textures */
 	promptTexture.free();
-	timeTextTexture.free();
+	timeTextAtlas.free();
 
 	/* Close the font */
 	TTF_CloseFont(font);
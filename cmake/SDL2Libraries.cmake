@@ -0,0 +1,29 @@
+# Finds SDL2 and its satellite libraries through their own CMake packages, falling back to pkg-config
+# for distributions that only ship .pc files. Every library ends up as the target its CMake package names.
+
+find_package(PkgConfig QUIET)
+
+# sdl2_find_library(<package> <target> <pkg-config module> [REQUIRED])
+function(sdl2_find_library package target module)
+	if (TARGET ${target})
+		return()
+	endif()
+
+	find_package(${package} CONFIG QUIET)
+
+	if (NOT TARGET ${target} AND PkgConfig_FOUND)
+		pkg_check_modules(${package}_PC QUIET IMPORTED_TARGET GLOBAL ${module})
+		if (${package}_PC_FOUND)
+			add_library(${target} INTERFACE IMPORTED GLOBAL)
+			target_link_libraries(${target} INTERFACE PkgConfig::${package}_PC)
+		endif()
+	endif()
+
+	if (TARGET ${target})
+		message(STATUS "Found ${package}")
+	elseif ("REQUIRED" IN_LIST ARGN)
+		message(FATAL_ERROR "${package} not found, install its development package or point CMAKE_PREFIX_PATH at it")
+	else()
+		message(STATUS "${package} not found, programs using it are skipped")
+	endif()
+endfunction()